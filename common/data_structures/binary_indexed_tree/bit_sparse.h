@@ -5,11 +5,12 @@
 #include <unordered_map>
 
 namespace ds {
-template <class TValue = int64_t>
+template <class TValue = int64_t,
+          template <class, class> class TTHashMap = std::unordered_map>
 class BITSparse {
  protected:
   uint64_t size;
-  std::unordered_map<uint64_t, TValue> values;
+  TTHashMap<uint64_t, TValue> values;
 
  public:
   explicit BITSparse(uint64_t _size) : size(_size) {}
@@ -9,11 +9,17 @@
 #include <vector>
 
 namespace ds {
-template <class TValue>
+namespace hidden {
+template <class TKey, class TValue>
+using UnorderedMapDHash = std::unordered_map<TKey, TValue, DHash<TKey>>;
+}  // namespace hidden
+
+template <class TValue, template <class, class> class TTHashMap =
+                            hidden::UnorderedMapDHash>
 class CoordinateCompression {
  protected:
   std::vector<TValue> new_to_old;
-  std::unordered_map<TValue, size_t, DHash<TValue>> old_to_new;
+  TTHashMap<TValue, size_t> old_to_new;
 
  public:
   CoordinateCompression() {}
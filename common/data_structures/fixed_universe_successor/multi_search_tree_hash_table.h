@@ -21,7 +21,8 @@ namespace fus {
 // Max         -- O(1)
 // Successor   -- O(log log U)
 // Predecessor -- O(log log U)
-template <class TFLS>
+template <class TFLS,
+          template <class, class> class TTHashMap = std::unordered_map>
 class MultiSearchTreeHashTable {
  protected:
   static constexpr unsigned bits_per_level = TFLS::nbits;
@@ -47,7 +48,7 @@ class MultiSearchTreeHashTable {
  protected:
   memory::NodesManager<Node> nodes_manager;
   Node root;
-  std::unordered_map<size_t, Node *> hash_table;
+  TTHashMap<size_t, Node *> hash_table;
   size_t usize;
   size_t maxh = 0;
   std::vector<Node *> path;
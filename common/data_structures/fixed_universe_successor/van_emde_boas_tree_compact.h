@@ -21,9 +21,10 @@ namespace fus {
 // Max         -- O(1)
 // Successor   -- O(log log U)
 // Predecessor -- O(log log U)
-class VanEmdeBoasTreeCompact {
+template <template <class, class> class TTHashMap = std::unordered_map>
+class VanEmdeBoasTreeCompactHashMap {
  public:
-  using TSelf = VanEmdeBoasTreeCompact;
+  using TSelf = VanEmdeBoasTreeCompactHashMap;
   using PSelf = std::shared_ptr<TSelf>;
 
  protected:
@@ -32,7 +33,7 @@ class VanEmdeBoasTreeCompact {
 
   FLSetB6 leaf;
   PSelf aux_tree;
-  std::unordered_map<size_t, PSelf> children;
+  TTHashMap<size_t, PSelf> children;
 
   size_t min_value, max_value;
 
@@ -44,9 +45,9 @@ class VanEmdeBoasTreeCompact {
   }
 
  public:
-  VanEmdeBoasTreeCompact() {}
+  VanEmdeBoasTreeCompactHashMap() {}
 
-  VanEmdeBoasTreeCompact(unsigned _m, size_t x) { InitL(_m, x); }
+  VanEmdeBoasTreeCompactHashMap(unsigned _m, size_t x) { InitL(_m, x); }
 
  protected:
   void InitL(unsigned _m, size_t x) {
@@ -168,5 +169,8 @@ class VanEmdeBoasTreeCompact {
     return (x1 << mh) + it1->second->Max();
   }
 };
+
+using VanEmdeBoasTreeCompact =
+    VanEmdeBoasTreeCompactHashMap<std::unordered_map>;
 }  // namespace fus
 }  // namespace ds
@@ -22,7 +22,8 @@ namespace fus {
 // Max         -- O(1)
 // Successor   -- O(log log U)
 // Predecessor -- O(log log U)
-template <class TFLS>
+template <class TFLS,
+          template <class, class> class TTHashMap = std::unordered_map>
 class VanEmdeBoasTreeCompact2 {
  protected:
   static constexpr unsigned bits_per_level = TFLS::nbits;
@@ -83,7 +84,7 @@ class VanEmdeBoasTreeCompact2 {
  protected:
   memory::NodesManager<Node> nodes_manager;
   Node root;
-  std::unordered_map<uint64_t, Node*> nodes;
+  TTHashMap<uint64_t, Node*> nodes;
   unsigned maxh;
   size_t usize;
 
@@ -21,7 +21,8 @@ namespace fus {
 // Max         -- O(1)
 // Successor   -- O(log log U)
 // Predecessor -- O(log log U)
-class XFastTrie {
+template <template <class, class> class TTHashMap = std::unordered_map>
+class XFastTrieHashMap {
  protected:
   class Node : public memory::Node {
    public:
@@ -34,14 +35,14 @@ class XFastTrie {
  protected:
   Node empty_node;
   TNodeManager node_manager;
-  std::vector<std::unordered_map<uint64_t, Node *>> vm;
+  std::vector<TTHashMap<uint64_t, Node *>> vm;
   size_t size, usize;
   unsigned maxh;
 
  public:
-  XFastTrie() { Clear(); }
+  XFastTrieHashMap() { Clear(); }
 
-  XFastTrie(size_t u) { Init(u); }
+  XFastTrieHashMap(size_t u) { Init(u); }
 
   void Clear() {
     size = 0;
@@ -229,5 +230,7 @@ class XFastTrie {
   size_t Successor(size_t x) const { return SuccessorI(x)->value; }
   size_t Predecessor(size_t x) const { return PredecessorI(x)->value; }
 };
+
+using XFastTrie = XFastTrieHashMap<std::unordered_map>;
 }  // namespace fus
 }  // namespace ds
@@ -4,10 +4,15 @@
 #include <vector>
 
 namespace factorization {
-struct PrimePower {
-  uint64_t prime;
+template <class TValue>
+struct PrimePowerT {
+  TValue prime;
   unsigned power;
 };
+
+using PrimePower = PrimePowerT<uint64_t>;
 }  // namespace factorization
 
 using TFactorization = std::vector<factorization::PrimePower>;
+using TFactorization128 =
+    std::vector<factorization::PrimePowerT<__uint128_t>>;
@@ -2,87 +2,235 @@
 
 #include "common/factorization/base.h"
 #include "common/factorization/primality_test.h"
-#include "common/modular/proxy/proxy.h"
+#include "common/factorization/primes_list.h"
+#include "common/modular/proxy/montgomery.h"
 #include "common/numeric/utils/gcd.h"
+#include "common/thread_pool.h"
 
 #include <algorithm>
+#include <bit>
+#include <cmath>
+#include <span>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace factorization {
-// Based on Pollard's rho algorithm (
-// https://en.wikipedia.org/wiki/Pollard%27s_rho_algorithm ).
+// Trial division by small primes, then Pollard's rho algorithm (
+// https://en.wikipedia.org/wiki/Pollard%27s_rho_algorithm ) with Brent's
+// cycle detection. Iterations are done in Montgomery form and products of
+// rho_block differences are accumulated before each GCD.
 class Factorization {
  protected:
-  static constexpr uint64_t u32threshold = (1u << 31);
+  static constexpr unsigned small_primes_limit = 256;
+  static constexpr uint64_t rho_block = 128;
+
+  // n is divisible by odd p iff n * p^-1 mod 2^64 <= (2^64 - 1) / p.
+  class SmallPrime {
+   public:
+    uint64_t p;
+    uint64_t inverse;
+    uint64_t limit;
+  };
 
  protected:
   PrimalityTest primality_test;
+  std::vector<SmallPrime> small_primes;
 
  protected:
-  uint64_t FindFactor32(uint64_t n, uint64_t start) {
-    modular::proxy::Proxy<false, true> proxy(n);
-    auto next = [&](uint64_t k) { return proxy.Add(proxy.Mult(k, k), 1); };
-    uint64_t x = start, y = start, d = 1;
-    for (; d == 1;) {
-      x = next(x);
-      y = next(next(y));
-      d = GCD(proxy.Sub(x, y), n);
+  bool IsPrime(uint64_t n) const { return primality_test.IsPrime(n); }
+
+  static unsigned CountrZero(__uint128_t n) {
+    return uint64_t(n) ? unsigned(std::countr_zero(uint64_t(n)))
+                       : 64 + unsigned(std::countr_zero(uint64_t(n >> 64)));
+  }
+
+  static bool IsSquare(__uint128_t n) {
+    const double x = std::sqrt(double(n));
+    __uint128_t r = (x >= 18446744073709551615.0) ? ~0ull : uint64_t(x);
+    for (unsigned i = 0; (i < 2) && (r > 0); ++i) r = (r + n / r) / 2;
+    for (; (r >> 64) || (r * r > n);) --r;
+    return r * r == n;
+  }
+
+  // Jacobi symbol (a / n), n is odd.
+  static int Jacobi(__uint128_t a, __uint128_t n) {
+    int j = 1;
+    for (a %= n; a; a %= n) {
+      for (; !(a & 1); a >>= 1) {
+        if (((n & 7) == 3) || ((n & 7) == 5)) j = -j;
+      }
+      std::swap(a, n);
+      if (((a & 3) == 3) && ((n & 3) == 3)) j = -j;
     }
-    return d;
+    return (n == 1) ? j : 0;
   }
 
-  uint64_t FindFactor64(uint64_t n, uint64_t start) {
-    modular::proxy::Proxy<false, false> proxy(n);
-    auto next = [&](uint64_t k) { return proxy.Add(proxy.Mult(k, k), 1); };
-    uint64_t x = start, y = start, d = 1;
-    for (; d == 1;) {
-      x = next(x);
-      y = next(next(y));
-      d = GCD(proxy.Sub(x, y), n);
+  // Strong Lucas probable prime test with Selfridge parameters (P = 1,
+  // Q = (1 - D) / 4, first D in 5, -7, 9, ... with (D / n) = -1).
+  // https://en.wikipedia.org/wiki/Lucas_pseudoprime
+  // n is odd and n >= 2^64.
+  static bool IsStrongLucasProbablePrime(__uint128_t n) {
+    if (IsSquare(n)) return false;
+    int64_t d = 5;
+    for (;; d = (d > 0) ? -(d + 2) : -d + 2) {
+      const uint64_t ad = uint64_t(d > 0 ? d : -d);
+      const int j = Jacobi(d > 0 ? ad : n - ad, n);
+      if (j == -1) break;
+      if (j == 0) return false;  // gcd(|D|, n) > 1 and |D| < n
     }
-    return d;
+    const modular::proxy::Montgomery<__uint128_t> mg(n);
+    auto to_signed = [&](int64_t x) {
+      return (x >= 0) ? mg.To(uint64_t(x)) : mg.Sub(0, mg.To(uint64_t(-x)));
+    };
+    auto half = [&](__uint128_t x) {
+      return (x & 1) ? (x >> 1) + (n >> 1) + 1 : x >> 1;
+    };
+    const __uint128_t md = to_signed(d), mq = to_signed((1 - d) / 4);
+    const unsigned s = CountrZero(n + 1);
+    const __uint128_t k = (n + 1) >> s;
+    // u = U_i, v = V_i, qi = Q^i for i = prefix of k.
+    __uint128_t u = mg.One(), v = mg.One(), qi = mq;
+    const int bits = (k >> 64) ? 128 - std::countl_zero(uint64_t(k >> 64))
+                               : 64 - std::countl_zero(uint64_t(k));
+    for (int b = bits - 2; b >= 0; --b) {
+      u = mg.Mult(u, v);
+      v = mg.Sub(mg.Sqr(v), mg.Add(qi, qi));
+      qi = mg.Sqr(qi);
+      if ((k >> b) & 1) {
+        const __uint128_t u1 = half(mg.Add(u, v));
+        v = half(mg.Add(mg.Mult(md, u), v));
+        u = u1;
+        qi = mg.Mult(qi, mq);
+      }
+    }
+    if ((u == 0) || (v == 0)) return true;
+    for (unsigned r = 1; r < s; ++r) {
+      v = mg.Sub(mg.Sqr(v), mg.Add(qi, qi));
+      if (v == 0) return true;
+      qi = mg.Sqr(qi);
+    }
+    return false;
   }
 
-  uint64_t FindFactor(uint64_t n) {
-    uint64_t d = n;
-    for (uint64_t start = 2; d == n; ++start)
-      d = (n < u32threshold) ? FindFactor32(n, start) : FindFactor64(n, start);
-    return d;
+  // Strong probable prime test for first 20 primes as bases, deterministic
+  // for n < 3.3 * 10^24. Above this bound strong Lucas test is added
+  // (Baillie-PSW), no composite passing it is known but it is not proven.
+  // n is odd and n >= 2^64.
+  static bool IsPrime(__uint128_t n) {
+    static constexpr unsigned witnesses[] = {2,  3,  5,  7,  11, 13, 17,
+                                             19, 23, 29, 31, 37, 41, 43,
+                                             47, 53, 59, 61, 67, 71};
+    // First strong pseudoprime to bases 2..41.
+    static constexpr __uint128_t deterministic_limit =
+        __uint128_t(3317044064679887ull) * 1000000000 + 385961981;
+    const modular::proxy::Montgomery<__uint128_t> mg(n);
+    const unsigned s = CountrZero(n - 1);
+    const __uint128_t d = (n - 1) >> s, one = mg.One(),
+                      minus_one = mg.Sub(0, one);
+    for (unsigned witness : witnesses) {
+      __uint128_t x = mg.PowU(mg.To(witness), d);
+      if ((x == one) || (x == minus_one)) continue;
+      unsigned i = 1;
+      for (; i < s; ++i) {
+        x = mg.Sqr(x);
+        if (x == minus_one) break;
+      }
+      if (i >= s) return false;
+    }
+    return (n < deterministic_limit) || IsStrongLucasProbablePrime(n);
+  }
+
+  // Removes prime factors below small_primes_limit from n.
+  void TrialDivision(uint64_t& n, std::vector<uint64_t>& output) const {
+    const unsigned twos = unsigned(std::countr_zero(n));
+    output.insert(output.end(), twos, 2);
+    n >>= twos;
+    for (auto& sp : small_primes) {
+      for (; n * sp.inverse <= sp.limit; n *= sp.inverse)
+        output.push_back(sp.p);
+    }
+  }
+
+  void TrialDivision(__uint128_t& n, std::vector<__uint128_t>& output) const {
+    const unsigned twos = CountrZero(n);
+    output.insert(output.end(), twos, 2);
+    n >>= twos;
+    for (auto& sp : small_primes) {
+      for (; (n % sp.p) == 0; n /= sp.p) output.push_back(sp.p);
+    }
   }
 
-  std::vector<uint64_t> FactorizeI(uint64_t n) {
-    if (n == 1) return {};
-    std::vector<uint64_t> v;
-    for (; !primality_test.IsPrime(n);) {
-      const uint64_t d = FindFactor(n);
-      n /= d;
-      if (primality_test.IsPrime(d)) {
-        v.push_back(d);
-      } else {
-        auto vd = FactorizeI(d);
-        v.insert(v.end(), vd.begin(), vd.end());
+  // Brent's cycle detection for x -> x^2 + c in Montgomery form. Returns
+  // divisor of n, n if failed.
+  template <class TValue>
+  static TValue FindFactor(const modular::proxy::Montgomery<TValue>& mg,
+                           TValue c) {
+    const TValue n = mg.GetMod();
+    auto next = [&](TValue x) { return mg.Add(mg.Sqr(x), c); };
+    TValue x = 0, y = 0, ys = 0, q = mg.One(), d = 1;
+    for (uint64_t r = 1; d == 1; r <<= 1) {
+      x = y;
+      for (uint64_t i = 0; i < r; ++i) y = next(y);
+      for (uint64_t k = 0; (k < r) && (d == 1); k += rho_block) {
+        ys = y;
+        const uint64_t l = std::min(rho_block, r - k);
+        for (uint64_t i = 0; i < l; ++i) {
+          y = next(y);
+          q = mg.Mult(q, mg.Sub(x, y));
+        }
+        d = GCD(q, n);
       }
     }
-    if (n > 1) v.push_back(n);
-    return v;
+    if (d == n) {
+      // Product contains all factors, repeat last block one step at a time.
+      do {
+        ys = next(ys);
+        d = GCD(mg.Sub(x, ys), n);
+      } while (d == 1);
+    }
+    return d;
   }
 
-  std::vector<uint64_t> FactorizeISafe(uint64_t n) {
-    std::vector<uint64_t> v;
-    for (uint64_t p : {2, 3, 5}) {
-      for (; (n % p) == 0; n /= p) v.push_back(p);
+  template <class TValue>
+  static TValue FindFactor(TValue n) {
+    const modular::proxy::Montgomery<TValue> mg(n);
+    for (TValue c = mg.One();; c = mg.Add(c, mg.One())) {
+      const TValue d = FindFactor(mg, c);
+      if (d != n) return d;
     }
-    const auto vv = FactorizeI(n);
-    v.insert(v.end(), vv.begin(), vv.end());
-    return v;
   }
 
- public:
-  TFactorization Factorize(uint64_t n) {
-    std::vector<uint64_t> v = FactorizeISafe(n);
+  // n has no prime factors below small_primes_limit.
+  template <class TValue>
+  void FactorizeRho(TValue n, std::vector<TValue>& output) {
+    if constexpr (std::is_same_v<TValue, __uint128_t>) {
+      if ((n >> 64) == 0) {
+        std::vector<uint64_t> v;
+        FactorizeRho(uint64_t(n), v);
+        output.insert(output.end(), v.begin(), v.end());
+        return;
+      }
+    }
+    if (n == 1) return;
+    if ((n < small_primes_limit * small_primes_limit) || IsPrime(n)) {
+      output.push_back(n);
+      return;
+    }
+    const TValue d = FindFactor(n);
+    FactorizeRho(d, output);
+    FactorizeRho(n / d, output);
+  }
+
+  template <class TValue>
+  std::vector<PrimePowerT<TValue>> FactorizeT(TValue n) {
+    assert(n > 0);
+    std::vector<TValue> v;
+    TrialDivision(n, v);
+    FactorizeRho(n, v);
     std::sort(v.begin(), v.end());
-    TFactorization f;
-    for (uint64_t p : v) {
+    std::vector<PrimePowerT<TValue>> f;
+    for (TValue p : v) {
       if ((f.size() == 0) || (f.back().prime != p))
         f.push_back({p, 1});
       else
@@ -90,6 +238,23 @@ class Factorization {
     }
     return f;
   }
+
+ public:
+  Factorization() {
+    const PrimesList primes_list(small_primes_limit);
+    for (uint64_t p : primes_list.GetPrimes()) {
+      if (p == 2) continue;
+      uint64_t inverse = p;
+      for (unsigned i = 0; i < 6; ++i) inverse *= 2 - p * inverse;
+      small_primes.push_back({p, inverse, ~0ull / p});
+    }
+  }
+
+  TFactorization Factorize(uint64_t n) { return FactorizeT(n); }
+
+  // Factors above 3.3 * 10^24 are checked with Baillie-PSW test, which has
+  // no known counterexamples but is not proven.
+  TFactorization128 Factorize128(__uint128_t n) { return FactorizeT(n); }
 };
 }  // namespace factorization
 
@@ -97,3 +262,25 @@ inline TFactorization Factorize(uint64_t n) {
   thread_local factorization::Factorization f;
   return f.Factorize(n);
 }
+
+inline TFactorization128 Factorize128(__uint128_t n) {
+  thread_local factorization::Factorization f;
+  return f.Factorize128(n);
+}
+
+// Calling thread takes part in the work with pool workers.
+inline std::vector<TFactorization> FactorizeMany(std::span<const uint64_t> vn,
+                                                 ThreadPool& pool) {
+  std::vector<TFactorization> output(vn.size());
+  pool.ParallelFor(
+      0, vn.size(), [&](size_t i) { output[i] = Factorize(vn[i]); }, 64);
+  return output;
+}
+
+inline std::vector<TFactorization> FactorizeMany(
+    std::span<const uint64_t> vn, unsigned threads = 1) {
+  if (threads > 1) return FactorizeMany(vn, ThreadPool::Shared(threads - 1));
+  std::vector<TFactorization> output(vn.size());
+  for (size_t i = 0; i < vn.size(); ++i) output[i] = Factorize(vn[i]);
+  return output;
+}
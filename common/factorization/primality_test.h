@@ -2,115 +2,176 @@
 
 #include "common/base.h"
 #include "common/factorization/primes_list.h"
-#include "common/modular/arithmetic.h"
+#include "common/modular/proxy/montgomery.h"
 
+#include <algorithm>
+#include <bit>
+#include <span>
 #include <vector>
 
 namespace factorization {
-// Miller Rabin Primality Test
+// Deterministic Miller Rabin Primality Test in Montgomery form.
+// https://en.wikipedia.org/wiki/Miller%E2%80%93Rabin_primality_test
+// Bases {2, 7, 61} are sufficient for n < 2^32 and 7 bases of Jim Sinclair
+// are sufficient for n < 2^64. Base 2 is checked first, exponentiations for
+// other bases are interleaved. Numbers below small_size are checked with
+// bitmap of primes, other numbers are filtered by wheel of primes up to
+// maxprime.
 class PrimalityTest {
  protected:
-  using TModularA = modular::Arithmetic<false, false, uint64_t>;
+  using TMontgomery = modular::proxy::Montgomery<uint64_t>;
 
-  enum Primality {
-    COMPOSITE,
-    PROBABLY_PRIME,
-  };
+  static constexpr uint64_t small_size = (1u << 16);
+  static constexpr unsigned batch_size = 4;
+  static constexpr uint64_t bases32[] = {7, 61};
+  static constexpr uint64_t bases64[] = {325,    9375,    28178,
+                                         450775, 9780504, 1795265022};
 
-  // n - 1 == d * 2^s
-  class P2Factorization {
-   public:
-    uint64_t n;
-    uint64_t s;
-    uint64_t d;
-  };
+ protected:
+  uint64_t wheel_size;
+  // Bit i is set if i is prime (small) or coprime with wheel_size (wheel).
+  std::vector<uint64_t> small_bitmap, wheel_bitmap;
 
  protected:
-  static P2Factorization Factor(uint64_t n) {
-    P2Factorization f;
-    f.n = n;
-    f.d = n - 1;
-    f.s = 0;
-    for (; ((~f.d) & 1); f.d >>= 1) ++f.s;
-    return f;
+  static bool GetBit(const std::vector<uint64_t>& bitmap, uint64_t i) {
+    return (bitmap[i >> 6] >> (i & 63)) & 1;
   }
 
-  static const std::vector<uint64_t>& SelectWitnesses(uint64_t n) {
-    // Note: http://en.wikipedia.org/wiki/Miller%E2%80%93Rabin_primality_test
-    // lists minimal sets of witnesses that are sufficient for deterministic
-    // testing of primes for certain ranges of inputs. We've selected only
-    // a few of those ranges; it may be worthwhile to add more ranges here.
-    static const std::vector<uint64_t> w2k = {2};
-    static const std::vector<uint64_t> w25M = {2, 3, 5};
-    static const std::vector<uint64_t> w3T = {2, 3, 5, 7, 11, 13};
-    static const std::vector<uint64_t> w341T = {2, 3, 5, 7, 11, 13, 17};
-    static const std::vector<uint64_t> w3_1016 = {2,  3,  5,  7, 11,
-                                                  13, 17, 19, 23};
-    static const std::vector<uint64_t> wmax = {2,  3,  5,  7,  11, 13,
-                                               17, 19, 23, 29, 31, 37};
-
-    if (n < 2047ull) {
-      return w2k;
-    } else if (n < 25326001ull) {
-      return w25M;
-    } else if (n < 3474749660383ull) {
-      return w3T;
-    } else if (n < 341550071728321ull) {
-      return w341T;
-    } else if (n < 3825123056546413051ull) {
-      return w3_1016;
-    } else {
-      return wmax;
+  // Result of x -> x^2 iterations for x = base^d, n - 1 = d * 2^s.
+  static bool CheckSquares(const TMontgomery& mg, uint64_t x, unsigned s) {
+    const uint64_t one = mg.One(), minus_one = mg.GetMod() - one;
+    if ((x == one) || (x == minus_one)) return true;
+    for (unsigned i = 1; i < s; ++i) {
+      x = mg.Sqr(x);
+      if (x == minus_one) return true;
     }
+    return false;
   }
 
-  static Primality CheckMillerRabinWitness(const P2Factorization& f,
-                                           uint64_t witness) {
-    uint64_t x = TModularA::PowU(witness, f.d, f.n);
-    if ((x == 1) || (x == (f.n - 1))) return PROBABLY_PRIME;
-    for (uint64_t i = 0; i < f.s - 1; ++i) {
-      x = TModularA::Mult(x, x, f.n);
-      if (x == 1) return COMPOSITE;
-      if (x == f.n - 1) return PROBABLY_PRIME;
+  // Strong probable prime test for k bases, exponentiations are done
+  // together to hide multiplication latency.
+  template <unsigned k>
+  static bool StrongProbablePrime(const TMontgomery& mg,
+                                  const uint64_t* bases) {
+    const uint64_t n = mg.GetMod();
+    const unsigned s = unsigned(std::countr_zero(n - 1));
+    const uint64_t d = (n - 1) >> s;
+    uint64_t a[k], x[k];
+    for (unsigned i = 0; i < k; ++i) x[i] = a[i] = mg.To(bases[i]);
+    for (unsigned bit = 63 - unsigned(std::countl_zero(d)); bit-- > 0;) {
+      const bool b = (d >> bit) & 1;
+      for (unsigned i = 0; i < k; ++i) {
+        const uint64_t y = mg.Sqr(x[i]), z = mg.Mult(y, a[i]);
+        x[i] = b ? z : y;
+      }
     }
-    return COMPOSITE;
+    bool result = true;
+    for (unsigned i = 0; i < k; ++i)
+      result &= ((a[i] == 0) || CheckSquares(mg, x[i], s));
+    return result;
   }
 
-  static Primality RunMillerRabinTest(uint64_t n) {
-    if ((~n) & 1) return COMPOSITE;
-    P2Factorization f = Factor(n);
-    const std::vector<uint64_t>& witnesses = SelectWitnesses(n);
-    for (auto witness : witnesses) {
-      if (CheckMillerRabinWitness(f, witness) == COMPOSITE) return COMPOSITE;
+  // Base 2 strong probable prime test for k odd numbers, multiplication by
+  // base is addition.
+  template <unsigned k>
+  static void StrongProbablePrime2(const uint64_t* n, bool* output) {
+    TMontgomery mg[k];
+    uint64_t d[k], x[k];
+    unsigned s[k], bits = 0;
+    for (unsigned i = 0; i < k; ++i) {
+      mg[i] = TMontgomery(n[i]);
+      s[i] = unsigned(std::countr_zero(n[i] - 1));
+      d[i] = (n[i] - 1) >> s[i];
+      x[i] = mg[i].One();
+      bits = std::max(bits, 64 - unsigned(std::countl_zero(d[i])));
+    }
+    for (unsigned bit = bits; bit-- > 0;) {
+      for (unsigned i = 0; i < k; ++i) {
+        const uint64_t y = mg[i].Sqr(x[i]), z = mg[i].Add(y, y);
+        x[i] = ((d[i] >> bit) & 1) ? z : y;
+      }
     }
-    return PROBABLY_PRIME;
+    for (unsigned i = 0; i < k; ++i)
+      output[i] = CheckSquares(mg[i], x[i], s[i]);
   }
 
- protected:
-  uint64_t N, M;
-  std::vector<uint8_t> primes;
-  std::vector<uint8_t> table;
+  // n is odd, n >= small_size, n passed base 2 test.
+  static bool StrongProbablePrimeOtherBases(uint64_t n) {
+    const TMontgomery mg(n);
+    return (n >> 32) ? StrongProbablePrime<6>(mg, bases64)
+                     : StrongProbablePrime<2>(mg, bases32);
+  }
+
+  // 0 - composite, 1 - prime, 2 - unknown.
+  unsigned Filter(uint64_t n) const {
+    if (n < small_size) return GetBit(small_bitmap, n) ? 1 : 0;
+    return GetBit(wheel_bitmap, n % wheel_size) ? 2 : 0;
+  }
 
  public:
   explicit PrimalityTest(unsigned maxprime = 13) {
-    N = maxprime, M = 1;
-    PrimesList primes_list(maxprime);
-    const std::vector<uint64_t>& pl_primes = primes_list.GetPrimes();
-    primes.resize(maxprime + 1, 0);
-    for (uint64_t p : pl_primes) {
-      M *= p;
-      primes[p] = 1;
+    assert(maxprime >= 2);
+    const PrimesList primes_list(std::max<uint64_t>(maxprime, small_size));
+    wheel_size = 1;
+    for (uint64_t p : primes_list.GetPrimes()) {
+      if (p > maxprime) break;
+      wheel_size *= p;
+    }
+    small_bitmap.resize(small_size / 64, 0);
+    for (uint64_t p : primes_list.GetPrimes()) {
+      if (p >= small_size) break;
+      small_bitmap[p >> 6] |= (1ull << (p & 63));
     }
-    table.resize(M, 1);
-    for (uint64_t p : pl_primes) {
-      for (uint64_t j = 0; j < M; j += p) table[j] = 0;
+    wheel_bitmap.resize((wheel_size + 63) / 64, ~0ull);
+    for (uint64_t p : primes_list.GetPrimes()) {
+      if (p > maxprime) break;
+      for (uint64_t j = 0; j < wheel_size; j += p)
+        wheel_bitmap[j >> 6] &= ~(1ull << (j & 63));
     }
   }
 
   bool IsPrime(uint64_t n) const {
-    if (n <= N) return (primes[n] != 0);
-    if (!table[n % M]) return false;
-    return (RunMillerRabinTest(n) == PROBABLY_PRIME);
+    const unsigned f = Filter(n);
+    if (f != 2) return (f == 1);
+    bool result;
+    StrongProbablePrime2<1>(&n, &result);
+    return result && StrongProbablePrimeOtherBases(n);
+  }
+
+  // Same as IsPrime for each value, base 2 tests for different values are
+  // interleaved.
+  std::vector<bool> IsPrimeBatch(std::span<const uint64_t> values) const {
+    std::vector<bool> output(values.size());
+    uint64_t pending_n[batch_size];
+    size_t pending_index[batch_size];
+    bool result[batch_size];
+    unsigned pending = 0;
+    auto Flush = [&](unsigned count) {
+      StrongProbablePrime2<batch_size>(pending_n, result);
+      for (unsigned i = 0; i < count; ++i) {
+        output[pending_index[i]] =
+            result[i] && StrongProbablePrimeOtherBases(pending_n[i]);
+      }
+    };
+    for (size_t i = 0; i < values.size(); ++i) {
+      const unsigned f = Filter(values[i]);
+      if (f != 2) {
+        output[i] = (f == 1);
+        continue;
+      }
+      pending_n[pending] = values[i];
+      pending_index[pending++] = i;
+      if (pending == batch_size) {
+        Flush(batch_size);
+        pending = 0;
+      }
+    }
+    if (pending) {
+      // Unused lanes are filled with valid odd modulus.
+      for (unsigned i = pending; i < batch_size; ++i) pending_n[i] = 3;
+      Flush(pending);
+    }
+    return output;
   }
 };
 }  // namespace factorization
@@ -119,3 +180,8 @@ inline bool IsPrime(uint64_t n) {
   thread_local factorization::PrimalityTest test;
   return test.IsPrime(n);
 }
+
+inline std::vector<bool> IsPrimeBatch(std::span<const uint64_t> values) {
+  thread_local factorization::PrimalityTest test;
+  return test.IsPrimeBatch(values);
+}
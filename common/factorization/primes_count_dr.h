@@ -0,0 +1,413 @@
+#pragma once
+
+#include "common/base.h"
+#include "common/factorization/table/pi_compact.h"
+#include "common/numeric/utils/ucbrt.h"
+#include "common/numeric/utils/usqrt.h"
+#include "common/thread_pool.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace factorization {
+namespace hidden {
+// Bit for each odd number in [begin, end), begin is even. Counters of set
+// bits per block of words are kept during sieving.
+class PrimesCountSegment {
+ public:
+  static constexpr uint64_t block_words = 16;
+  static constexpr uint64_t block_bits = 64 * block_words;
+
+ protected:
+  uint64_t begin, end;
+  std::vector<uint64_t> bits;
+  std::vector<uint64_t> counters;
+  uint64_t total;
+  // Position for monotone Count queries.
+  uint64_t walk_block, walk_count;
+
+ public:
+  void Init(uint64_t _begin, uint64_t _end) {
+    assert(!(_begin & 1));
+    begin = _begin;
+    end = _end;
+    const uint64_t size = (end - begin) / 2, words = (size + 63) / 64;
+    bits.assign(words, ~0ull);
+    if (size % 64) bits.back() = (1ull << (size % 64)) - 1;
+    counters.resize((words + block_words - 1) / block_words);
+    total = 0;
+    for (uint64_t b = 0; b < counters.size(); ++b) {
+      uint64_t c = 0;
+      for (uint64_t w = b * block_words;
+           w < std::min(words, (b + 1) * block_words); ++w)
+        c += unsigned(std::popcount(bits[w]));
+      counters[b] = c;
+      total += c;
+    }
+  }
+
+  // Unsieved numbers in segment.
+  uint64_t Total() const { return total; }
+
+  // Removes odd multiples of p starting from first (multiple of p).
+  void Sieve(uint64_t p, uint64_t first) {
+    if (!(first & 1)) first += p;
+    for (uint64_t i = (first - begin) / 2, size = (end - begin) / 2; i < size;
+         i += p) {
+      uint64_t& w = bits[i / 64];
+      const uint64_t m = 1ull << (i % 64);
+      if (w & m) {
+        w &= ~m;
+        --counters[i / block_bits];
+        --total;
+      }
+    }
+  }
+
+  // Removes odd multiples of p that are not less than max(begin, p).
+  void SieveMultiples(uint64_t p) {
+    Sieve(p, std::max(p, (begin + p - 1) / p * p));
+  }
+
+  void ResetWalk() { walk_block = walk_count = 0; }
+
+  // Unsieved numbers in [begin, v], v in [begin, end). Requires
+  // non-decreasing v since last ResetWalk.
+  uint64_t Count(uint64_t v) {
+    const uint64_t t = (v - begin + 1) / 2, block = t / block_bits;
+    for (; walk_block < block; ++walk_block) walk_count += counters[walk_block];
+    uint64_t c = walk_count;
+    const uint64_t w = t / 64;
+    for (uint64_t i = block * block_words; i < w; ++i)
+      c += unsigned(std::popcount(bits[i]));
+    if (t % 64) c += unsigned(std::popcount(bits[w] << (64 - t % 64)));
+    return c;
+  }
+};
+}  // namespace hidden
+
+// Prime counting function based on Lagarias-Miller-Odlyzko algorithm with
+// Deleglise-Rivat split of special leaves
+// https://www.ams.org/journals/mcom/1996-65-213/S0025-5718-96-00674-6/S0025-5718-96-00674-6.pdf
+//   pi(x) = S1 + S2 + a - 1 - P2, y = alpha * x^(1/3), a = pi(y),
+//   S1 - ordinary leaves, phi(x / m, c) for small c from wheel table,
+//   S2 - special leaves -mu(m) * phi(x / (p_b * m), b - 1):
+//     hard leaves are counted with segmented sieve on [1, x / y],
+//     easy leaves (v < p_b^2) with pi table up to sqrt(x), consecutive
+//     leaves with same pi(v) are processed together,
+//     trivial leaves (v < p_b) in O(1) for each b,
+//   P2 - segmented sieve on [sqrt(x), x / y].
+// Segments are split in chunks for threads (on the shared pool), counts
+// before each chunk are added after all chunks are done. Tables (pi up to
+// sqrt(x), primes, lpf and mu up to y) could be shared by runs for all
+// x <= max_x.
+// Time: O(x^(2/3) / log^2(x)), memory: O(x^(1/2) / log(x)).
+class PrimesCountDR {
+ public:
+  static constexpr unsigned c = 6;
+  static constexpr uint64_t wheel = 2 * 3 * 5 * 7 * 11 * 13;
+  static constexpr uint64_t segment_size = (1u << 20);
+  static constexpr uint64_t small_limit = (1u << 20);
+
+  static constexpr uint64_t TableSize(uint64_t x) {
+    return std::max(USqrt(x), small_limit) + 4096;
+  }
+
+  // y = alpha * x^(1/3), non-decreasing in x.
+  static uint64_t Y(uint64_t x) {
+    const uint64_t x3 = UCbrt(x);
+    const double lx = std::log(double(x)),
+                 alpha = std::max(1.0, 0.0004 * lx * lx * lx);
+    return std::min(USqrt(x), std::max(x3 + 1, uint64_t(alpha * double(x3))));
+  }
+
+  class Tables {
+   public:
+    uint64_t max_y;
+    table::PiCompact pi;
+    std::vector<uint64_t> primes;  // 1-based
+    std::vector<unsigned> lpf;
+    std::vector<int8_t> mu;
+    std::vector<uint64_t> phi_wheel;
+
+   public:
+    explicit Tables(uint64_t max_x)
+        : max_y(Y(std::max<uint64_t>(max_x, 2))), pi(TableSize(max_x)) {
+      primes.assign(1, 0);
+      if (max_x <= pi.GetTableSize()) return;  // Only pi table is used
+      pi.ForEachPrime(0, max_y + 1, [&](uint64_t p) { primes.push_back(p); });
+      lpf.assign(max_y + 1, 0);
+      mu.assign(max_y + 1, 1);
+      lpf[1] = -1u;
+      for (uint64_t b = 1; b < primes.size(); ++b) {
+        const uint64_t p = primes[b];
+        for (uint64_t j = p; j <= max_y; j += p) {
+          if (!lpf[j]) lpf[j] = unsigned(p);
+          mu[j] = -mu[j];
+        }
+        for (uint64_t j = p * p; j <= max_y; j += p * p) mu[j] = 0;
+      }
+      phi_wheel.resize(wheel + 1);
+      phi_wheel[0] = 0;
+      for (uint64_t i = 1; i <= wheel; ++i) {
+        bool coprime = true;
+        for (unsigned b = 1; b <= c; ++b) coprime = coprime && (i % primes[b]);
+        phi_wheel[i] = phi_wheel[i - 1] + (coprime ? 1 : 0);
+      }
+    }
+  };
+
+ protected:
+
+  class ChunkResult {
+   public:
+    int64_t sum = 0;
+    std::vector<int64_t> mu_sum;
+    std::vector<uint64_t> phi;
+  };
+
+ protected:
+  uint64_t x, y, z, sqrt_x, sqrt_y, x4, a;
+  unsigned threads, b_max;
+  std::shared_ptr<const Tables> tables;
+  const table::PiCompact& pi;
+  const std::vector<uint64_t>& primes;
+  const std::vector<unsigned>& lpf;
+  const std::vector<int8_t>& mu;
+  const std::vector<uint64_t>& phi_wheel;
+
+ public:
+  explicit PrimesCountDR(uint64_t _x, unsigned _threads = 1)
+      : PrimesCountDR(_x, std::make_shared<Tables>(_x), _threads) {}
+
+  // _tables should be built for max_x >= _x.
+  PrimesCountDR(uint64_t _x, std::shared_ptr<const Tables> _tables,
+                unsigned _threads = 1)
+      : x(_x),
+        threads(std::max(_threads, 1u)),
+        tables(std::move(_tables)),
+        pi(tables->pi),
+        primes(tables->primes),
+        lpf(tables->lpf),
+        mu(tables->mu),
+        phi_wheel(tables->phi_wheel) {}
+
+  uint64_t Run() {
+    if (x <= pi.GetTableSize()) return pi(x);
+    Init();
+    const int64_t s = S1() + S2Easy() + S2Hard() + int64_t(a) - 1 - P2();
+    return uint64_t(s);
+  }
+
+ protected:
+  void Init() {
+    sqrt_x = USqrt(x);
+    x4 = USqrt(sqrt_x);
+    y = Y(x);
+    assert(y <= tables->max_y);
+    z = x / y + 1;
+    sqrt_y = USqrt(y);
+    a = pi(y);
+    b_max = unsigned(std::min(a - 1, pi(std::max(sqrt_y, x4))));
+  }
+
+  // phi(v, c)
+  uint64_t PhiC(uint64_t v) const {
+    return (v / wheel) * phi_wheel[wheel] + phi_wheel[v % wheel];
+  }
+
+  template <class F>
+  void ParallelFor(size_t first, size_t last, const F& f) const {
+    if (threads <= 1) {
+      for (size_t i = first; i < last; ++i) f(i);
+    } else {
+      ThreadPool::Shared(threads - 1).ParallelFor(first, last, f, 1);
+    }
+  }
+
+  int64_t S1() const {
+    int64_t s = 0;
+    for (uint64_t m = 1; m <= y; ++m) {
+      if (mu[m] && (lpf[m] > primes[c])) s += mu[m] * int64_t(PhiC(x / m));
+    }
+    return s;
+  }
+
+  // Easy and trivial leaves for p_b > sqrt(y), m = q is prime.
+  int64_t S2EasyB(uint64_t b) const {
+    const uint64_t p = primes[b], xp = x / p, xpp = xp / p;
+    // Trivial leaves, q > x / p^2.
+    int64_t s = int64_t(a - pi(std::max(p, std::min(y, xpp))));
+    // Easy leaves, x / p^3 < q <= x / p^2.
+    uint64_t ih = pi(std::min(y, xpp));
+    const uint64_t il = pi(std::max(p, std::min(y, xpp / p)));
+    for (; ih > il;) {
+      const uint64_t v = xp / primes[ih], k = pi(v),
+                     j = std::max(il, pi(xp / pi.NextPrime(v)));
+      s += int64_t((ih - j) * (k - b + 2));
+      ih = j;
+    }
+    return s;
+  }
+
+  int64_t S2Easy() const {
+    const uint64_t b0 = std::max<uint64_t>(c, pi(sqrt_y)) + 1;
+    if (b0 >= a) return 0;
+    std::vector<int64_t> vs(a - b0);
+    ParallelFor(b0, a, [&](size_t b) { vs[b - b0] = S2EasyB(b); });
+    int64_t s = 0;
+    for (auto v : vs) s += v;
+    return s;
+  }
+
+  // Hard leaves with v in segment for b in (c, b_max].
+  void S2HardSegment(hidden::PrimesCountSegment& segment, uint64_t begin,
+                     uint64_t end, ChunkResult& r) const {
+    segment.Init(begin, end);
+    for (unsigned b = 2; b <= c; ++b) segment.SieveMultiples(primes[b]);
+    for (unsigned b = c + 1; b <= b_max; ++b) {
+      const uint64_t p = primes[b], xp = x / p;
+      segment.ResetWalk();
+      int64_t ms = 0;
+      uint64_t phi = r.phi[b];
+      if (p <= sqrt_y) {
+        const uint64_t ml = std::max(y / p, xp / end),
+                       mh = std::min(y, begin ? xp / begin : y);
+        for (uint64_t m = mh; m > ml; --m) {
+          if (mu[m] && (lpf[m] > p)) {
+            const uint64_t v = xp / m;
+            r.sum -= mu[m] * int64_t(phi + segment.Count(v));
+            ms -= mu[m];
+          }
+        }
+      } else {
+        const uint64_t ql = std::max(p, xp / end),
+                       qh = std::min(std::min(y, xp / p / p),
+                                     begin ? xp / begin : y);
+        if (ql < qh) {
+          for (uint64_t i = pi(qh), il = pi(ql); i > il; --i) {
+            const uint64_t v = xp / primes[i];
+            r.sum += int64_t(phi + segment.Count(v));
+            ++ms;
+          }
+        }
+      }
+      r.mu_sum[b] += ms;
+      r.phi[b] += segment.Total();
+      segment.SieveMultiples(p);
+    }
+  }
+
+  int64_t S2Hard() const {
+    if (b_max <= c) return 0;
+    const uint64_t segments = (z + segment_size - 1) / segment_size,
+                   chunks = std::min<uint64_t>(
+                       segments, (threads <= 1) ? 1 : 8 * threads),
+                   segments_per_chunk = (segments + chunks - 1) / chunks;
+    std::vector<ChunkResult> results(chunks);
+    ParallelFor(0, chunks, [&](size_t k) {
+      auto& r = results[k];
+      r.mu_sum.assign(b_max + 1, 0);
+      r.phi.assign(b_max + 1, 0);
+      hidden::PrimesCountSegment segment;
+      for (uint64_t i = k * segments_per_chunk;
+           i < std::min(segments, (k + 1) * segments_per_chunk); ++i) {
+        S2HardSegment(segment, i * segment_size,
+                      std::min(z, (i + 1) * segment_size), r);
+      }
+    });
+    int64_t s = 0;
+    std::vector<uint64_t> phi(b_max + 1, 0);
+    for (auto& r : results) {
+      s += r.sum;
+      for (unsigned b = c + 1; b <= b_max; ++b) {
+        s += r.mu_sum[b] * int64_t(phi[b]);
+        phi[b] += r.phi[b];
+      }
+    }
+    return s;
+  }
+
+  // sum pi(x / p) for y < p <= sqrt(x) - sum (b - 1) for a < b <= pi(sqrt(x)).
+  int64_t P2() const {
+    const uint64_t pb = pi(sqrt_x);
+    if (a >= pb) return 0;
+    const uint64_t first = sqrt_x & ~1ull,
+                   segments = (z - first + segment_size - 1) / segment_size,
+                   chunks = std::min<uint64_t>(
+                       segments, (threads <= 1) ? 1 : 8 * threads),
+                   segments_per_chunk = (segments + chunks - 1) / chunks;
+    // sum of pi(x / p) in chunk, number of p, primes in chunk.
+    std::vector<std::array<uint64_t, 3>> results(chunks);
+    ParallelFor(0, chunks, [&](size_t k) {
+      auto& r = results[k];
+      r = {0, 0, 0};
+      hidden::PrimesCountSegment segment;
+      for (uint64_t i = k * segments_per_chunk;
+           i < std::min(segments, (k + 1) * segments_per_chunk); ++i) {
+        const uint64_t begin = first + i * segment_size,
+                       end = std::min(z, begin + segment_size);
+        segment.Init(begin, end);
+        for (uint64_t j = 2; (j <= a) && (primes[j] * primes[j] < end); ++j)
+          segment.Sieve(primes[j], std::max(primes[j] * primes[j],
+                                            (begin + primes[j] - 1) /
+                                                primes[j] * primes[j]));
+        segment.ResetWalk();
+        // x / p in [begin, end) for p in (x / end, x / begin].
+        const uint64_t pl = std::max(y, x / end) + 1,
+                       ph = std::min(sqrt_x, x / begin);
+        std::vector<uint64_t> vp;
+        if (pl <= ph) pi.ForEachPrime(pl, ph + 1, [&](uint64_t p) {
+          vp.push_back(p);
+        });
+        for (size_t j = vp.size(); j-- > 0;) {
+          r[0] += r[2] + segment.Count(x / vp[j]);
+          ++r[1];
+        }
+        r[2] += segment.Total();
+      }
+    });
+    uint64_t s = 0, count = pi(first - 1);
+    for (auto& r : results) {
+      s += r[0] + r[1] * count;
+      count += r[2];
+    }
+    return int64_t(s) - int64_t((pb * (pb - 1) - a * (a - 1)) / 2);
+  }
+};
+
+// Same interface as PrimesCountQuotients: GetQ(q) = pi(n / q) and GetR(r) =
+// pi(r) for r = n / q. Values up to sqrt(n) are taken from table, other
+// values are computed with PrimesCountDR on first request and cached. Tables
+// are built once for n and shared by all runs.
+class PrimesCountQuotientsDR {
+ protected:
+  uint64_t n;
+  unsigned threads;
+  std::shared_ptr<const PrimesCountDR::Tables> tables;
+  std::unordered_map<uint64_t, uint64_t> cache;
+
+ public:
+  explicit PrimesCountQuotientsDR(uint64_t _n, unsigned _threads = 1)
+      : n(_n),
+        threads(_threads),
+        tables(std::make_shared<PrimesCountDR::Tables>(_n)) {}
+
+  uint64_t GetR(uint64_t r) {
+    assert(r <= n);
+    if (r <= tables->pi.GetTableSize()) return tables->pi(r);
+    auto it = cache.find(r);
+    if (it != cache.end()) return it->second;
+    const uint64_t value = PrimesCountDR(r, tables, threads).Run();
+    cache[r] = value;
+    return value;
+  }
+
+  uint64_t GetQ(uint64_t q) { return GetR(n / q); }
+};
+}  // namespace factorization
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "common/base.h"
+#include "common/numeric/utils/usqrt.h"
+
+#include <bit>
+#include <vector>
+
+namespace factorization {
+namespace table {
+// pi(n) for n <= size with one bit per odd number and prime counts before
+// each 64-bit word (~size / 10 bytes). Bitmap is built with segmented sieve.
+class PiCompact {
+ protected:
+  static constexpr uint64_t block_words = 4096;
+
+ protected:
+  uint64_t table_size;
+  // Bit i of word w is set if 128 * w + 2 * i + 1 is prime.
+  std::vector<uint64_t> bits;
+  std::vector<uint64_t> counts;
+
+ public:
+  explicit PiCompact(uint64_t size) : table_size(size) {
+    const uint64_t words = size / 128 + 1;
+    bits.resize(words, ~0ull);
+    bits[0] &= ~1ull;
+    const uint64_t ssize = USqrt(size);
+    std::vector<uint64_t> primes, next;
+    for (uint64_t p = 3; p <= ssize; p += 2) {
+      bool prime = true;
+      for (uint64_t q : primes) {
+        if (q * q > p) break;
+        if ((p % q) == 0) {
+          prime = false;
+          break;
+        }
+      }
+      if (prime) {
+        primes.push_back(p);
+        next.push_back(p * p / 2);
+      }
+    }
+    for (uint64_t w0 = 0; w0 < words; w0 += block_words) {
+      const uint64_t end = std::min(words, w0 + block_words) * 64;
+      for (size_t j = 0; j < primes.size(); ++j) {
+        uint64_t i = next[j];
+        for (const uint64_t p = primes[j]; i < end; i += p)
+          bits[i / 64] &= ~(1ull << (i % 64));
+        next[j] = i;
+      }
+    }
+    // Bits above size.
+    const uint64_t last = (size + 1) / 2;
+    if (last % 64) bits[last / 64] &= (1ull << (last % 64)) - 1;
+    for (uint64_t w = last / 64 + ((last % 64) ? 1 : 0); w < words; ++w)
+      bits[w] = 0;
+    counts.resize(words + 1);
+    counts[0] = (size >= 2) ? 1 : 0;
+    for (uint64_t w = 0; w < words; ++w)
+      counts[w + 1] = counts[w] + unsigned(std::popcount(bits[w]));
+  }
+
+  uint64_t GetTableSize() const { return table_size; }
+
+  bool IsPrime(uint64_t n) const {
+    assert(n <= table_size);
+    if (!(n & 1)) return n == 2;
+    return (bits[n / 128] >> ((n / 2) % 64)) & 1;
+  }
+
+  uint64_t Get(uint64_t n) const {
+    assert(n <= table_size);
+    if (n < 2) return 0;
+    const uint64_t i = (n - 1) / 2, w = i / 64;
+    const uint64_t mask = ~0ull >> (63 - (i % 64));
+    return counts[w] + unsigned(std::popcount(bits[w] & mask));
+  }
+
+  uint64_t operator()(uint64_t n) const { return Get(n); }
+
+  // Smallest prime above n, 0 if it is above table size.
+  uint64_t NextPrime(uint64_t n) const {
+    if (n < 2) return (table_size >= 2) ? 2 : 0;
+    uint64_t i = (n + 1) / 2, w = i / 64;
+    if (w >= bits.size()) return 0;
+    uint64_t word = bits[w] & (~0ull << (i % 64));
+    for (; !word;) {
+      if (++w >= bits.size()) return 0;
+      word = bits[w];
+    }
+    return 128 * w + 2 * unsigned(std::countr_zero(word)) + 1;
+  }
+
+  // Calls f(p) for primes p in [begin, end) in increasing order.
+  template <class F>
+  void ForEachPrime(uint64_t begin, uint64_t end, const F& f) const {
+    assert(end <= table_size + 1);
+    if ((begin <= 2) && (end > 2)) f(uint64_t(2));
+    if (begin >= end) return;
+    const uint64_t ib = begin / 2, ie = end / 2;
+    for (uint64_t w = ib / 64; w * 64 < ie; ++w) {
+      uint64_t word = bits[w];
+      if (w == ib / 64) word &= (~0ull << (ib % 64));
+      for (; word; word &= word - 1) {
+        const uint64_t i = 64 * w + unsigned(std::countr_zero(word));
+        if (i >= ie) return;
+        f(2 * i + 1);
+      }
+    }
+  }
+};
+}  // namespace table
+}  // namespace factorization
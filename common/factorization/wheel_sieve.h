@@ -0,0 +1,276 @@
+#pragma once
+
+#include "common/base.h"
+#include "common/numeric/utils/usqrt.h"
+#include "common/thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstring>
+#include <vector>
+
+namespace factorization {
+// Segmented sieve of Eratosthenes on mod 30 wheel.
+// Byte k represents numbers 30k + {1, 7, 11, 13, 17, 19, 23, 29}, set bit
+// means prime. Multiples of 7, 11 and 13 are removed by copying a periodic
+// pattern, every other sieving prime keeps the position of its next multiple
+// between segments, so there are no divisions inside the main loop.
+// Primes are reported through callbacks, so memory is O(segment + sqrt(n)).
+class WheelSieve {
+ public:
+  // Fits in L1 data cache.
+  static constexpr size_t default_segment_bytes = 32768;
+
+ protected:
+  static constexpr unsigned offsets[8] = {1, 7, 11, 13, 17, 19, 23, 29};
+  static constexpr unsigned steps[8] = {6, 4, 2, 4, 2, 4, 6, 2};
+  static constexpr unsigned presieve_bytes = 7 * 11 * 13;
+
+  struct Tables {
+    uint8_t bit_index[30];  // 8 if not coprime with 30.
+    uint8_t mask[8][8];     // Bit for (offsets[i] * offsets[j]) % 30.
+    uint8_t carry[8][8];    // Byte increment from p % 30 part of prime.
+    uint8_t presieve[presieve_bytes];
+  };
+
+  static Tables MakeTables() {
+    Tables t;
+    std::fill(t.bit_index, t.bit_index + 30, 8);
+    for (unsigned i = 0; i < 8; ++i) t.bit_index[offsets[i]] = uint8_t(i);
+    for (unsigned i = 0; i < 8; ++i) {
+      const unsigned c = offsets[i];
+      for (unsigned j = 0; j < 8; ++j) {
+        const unsigned r = offsets[j];
+        t.mask[i][j] = uint8_t(1u << t.bit_index[(c * r) % 30]);
+        t.carry[i][j] = uint8_t((c * (r + steps[j])) / 30 - (c * r) / 30);
+      }
+    }
+    for (unsigned k = 0; k < presieve_bytes; ++k) {
+      uint8_t b = 0;
+      for (unsigned i = 0; i < 8; ++i) {
+        const unsigned n = 30 * k + offsets[i];
+        if ((n % 7) && (n % 11) && (n % 13)) b |= uint8_t(1u << i);
+      }
+      t.presieve[k] = b;
+    }
+    return t;
+  }
+
+  static const Tables& GetTables() {
+    static const Tables t = MakeTables();
+    return t;
+  }
+
+  struct SievingPrime {
+    uint64_t index;  // Byte of the next multiple.
+    uint32_t q;      // p / 30
+    uint8_t ci, wi;  // Wheel indices of p and of the next multiplier.
+  };
+
+ protected:
+  size_t segment_bytes;
+
+ public:
+  explicit WheelSieve(size_t _segment_bytes = default_segment_bytes)
+      : segment_bytes(std::max<size_t>(_segment_bytes & ~size_t(7), 8)) {}
+
+ protected:
+  // Primes p >= 17 with p * p <= last.
+  std::vector<uint32_t> SievingPrimes(uint64_t last) const {
+    std::vector<uint32_t> v;
+    const uint64_t s = USqrt(last);
+    if (s >= 17) ForEach(17, s, [&](uint64_t p) { v.push_back(uint32_t(p)); });
+    return v;
+  }
+
+  // Sieving state for multiples of primes starting from byte first_byte.
+  static std::vector<SievingPrime> InitState(const std::vector<uint32_t>& vp,
+                                             uint64_t first_byte) {
+    const auto& t = GetTables();
+    std::vector<SievingPrime> v(vp.size());
+    for (size_t i = 0; i < vp.size(); ++i) {
+      const uint64_t p = vp[i];
+      uint64_t m = std::max(p, (30 * first_byte + p - 1) / p);
+      while (t.bit_index[m % 30] == 8) ++m;
+      v[i] = {(p * m) / 30, uint32_t(p / 30), t.bit_index[p % 30],
+              t.bit_index[m % 30]};
+    }
+    return v;
+  }
+
+  static void CrossOff(uint8_t* segment, uint64_t sb, uint64_t se,
+                       std::vector<SievingPrime>& vs) {
+    const auto& t = GetTables();
+    for (auto& s : vs) {
+      uint64_t index = s.index;
+      if (index >= se) continue;
+      const uint64_t q = s.q;
+      const uint8_t* mask = t.mask[s.ci];
+      const uint8_t* carry = t.carry[s.ci];
+      unsigned wi = s.wi;
+      // Full wheel cycles, 8 multiples and p bytes each.
+      const uint64_t p = 30 * q + offsets[s.ci];
+      if (index + p <= se) {
+        uint64_t offset[8];
+        uint8_t keep[8];
+        for (unsigned k = 0, d = 0; k < 8; ++k) {
+          const unsigned w = (wi + k) & 7;
+          offset[k] = d;
+          keep[k] = uint8_t(~mask[w]);
+          d += unsigned(q * steps[w] + carry[w]);
+        }
+        uint8_t* b = segment + (index - sb);
+        for (; index + offset[7] < se; index += p, b += p) {
+          for (unsigned k = 0; k < 8; ++k) b[offset[k]] &= keep[k];
+        }
+      }
+      for (; index < se; wi = (wi + 1) & 7) {
+        segment[index - sb] &= uint8_t(~mask[wi]);
+        index += q * steps[wi] + carry[wi];
+      }
+      s.index = index;
+      s.wi = uint8_t(wi);
+    }
+  }
+
+  // Bits for offsets below r.
+  static uint8_t LowerBits(unsigned r) {
+    uint8_t b = 0;
+    for (unsigned i = 0; i < 8; ++i) {
+      if (offsets[i] < r) b |= uint8_t(1u << i);
+    }
+    return b;
+  }
+
+  // Calls f(segment, first_byte, bytes) for segments covering bytes
+  // [first_byte, last_byte). Only numbers in [first, last] are kept, bytes
+  // after the end of segment are zero up to 8 bytes alignment.
+  template <class TSegmentFunction>
+  void SieveBytes(uint64_t first_byte, uint64_t last_byte, uint64_t first,
+                  uint64_t last, const std::vector<uint32_t>& vp,
+                  TSegmentFunction& f) const {
+    const auto& t = GetTables();
+    auto vs = InitState(vp, first_byte);
+    std::vector<uint8_t> segment(segment_bytes);
+    for (uint64_t sb = first_byte; sb < last_byte; sb += segment_bytes) {
+      const uint64_t se = std::min<uint64_t>(sb + segment_bytes, last_byte);
+      const size_t size = size_t(se - sb);
+      for (size_t j = 0, k = size_t(sb % presieve_bytes); j < size;) {
+        const size_t l = std::min<size_t>(size - j, presieve_bytes - k);
+        std::memcpy(segment.data() + j, t.presieve + k, l);
+        j += l;
+        k = 0;
+      }
+      // 1 is not prime, 7, 11 and 13 are.
+      if (sb == 0) segment[0] = (segment[0] & 0xFE) | 0x0E;
+      CrossOff(segment.data(), sb, se, vs);
+      if (sb == first / 30)
+        segment[0] &= uint8_t(~LowerBits(unsigned(first % 30)));
+      if (se - 1 == last / 30)
+        segment[size - 1] &= LowerBits(unsigned(last % 30) + 1);
+      std::fill(segment.begin() + size,
+                segment.begin() + ((size + 7) & ~size_t(7)), 0);
+      f(segment.data(), sb, size);
+    }
+  }
+
+  template <class TSegmentFunction>
+  void Sieve(uint64_t first, uint64_t last, unsigned threads,
+             TSegmentFunction f) const {
+    first = std::max<uint64_t>(first, 7);
+    if (first > last) return;
+    const auto vp = SievingPrimes(last);
+    const uint64_t first_byte = first / 30, last_byte = last / 30 + 1;
+    const uint64_t segments =
+        (last_byte - first_byte + segment_bytes - 1) / segment_bytes;
+    if ((threads <= 1) || (segments <= 1)) {
+      SieveBytes(first_byte, last_byte, first, last, vp, f);
+      return;
+    }
+    // Each task initializes sieving state once for a range of segments.
+    const uint64_t tasks = std::min<uint64_t>(segments, 8 * threads),
+                   segments_per_task = (segments + tasks - 1) / tasks;
+    ThreadPool::Shared(threads - 1).ParallelFor(
+        0, size_t(tasks),
+        [&](size_t i) {
+          const uint64_t b = first_byte + i * segments_per_task * segment_bytes,
+                         e = std::min<uint64_t>(
+                             b + segments_per_task * segment_bytes, last_byte);
+          auto g = f;
+          if (b < e) SieveBytes(b, e, first, last, vp, g);
+        },
+        1);
+  }
+
+  template <class TFunction>
+  static void ForEachInSegment(const uint8_t* segment, uint64_t sb,
+                               size_t size, TFunction& f) {
+    for (size_t j = 0; j < size; j += 8) {
+      uint64_t w;
+      std::memcpy(&w, segment + j, 8);
+      for (; w; w &= w - 1) {
+        const unsigned bit = unsigned(std::countr_zero(w));
+        f(30 * (sb + j + bit / 8) + offsets[bit % 8]);
+      }
+    }
+  }
+
+  static uint64_t CountInSegment(const uint8_t* segment, size_t size) {
+    uint64_t r = 0;
+    for (size_t j = 0; j < size; j += 8) {
+      uint64_t w;
+      std::memcpy(&w, segment + j, 8);
+      r += unsigned(std::popcount(w));
+    }
+    return r;
+  }
+
+ public:
+  // Calls f(p) for primes p in [first, last] in increasing order.
+  template <class TFunction>
+  void ForEach(uint64_t first, uint64_t last, TFunction f) const {
+    for (uint64_t p : {2, 3, 5}) {
+      if ((first <= p) && (p <= last)) f(p);
+    }
+    auto g = [&](const uint8_t* segment, uint64_t sb, size_t size) {
+      ForEachInSegment(segment, sb, size, f);
+    };
+    Sieve(first, last, 1, g);
+  }
+
+  // Calls f(p) for primes p in [first, last] from several threads. Primes
+  // are increasing inside each segment, segments are processed in any order.
+  template <class TFunction>
+  void ForEach(uint64_t first, uint64_t last, const TFunction& f,
+               unsigned threads) const {
+    for (uint64_t p : {2, 3, 5}) {
+      if ((first <= p) && (p <= last)) f(p);
+    }
+    auto g = [&](const uint8_t* segment, uint64_t sb, size_t size) {
+      ForEachInSegment(segment, sb, size, f);
+    };
+    Sieve(first, last, threads, g);
+  }
+
+  // Number of primes in [first, last].
+  uint64_t Count(uint64_t first, uint64_t last, unsigned threads = 1) const {
+    uint64_t r = 0;
+    for (uint64_t p : {2, 3, 5}) {
+      if ((first <= p) && (p <= last)) ++r;
+    }
+    std::atomic<uint64_t> total = 0;
+    auto g = [&](const uint8_t* segment, uint64_t, size_t size) {
+      total += CountInSegment(segment, size);
+    };
+    Sieve(first, last, threads, g);
+    return r + total;
+  }
+
+  std::vector<uint64_t> Primes(uint64_t first, uint64_t last) const {
+    std::vector<uint64_t> v;
+    ForEach(first, last, [&](uint64_t p) { v.push_back(p); });
+    return v;
+  }
+};
+}  // namespace factorization
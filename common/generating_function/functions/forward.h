@@ -0,0 +1,39 @@
+#pragma once
+
+#include "common/base.h"
+#include "common/generating_function/generating_function.h"
+
+namespace gf {
+namespace functions {
+// Placeholder for self-referential definitions, e.g. for Catalan numbers
+//   auto c = MakePForward<T>();
+//   PGeneratingFunction<T> pc = c;
+//   c->Set(MakePConstant<T>(1) + MakeShift<T>(pc * pc, 1));
+// Coefficient n of the definition should depend only on earlier
+// coefficients of the placeholder. Definition owns the placeholder, so
+// Set(nullptr) should be called to break the cycle.
+template <class TValue>
+class PForward : public GeneratingFunction<TValue> {
+ protected:
+  PGeneratingFunction<TValue> f;
+
+ public:
+  void Set(PGeneratingFunction<TValue> _f) { f = _f; }
+
+  void Adjust(uint64_t n) override {
+    assert(f);
+    f->Adjust(n);
+  }
+
+  TValue Get(uint64_t n) override {
+    assert(f);
+    return f->Get(n);
+  }
+};
+
+template <class TValue>
+inline std::shared_ptr<PForward<TValue>> MakePForward() {
+  return std::make_shared<PForward<TValue>>();
+}
+}  // namespace functions
+}  // namespace gf
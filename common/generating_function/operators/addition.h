@@ -22,7 +22,7 @@ class Addition : public GeneratingFunction<TValue> {
       f1->Adjust(n);
       f2->Adjust(n);
       for (unsigned k = va.size(); k <= n; ++k)
-        va.push_back(f1->Get(k), f2->Get(k));
+        va.push_back(f1->Get(k) + f2->Get(k));
     }
   }
 
@@ -2,16 +2,22 @@
 
 #include "common/base.h"
 #include "common/generating_function/generating_function.h"
+#include "common/generating_function/operators/relaxed_convolution.h"
 
 #include <vector>
 
 namespace gf {
 namespace operators {
+// Coefficient k of f1 and f2 is requested only when coefficient k of the
+// product is computed, so f1 and f2 could depend on earlier coefficients of
+// the product (see functions::PForward).
 template <class TValue>
 class Multiplication : public GeneratingFunction<TValue> {
  protected:
   PGeneratingFunction<TValue> f1, f2;
+  RelaxedConvolution<TValue> rc;
   std::vector<TValue> va;
+  bool adjusting = false;
 
  public:
   Multiplication(PGeneratingFunction<TValue> _f1,
@@ -19,15 +25,13 @@ class Multiplication : public GeneratingFunction<TValue> {
       : f1(_f1), f2(_f2) {}
 
   void Adjust(uint64_t n) override {
-    if (n >= va.size()) {
-      f1->Adjust(n);
-      f2->Adjust(n);
-      for (unsigned k = va.size(); k <= n; ++k) {
-        TValue x = TValue();
-        for (unsigned i = 0; i <= k; ++i) x += f1->Get(i) * f2->Get(k - i);
-        va.push_back(x);
-      }
-    }
+    if (n < va.size()) return;
+    // Otherwise some coefficient of the product depends on itself.
+    assert(!adjusting);
+    adjusting = true;
+    for (uint64_t k = va.size(); k <= n; ++k)
+      va.push_back(rc.Push(f1->Get(k), f2->Get(k)));
+    adjusting = false;
   }
 
   TValue Get(uint64_t n) override {
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "common/base.h"
+#include "common/modular.h"
+#include "common/modular/static/convolution.h"
+#include "common/numeric/convolution_base.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace gf {
+namespace operators {
+template <class TValue>
+inline std::vector<TValue> BlockConvolution(const std::vector<TValue>& a,
+                                            const std::vector<TValue>& b) {
+  return numeric::ConvolutionBase(a, b);
+}
+
+template <uint64_t prime>
+inline std::vector<ModularPrime32<prime>> BlockConvolution(
+    const std::vector<ModularPrime32<prime>>& a,
+    const std::vector<ModularPrime32<prime>>& b) {
+  return modular::mstatic::Convolution(a, b);
+}
+
+// Online convolution h = f * g. Push(f_t, g_t) returns h_t, so f_t and g_t
+// could depend on h_0, ..., h_{t-1}. Pairs (i, j) are split in squares of
+// size s = 2^k that are multiplied as soon as both ranges are known:
+//   [s-1, 2s-1) x [s-1, 2s-1) at t = 2s - 2,
+//   [t+1-s, t+1) x [s-1, 2s-1) and its mirror at t > 2s - 2, s | t + 2.
+// Total time is O(n log^2 n) if BlockConvolution is O(s log s).
+template <class TValue>
+class RelaxedConvolution {
+ protected:
+  static constexpr size_t naive_block_size = 32;
+
+  std::vector<TValue> f, g, h;
+
+ protected:
+  void AddBlock(const std::vector<TValue>& x, size_t xi,
+                const std::vector<TValue>& y, size_t yi, size_t s) {
+    TValue* ph = h.data() + xi + yi;
+    if (s <= naive_block_size) {
+      for (size_t i = 0; i < s; ++i) {
+        const TValue xv = x[xi + i];
+        for (size_t j = 0; j < s; ++j) ph[i + j] += xv * y[yi + j];
+      }
+    } else {
+      const auto r = BlockConvolution(
+          std::vector<TValue>(x.begin() + xi, x.begin() + xi + s),
+          std::vector<TValue>(y.begin() + yi, y.begin() + yi + s));
+      // FFT result could be padded with zeros.
+      for (size_t i = 0; i < std::min(r.size(), 2 * s - 1); ++i) ph[i] += r[i];
+    }
+  }
+
+ public:
+  size_t Size() const { return f.size(); }
+
+  TValue Push(const TValue& ft, const TValue& gt) {
+    const size_t t = f.size();
+    f.push_back(ft);
+    g.push_back(gt);
+    if (h.size() < 2 * t + 1) h.resize(std::max(2 * t + 1, 2 * h.size()));
+    for (size_t s = 1; ((t + 2) % s == 0) && (2 * s <= t + 2); s *= 2) {
+      if (t + 2 == 2 * s) {
+        AddBlock(f, s - 1, g, s - 1, s);
+      } else {
+        AddBlock(f, t + 1 - s, g, s - 1, s);
+        AddBlock(g, t + 1 - s, f, s - 1, s);
+      }
+    }
+    return h[t];
+  }
+};
+}  // namespace operators
+}  // namespace gf
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "common/base.h"
+#include "common/generating_function/generating_function.h"
+
+namespace gf {
+namespace operators {
+// x^k * f(x)
+template <class TValue>
+class Shift : public GeneratingFunction<TValue> {
+ protected:
+  PGeneratingFunction<TValue> f;
+  uint64_t k;
+
+ public:
+  Shift(PGeneratingFunction<TValue> _f, uint64_t _k) : f(_f), k(_k) {}
+
+  void Adjust(uint64_t n) override {
+    if (n >= k) f->Adjust(n - k);
+  }
+
+  TValue Get(uint64_t n) override {
+    return (n < k) ? TValue(0) : f->Get(n - k);
+  }
+};
+
+template <class TValue>
+inline PGeneratingFunction<TValue> MakeShift(PGeneratingFunction<TValue> f,
+                                             uint64_t k) {
+  return std::make_shared<Shift<TValue>>(f, k);
+}
+}  // namespace operators
+}  // namespace gf
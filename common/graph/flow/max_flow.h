@@ -2,8 +2,26 @@
 
 #include "common/graph/flow/graph.h"
 #include "common/graph/flow/max_flow/dinic.h"
+#include "common/graph/flow/max_flow/edmonds_karp.h"
+#include "common/graph/flow/max_flow/push_relabel.h"
+
+namespace graph {
+namespace flow {
+enum class EMaxFlowAlgorithm { EDMONDS_KARP, DINIC, PUSH_RELABEL };
+}  // namespace flow
+}  // namespace graph
 
 template <class TEdge>
-inline typename TEdge::TFlow MaxFlow(graph::flow::Graph<TEdge>& g) {
-  return graph::flow::max_flow::Dinic(g);
+inline typename TEdge::TFlow MaxFlow(
+    graph::flow::Graph<TEdge>& g,
+    graph::flow::EMaxFlowAlgorithm algorithm =
+        graph::flow::EMaxFlowAlgorithm::DINIC) {
+  switch (algorithm) {
+    case graph::flow::EMaxFlowAlgorithm::EDMONDS_KARP:
+      return graph::flow::max_flow::EdmondsKarp(g);
+    case graph::flow::EMaxFlowAlgorithm::PUSH_RELABEL:
+      return graph::flow::max_flow::PushRelabel(g);
+    default:
+      return graph::flow::max_flow::Dinic(g);
+  }
 }
@@ -1,10 +1,9 @@
 #pragma once
 
 #include "common/graph/flow/graph.h"
+#include "common/graph/flow/max_flow/residual_network.h"
 
 #include <algorithm>
-#include <functional>
-#include <queue>
 #include <vector>
 
 namespace graph {
@@ -13,55 +12,65 @@ namespace max_flow {
 // Dinic's algorithm
 // https://en.wikipedia.org/wiki/Dinic%27s_algorithm
 // Time: O(V^2 E)
+// Blocking flow is found with iterative DFS on residual network in CSR
+// layout. After augmentation DFS returns only to the first saturated arc of
+// the path, so other paths with the same prefix are used without restart.
 template <class TEdge>
 inline typename TEdge::TFlow Dinic(Graph<TEdge>& g) {
   using TFlow = typename TEdge::TFlow;
   const unsigned source = g.Source(), sink = g.Sink(), gsize = g.Size();
-  std::queue<unsigned> q;
-  std::vector<unsigned> d(gsize);
-  std::vector<unsigned> ei(gsize);
-  TFlow source_max_flow = 0;
-  for (auto& e : g.Edges(source))
-    source_max_flow = std::max(source_max_flow, e.max_flow);
-
-  const std::function<TFlow(unsigned, TFlow)> AddBlockingFlow =
-      [&](unsigned u, TFlow flow) -> TFlow {
-    if (u == sink) return flow;
-    const unsigned du = d[u];
-    auto& uedges = g.Edges(u);
-    for (unsigned& i = ei[u]; i < uedges.size(); ++i) {
-      auto& e = uedges[i];
-      if ((d[e.to] == du + 1) && (e.flow < e.max_flow)) {
-        auto flow_added =
-            AddBlockingFlow(e.to, std::min(flow, e.max_flow - e.flow));
-        if (flow_added) {
-          e.flow += flow_added;
-          g.ReversedEdge(e).flow -= flow_added;
-          return flow_added;
-        }
-      }
-    }
-    return 0;
-  };
+  hidden::ResidualNetwork<TFlow> rn(g);
+  std::vector<unsigned> q(gsize), d(gsize), current(gsize), path;
 
   for (;;) {
-    for (; !q.empty();) q.pop();
     std::fill(d.begin(), d.end(), -1u);
     d[source] = 0;
-    for (q.push(source); (d[sink] == -1u) && !q.empty(); q.pop()) {
-      const unsigned u = q.front(), du = d[u];
-      for (auto& e : g.Edges(u)) {
-        if ((e.flow < e.max_flow) && (d[e.to] == -1u)) {
-          d[e.to] = du + 1;
-          if (e.to == sink) break;
-          q.push(e.to);
+    q[0] = source;
+    for (unsigned qb = 0, qe = 1; (d[sink] == -1u) && (qb < qe); ++qb) {
+      const unsigned u = q[qb], du = d[u];
+      for (unsigned a = rn.head[u]; a < rn.head[u + 1]; ++a) {
+        const unsigned v = rn.to[a];
+        if ((rn.residual[a] > 0) && (d[v] == -1u)) {
+          d[v] = du + 1;
+          if (v == sink) break;
+          q[qe++] = v;
         }
       }
     }
     if (d[sink] == -1u) break;
-    std::fill(ei.begin(), ei.end(), 0);
-    while (AddBlockingFlow(source, source_max_flow));
+    std::copy(rn.head.begin(), rn.head.end() - 1, current.begin());
+    path.clear();
+    for (unsigned u = source;;) {
+      if (u == sink) {
+        TFlow flow = rn.residual[path[0]];
+        for (unsigned a : path) flow = std::min(flow, rn.residual[a]);
+        unsigned k = unsigned(path.size());
+        for (unsigned i = unsigned(path.size()); i-- > 0;) {
+          rn.Push(path[i], flow);
+          if (rn.residual[path[i]] == 0) k = i;
+        }
+        path.resize(k);
+        u = (k ? rn.to[path[k - 1]] : source);
+        continue;
+      }
+      unsigned& a = current[u];
+      for (; a < rn.head[u + 1]; ++a) {
+        if ((rn.residual[a] > 0) && (d[rn.to[a]] == d[u] + 1)) break;
+      }
+      if (a < rn.head[u + 1]) {
+        path.push_back(a);
+        u = rn.to[a];
+      } else {
+        // Dead end, vertex is removed from level graph.
+        d[u] = -1u;
+        if (path.empty()) break;
+        path.pop_back();
+        u = (path.empty() ? source : rn.to[path.back()]);
+        ++current[u];
+      }
+    }
   }
+  rn.Store(g);
   return g.Flow();
 }
 }  // namespace max_flow
@@ -0,0 +1,194 @@
+#pragma once
+
+#include "common/graph/flow/graph.h"
+#include "common/graph/flow/max_flow/residual_network.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace graph {
+namespace flow {
+namespace max_flow {
+namespace hidden {
+// Highest-label preflow push on residual network with
+//   global relabeling: exact distances to target by reverse BFS, repeated
+//     after O(V + E) relabel work,
+//   gap heuristic: if there are no vertices with height h, vertices above h
+//     could not reach target and are removed.
+// Phase 1 pushes excess to sink. Phase 2 runs the same procedure with
+// target source and returns excess that could not reach sink.
+template <class TFlow>
+class PushRelabel {
+ protected:
+  ResidualNetwork<TFlow>& rn;
+  unsigned n, target;
+  std::vector<TFlow> excess;
+  std::vector<unsigned> height, current, queue;
+  // Active vertices by height, single linked.
+  std::vector<unsigned> active_first, active_next;
+  // All vertices with height below n by height, double linked.
+  std::vector<unsigned> all_first, all_next, all_prev;
+  unsigned max_active, max_height, work;
+
+ public:
+  explicit PushRelabel(ResidualNetwork<TFlow>& _rn)
+      : rn(_rn),
+        n(rn.size),
+        excess(n, 0),
+        height(n),
+        current(n),
+        queue(n),
+        active_first(n + 1),
+        active_next(n),
+        all_first(n + 1),
+        all_next(n),
+        all_prev(n) {}
+
+  TFlow Run(unsigned source, unsigned sink) {
+    for (unsigned a = rn.head[source]; a < rn.head[source + 1]; ++a) {
+      const TFlow f = rn.residual[a];
+      if (f > 0) {
+        rn.Push(a, f);
+        excess[rn.to[a]] += f;
+        excess[source] -= f;
+      }
+    }
+    Discharge(sink, source);
+    Discharge(source, sink);
+    return excess[sink];
+  }
+
+ protected:
+  void AddActive(unsigned v) {
+    const unsigned h = height[v];
+    active_next[v] = active_first[h];
+    active_first[h] = v;
+    max_active = std::max(max_active, h);
+  }
+
+  void AddToHeight(unsigned v) {
+    const unsigned h = height[v];
+    all_prev[v] = -1u;
+    all_next[v] = all_first[h];
+    if (all_first[h] != -1u) all_prev[all_first[h]] = v;
+    all_first[h] = v;
+    max_height = std::max(max_height, h);
+  }
+
+  void RemoveFromHeight(unsigned v) {
+    if (all_prev[v] != -1u) {
+      all_next[all_prev[v]] = all_next[v];
+    } else {
+      all_first[height[v]] = all_next[v];
+    }
+    if (all_next[v] != -1u) all_prev[all_next[v]] = all_prev[v];
+  }
+
+  // Exact heights (distances to target in residual network), other
+  // vertices get height n.
+  void GlobalRelabel(unsigned other) {
+    std::fill(height.begin(), height.end(), n);
+    std::fill(active_first.begin(), active_first.end(), -1u);
+    std::fill(all_first.begin(), all_first.end(), -1u);
+    max_active = max_height = 0;
+    height[target] = 0;
+    queue[0] = target;
+    for (unsigned qb = 0, qe = 1; qb < qe; ++qb) {
+      const unsigned u = queue[qb], hu = height[u] + 1;
+      for (unsigned a = rn.head[u]; a < rn.head[u + 1]; ++a) {
+        const unsigned v = rn.to[a];
+        if ((height[v] == n) && (v != other) &&
+            (rn.residual[rn.reversed[a]] > 0)) {
+          height[v] = hu;
+          queue[qe++] = v;
+        }
+      }
+    }
+    for (unsigned v = 0; v < n; ++v) {
+      if ((height[v] >= n) || (v == target)) continue;
+      current[v] = rn.head[v];
+      AddToHeight(v);
+      if (excess[v] > 0) AddActive(v);
+    }
+    work = 0;
+  }
+
+  // Removes vertices with heights above h (they could not reach target).
+  void Gap(unsigned h) {
+    for (unsigned k = h + 1; k <= max_height; ++k) {
+      for (unsigned v = all_first[k]; v != -1u; v = all_next[v]) height[v] = n;
+      all_first[k] = -1u;
+    }
+    max_height = h - 1;
+  }
+
+  void Relabel(unsigned v) {
+    unsigned h = n;
+    for (unsigned a = rn.head[v]; a < rn.head[v + 1]; ++a) {
+      if (rn.residual[a] > 0) h = std::min(h, height[rn.to[a]] + 1);
+    }
+    work += rn.head[v + 1] - rn.head[v] + 12;
+    const unsigned old_height = height[v];
+    RemoveFromHeight(v);
+    if (all_first[old_height] == -1u) {
+      height[v] = n;
+      Gap(old_height);
+      return;
+    }
+    height[v] = h;
+    current[v] = rn.head[v];
+    if (h < n) AddToHeight(v);
+  }
+
+  void DischargeVertex(unsigned v) {
+    for (;;) {
+      for (unsigned& a = current[v]; a < rn.head[v + 1]; ++a) {
+        const unsigned u = rn.to[a];
+        if ((rn.residual[a] > 0) && (height[u] + 1 == height[v])) {
+          const TFlow f = std::min(excess[v], rn.residual[a]);
+          rn.Push(a, f);
+          if ((excess[u] == 0) && (u != target)) AddActive(u);
+          excess[u] += f;
+          excess[v] -= f;
+          if (excess[v] == 0) return;
+        }
+      }
+      Relabel(v);
+      if (height[v] >= n) return;
+    }
+  }
+
+  void Discharge(unsigned _target, unsigned other) {
+    target = _target;
+    GlobalRelabel(other);
+    const unsigned relabel_work = 6 * n + rn.head[n];
+    for (; max_active != -1u;) {
+      const unsigned v = active_first[max_active];
+      if (v == -1u) {
+        --max_active;
+        continue;
+      }
+      active_first[max_active] = active_next[v];
+      if (height[v] != max_active) continue;
+      DischargeVertex(v);
+      if (work > relabel_work) GlobalRelabel(other);
+    }
+  }
+};
+}  // namespace hidden
+
+// Highest-label push-relabel algorithm with global relabeling and gap
+// heuristics.
+// https://en.wikipedia.org/wiki/Push%E2%80%93relabel_maximum_flow_algorithm
+// Time: O(V^2 sqrt(E))
+template <class TEdge>
+inline typename TEdge::TFlow PushRelabel(Graph<TEdge>& g) {
+  using TFlow = typename TEdge::TFlow;
+  hidden::ResidualNetwork<TFlow> rn(g);
+  hidden::PushRelabel<TFlow>(rn).Run(g.Source(), g.Sink());
+  rn.Store(g);
+  return g.Flow();
+}
+}  // namespace max_flow
+}  // namespace flow
+}  // namespace graph
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "common/graph/flow/graph.h"
+
+#include <vector>
+
+namespace graph {
+namespace flow {
+namespace max_flow {
+namespace hidden {
+// Residual capacities of flow graph in CSR layout. Arcs of vertex u are
+// [head[u], head[u + 1]) in the same order as in Graph::Edges(u).
+template <class TFlow>
+class ResidualNetwork {
+ public:
+  unsigned size;
+  std::vector<unsigned> head, to, reversed;
+  std::vector<TFlow> residual;
+
+ public:
+  template <class TEdge>
+  explicit ResidualNetwork(const Graph<TEdge>& g) : size(g.Size()) {
+    head.resize(size + 1);
+    head[0] = 0;
+    for (unsigned u = 0; u < size; ++u)
+      head[u + 1] = head[u] + unsigned(g.Edges(u).size());
+    to.resize(head[size]);
+    reversed.resize(head[size]);
+    residual.resize(head[size]);
+    for (unsigned u = 0; u < size; ++u) {
+      unsigned a = head[u];
+      for (auto& e : g.Edges(u)) {
+        to[a] = e.to;
+        reversed[a] = head[e.to] + e.reversed_edge_index;
+        residual[a++] = e.max_flow - e.flow;
+      }
+    }
+  }
+
+  void Push(unsigned a, TFlow flow) {
+    residual[a] -= flow;
+    residual[reversed[a]] += flow;
+  }
+
+  // Copies flow back to graph edges.
+  template <class TEdge>
+  void Store(Graph<TEdge>& g) const {
+    for (unsigned u = 0; u < size; ++u) {
+      unsigned a = head[u];
+      for (auto& e : g.Edges(u)) e.flow = e.max_flow - residual[a++];
+    }
+  }
+};
+}  // namespace hidden
+}  // namespace max_flow
+}  // namespace flow
+}  // namespace graph
@@ -6,7 +6,11 @@
 #include <vector>
 
 // Time: O(V + E)
-inline std::vector<unsigned> ConnectedComponents(const UndirectedGraph& g) {
+// TGraph is UndirectedGraph or other undirected graph type with the same
+// Size() / Edges(u) interface (e.g. graph::GridGraph).
+template <class TGraph>
+inline std::vector<unsigned> ConnectedComponents(const TGraph& g) {
+  static_assert(!TGraph::directed_edges);
   const unsigned n = g.Size();
   unsigned l = -1;
   std::vector<unsigned> visited(n, 0), components(n);
@@ -7,9 +7,11 @@
 // Return distance (as number of edges) to each vertex from required vertex.
 // If some vertex is unreachable it returns -1 for it.
 // Time: O(V + E)
-template <bool directed_edges>
-inline std::vector<unsigned> DistanceFromSource(
-    const graph::Graph<directed_edges>& g, unsigned source) {
+// TGraph is graph::Graph or other type with Size() / Edges(u) interface
+// (e.g. graph::GridGraph).
+template <class TGraph>
+inline std::vector<unsigned> DistanceFromSource(const TGraph& g,
+                                                unsigned source) {
   const unsigned none = -1;
   std::vector<unsigned> d(g.Size(), none);
   d[source] = 0;
@@ -1,22 +1,23 @@
 #pragma once
 
-#include "common/heap/ukvm/dheap.h"
+#include "common/base.h"
+#include "common/heap/ukvm/dheap_inline.h"
 
 #include <vector>
 
 namespace graph {
 namespace distance {
-// Dijkstra's algorithm with d-ary heap.
+// Dijkstra's algorithm with d-ary heap (DHeapInline by default).
 // https://en.wikipedia.org/wiki/Dijkstra%27s_algorithm
 // All edges cost are non-negative.
+// THeap is any heap::ukvm heap, e.g. heap::ukvm::DHeap.
 // Time: O((V + E) log V)
-template <class TGraph, class TEdgeCostFunction, class TEdgeCost>
+template <class THeap, class TGraph, class TEdgeCostFunction, class TEdgeCost>
 inline std::vector<TEdgeCost> Dijkstra(const TGraph& g,
                                        const TEdgeCostFunction& f,
                                        unsigned source,
                                        const TEdgeCost& max_cost) {
-  heap::ukvm::DHeap<4u, TEdgeCost> q(std::vector<TEdgeCost>(g.Size(), max_cost),
-                                     true);
+  THeap q(std::vector<TEdgeCost>(g.Size(), max_cost), true);
   for (q.AddNewKey(source, TEdgeCost()); !q.Empty();) {
     unsigned u = q.ExtractKey();
     TEdgeCost ucost = q.Get(u);
@@ -24,5 +25,28 @@ inline std::vector<TEdgeCost> Dijkstra(const TGraph& g,
   }
   return q.GetValues();
 }
+
+// Same as above, but reuses empty heap q of size g.Size() (e.g. after the
+// previous run). Distances are q.Get(u).
+template <class THeap, class TGraph, class TEdgeCostFunction, class TEdgeCost>
+inline void Dijkstra(THeap& q, const TGraph& g, const TEdgeCostFunction& f,
+                     unsigned source, const TEdgeCost& max_cost) {
+  assert(q.Empty() && (q.UKeySize() == g.Size()));
+  for (unsigned u = 0; u < g.Size(); ++u) q.AddNewKey(u, max_cost, true);
+  for (q.AddNewKey(source, TEdgeCost()); !q.Empty();) {
+    unsigned u = q.ExtractKey();
+    TEdgeCost ucost = q.Get(u);
+    for (auto e : g.EdgesEI(u)) q.DecreaseValueIfLess(e.to, ucost + f(e.info));
+  }
+}
+
+template <class TGraph, class TEdgeCostFunction, class TEdgeCost>
+inline std::vector<TEdgeCost> Dijkstra(const TGraph& g,
+                                       const TEdgeCostFunction& f,
+                                       unsigned source,
+                                       const TEdgeCost& max_cost) {
+  return Dijkstra<heap::ukvm::DHeapInline<4u, TEdgeCost>>(g, f, source,
+                                                          max_cost);
+}
 }  // namespace distance
 }  // namespace graph
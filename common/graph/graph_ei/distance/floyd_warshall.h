@@ -1,33 +1,313 @@
 #pragma once
 
+#include "common/base.h"
+#include "common/thread_pool.h"
+
 #include <algorithm>
+#include <type_traits>
 #include <vector>
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define GRAPH_FW_USE_AVX2
+#endif
+
 namespace graph {
 namespace distance {
+namespace hidden {
+inline bool FloydWarshallUseAVX2() {
+#ifdef GRAPH_FW_USE_AVX2
+  static const bool avx2 = __builtin_cpu_supports("avx2");
+  return avx2;
+#else
+  return false;
+#endif
+}
+
+// Signed values are added as unsigned, the sum with max_cost could overflow
+// but it is discarded.
+template <class TEdgeCost>
+constexpr TEdgeCost AddWrap(const TEdgeCost& a, const TEdgeCost& b) {
+  if constexpr (std::is_integral_v<TEdgeCost> &&
+                std::is_signed_v<TEdgeCost>) {
+    using TU = std::make_unsigned_t<TEdgeCost>;
+    return TEdgeCost(TU(a) + TU(b));
+  } else {
+    return a + b;
+  }
+}
+
+// r[j] = min(r[j], dik + rk[j]) for rk[j] < max_cost.
+template <class TEdgeCost>
+inline void MinPlusRow(TEdgeCost* r, const TEdgeCost* rk, unsigned size,
+                       const TEdgeCost& dik, const TEdgeCost& max_cost) {
+  for (unsigned j = 0; j < size; ++j) {
+    const TEdgeCost x = rk[j], t = AddWrap(dik, x), y = r[j];
+    r[j] = ((x < max_cost) && (t < y)) ? t : y;
+  }
+}
+
+#ifdef GRAPH_FW_USE_AVX2
+#define GRAPH_FW_TARGET_AVX2 __attribute__((target("avx2")))
+
+template <class TEdgeCost>
+GRAPH_FW_TARGET_AVX2 inline __m256i Load(const TEdgeCost* p) {
+  return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+}
+
+template <class TEdgeCost>
+GRAPH_FW_TARGET_AVX2 inline __m256i Set1(TEdgeCost x) {
+  if constexpr (sizeof(TEdgeCost) == 8) {
+    return _mm256_set1_epi64x(int64_t(x));
+  } else {
+    return _mm256_set1_epi32(int(x));
+  }
+}
+
+// min(acc, vd + x) for lanes with x != max_cost (vm), values never exceed
+// max_cost. Unsigned 64-bit values are compared as signed after flipping the
+// top bit.
+template <class TEdgeCost>
+GRAPH_FW_TARGET_AVX2 inline __m256i Relax(__m256i acc, __m256i vd,
+                                          __m256i x, __m256i vm) {
+  constexpr bool is_signed = std::is_signed_v<TEdgeCost>;
+  if constexpr (sizeof(TEdgeCost) == 8) {
+    const __m256i t = _mm256_add_epi64(vd, x),
+                  skip = _mm256_cmpeq_epi64(x, vm);
+    __m256i less;
+    if constexpr (is_signed) {
+      less = _mm256_cmpgt_epi64(acc, t);
+    } else {
+      const __m256i flip = _mm256_set1_epi64x(int64_t(1ull << 63));
+      less = _mm256_cmpgt_epi64(_mm256_xor_si256(acc, flip),
+                                _mm256_xor_si256(t, flip));
+    }
+    return _mm256_blendv_epi8(acc, t, _mm256_andnot_si256(skip, less));
+  } else {
+    static_assert(sizeof(TEdgeCost) == 4);
+    const __m256i t = _mm256_add_epi32(vd, x),
+                  m = is_signed ? _mm256_min_epi32(acc, t)
+                                : _mm256_min_epu32(acc, t);
+    return _mm256_blendv_epi8(m, acc, _mm256_cmpeq_epi32(x, vm));
+  }
+}
+
+template <class TEdgeCost>
+GRAPH_FW_TARGET_AVX2 inline void MinPlusRowAVX2(TEdgeCost* r,
+                                                const TEdgeCost* rk,
+                                                unsigned size, TEdgeCost dik,
+                                                TEdgeCost max_cost) {
+  constexpr unsigned lanes = 32 / sizeof(TEdgeCost);
+  const __m256i vd = Set1(dik), vm = Set1(max_cost);
+  unsigned j = 0;
+  for (; j + lanes <= size; j += lanes) {
+    _mm256_storeu_si256(
+        reinterpret_cast<__m256i*>(r + j),
+        Relax<TEdgeCost>(Load(r + j), vd, Load(rk + j), vm));
+  }
+  MinPlusRow(r + j, rk + j, size - j, dik, max_cost);
+}
+
+// r[j] = min(r[j], a[k] + b[k * stride + j]) for j < vectors * lanes and
+// k < kb, r is kept in registers.
+template <unsigned vectors, class TEdgeCost>
+GRAPH_FW_TARGET_AVX2 inline void MinPlusBlockAVX2(TEdgeCost* r,
+                                                  const TEdgeCost* b,
+                                                  size_t stride,
+                                                  const TEdgeCost* a,
+                                                  unsigned kb,
+                                                  TEdgeCost max_cost) {
+  constexpr unsigned lanes = 32 / sizeof(TEdgeCost);
+  const __m256i vm = Set1(max_cost);
+  __m256i acc[vectors];
+#pragma GCC unroll 16
+  for (unsigned v = 0; v < vectors; ++v) acc[v] = Load(r + v * lanes);
+  for (unsigned k = 0; k < kb; ++k, b += stride) {
+    if (!(a[k] < max_cost)) continue;
+    const __m256i vd = Set1(a[k]);
+#pragma GCC unroll 16
+    for (unsigned v = 0; v < vectors; ++v)
+      acc[v] = Relax<TEdgeCost>(acc[v], vd, Load(b + v * lanes), vm);
+  }
+#pragma GCC unroll 16
+  for (unsigned v = 0; v < vectors; ++v)
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(r + v * lanes), acc[v]);
+}
+#endif
+
+// Floyd-Warshall on row-major n x n matrix split in square tiles. For each
+// diagonal tile k, the tile itself is updated first, then tiles in row and
+// column k, then all other tiles. Updates in each phase are independent and
+// run in parallel.
+template <class TEdgeCost>
+class FloydWarshallBlocked {
+ public:
+  static constexpr unsigned tile = 64;
+  static constexpr unsigned block_vectors = 8;
+
+  static constexpr bool simd =
+#ifdef GRAPH_FW_USE_AVX2
+      std::is_integral_v<TEdgeCost> &&
+      ((sizeof(TEdgeCost) == 4) || (sizeof(TEdgeCost) == 8));
+#else
+      false;
+#endif
+
+ protected:
+  TEdgeCost* d;
+  unsigned n, tiles;
+  TEdgeCost max_cost;
+
+ protected:
+  // Tile (bi, bj) relaxed via vertices from tile bk.
+  template <bool avx2>
+  void UpdateTileI(unsigned bi, unsigned bj, unsigned bk) {
+    const unsigned i0 = bi * tile, i1 = std::min(n, i0 + tile),
+                   j0 = bj * tile, j1 = std::min(n, j0 + tile),
+                   k0 = bk * tile, k1 = std::min(n, k0 + tile);
+    for (unsigned k = k0; k < k1; ++k) {
+      const TEdgeCost* rk = d + size_t(k) * n + j0;
+      for (unsigned i = i0; i < i1; ++i) {
+        TEdgeCost* r = d + size_t(i) * n;
+        const TEdgeCost dik = r[k];
+        if (!(dik < max_cost)) continue;
+#ifdef GRAPH_FW_USE_AVX2
+        if constexpr (avx2) {
+          MinPlusRowAVX2(r + j0, rk, j1 - j0, dik, max_cost);
+          continue;
+        }
+#endif
+        MinPlusRow(r + j0, rk, j1 - j0, dik, max_cost);
+      }
+    }
+  }
+
+  // Same as UpdateTileI for tile (bi, bj) outside of row and column bk, rows
+  // of the tile could be processed independently.
+  template <bool avx2>
+  void UpdateOuterTileI(unsigned bi, unsigned bj, unsigned bk) {
+    const unsigned i0 = bi * tile, i1 = std::min(n, i0 + tile),
+                   j0 = bj * tile, j1 = std::min(n, j0 + tile),
+                   k0 = bk * tile, k1 = std::min(n, k0 + tile);
+    const TEdgeCost* b = d + size_t(k0) * n;
+    for (unsigned i = i0; i < i1; ++i) {
+      TEdgeCost* r = d + size_t(i) * n;
+      unsigned j = j0;
+#ifdef GRAPH_FW_USE_AVX2
+      if constexpr (avx2) {
+        constexpr unsigned width = block_vectors * 32 / sizeof(TEdgeCost);
+        for (; j + width <= j1; j += width)
+          MinPlusBlockAVX2<block_vectors>(r + j, b + j, n, r + k0, k1 - k0,
+                                          max_cost);
+      }
+#endif
+      if (j == j1) continue;
+      for (unsigned k = k0; k < k1; ++k) {
+        if (r[k] < max_cost)
+          MinPlusRow(r + j, b + size_t(k - k0) * n + j, j1 - j, r[k],
+                     max_cost);
+      }
+    }
+  }
+
+#ifdef GRAPH_FW_USE_AVX2
+  GRAPH_FW_TARGET_AVX2 __attribute__((flatten)) void UpdateTileAVX2(
+      unsigned bi, unsigned bj, unsigned bk) {
+    if ((bi == bk) || (bj == bk))
+      UpdateTileI<true>(bi, bj, bk);
+    else
+      UpdateOuterTileI<true>(bi, bj, bk);
+  }
+#endif
+
+  void UpdateTile(unsigned bi, unsigned bj, unsigned bk) {
+#ifdef GRAPH_FW_USE_AVX2
+    if constexpr (simd) {
+      if (FloydWarshallUseAVX2()) return UpdateTileAVX2(bi, bj, bk);
+    }
+#endif
+    if ((bi == bk) || (bj == bk))
+      UpdateTileI<false>(bi, bj, bk);
+    else
+      UpdateOuterTileI<false>(bi, bj, bk);
+  }
+
+  template <class F>
+  static void ParallelFor(ThreadPool* pool, unsigned first, unsigned last,
+                          const F& f) {
+    if (pool) {
+      pool->ParallelFor(first, last, f, 1);
+    } else {
+      for (unsigned i = first; i < last; ++i) f(i);
+    }
+  }
+
+ public:
+  FloydWarshallBlocked(TEdgeCost* _d, unsigned _n, TEdgeCost _max_cost)
+      : d(_d), n(_n), tiles((_n + tile - 1) / tile), max_cost(_max_cost) {}
+
+  void Run(unsigned threads) {
+    ThreadPool* pool = ((threads > 1) && (tiles > 1))
+                           ? &ThreadPool::Shared(threads - 1)
+                           : nullptr;
+    for (unsigned bk = 0; bk < tiles; ++bk) {
+      UpdateTile(bk, bk, bk);
+      ParallelFor(pool, 0, 2 * tiles, [&](unsigned t) {
+        const unsigned b = t / 2;
+        if (b == bk) return;
+        if (t & 1)
+          UpdateTile(b, bk, bk);
+        else
+          UpdateTile(bk, b, bk);
+      });
+      ParallelFor(pool, 0, tiles, [&](unsigned bi) {
+        if (bi == bk) return;
+        for (unsigned bj = 0; bj < tiles; ++bj) {
+          if (bj != bk) UpdateTile(bi, bj, bk);
+        }
+      });
+    }
+  }
+};
+}  // namespace hidden
+
+// Floyd–Warshall algorithm on row-major n x n matrix d, d[i * n + j] is the
+// cost of edge i -> j or max_cost, d[i * n + i] should be 0. Values should
+// not exceed max_cost.
+// https://en.wikipedia.org/wiki/Floyd%E2%80%93Warshall_algorithm
+// Time: O(V^3)
+template <class TEdgeCost>
+inline void FloydWarshallMatrix(std::vector<TEdgeCost>& d, unsigned n,
+                                const TEdgeCost& max_cost,
+                                unsigned threads = 1) {
+  assert(d.size() == size_t(n) * n);
+  hidden::FloydWarshallBlocked<TEdgeCost>(d.data(), n, max_cost).Run(threads);
+}
+
 // Floyd–Warshall algorithm.
 // https://en.wikipedia.org/wiki/Floyd%E2%80%93Warshall_algorithm
 // Time: O(V^3)
 template <class TGraph, class TEdgeCostFunction, class TEdgeCost>
 inline std::vector<std::vector<TEdgeCost>> FloydWarshall(
-    const TGraph& g, const TEdgeCostFunction& f, const TEdgeCost& max_cost) {
+    const TGraph& g, const TEdgeCostFunction& f, const TEdgeCost& max_cost,
+    unsigned threads = 1) {
   unsigned gsize = g.Size();
-  std::vector<std::vector<TEdgeCost>> vd(
-      gsize, std::vector<TEdgeCost>(gsize, max_cost));
+  std::vector<TEdgeCost> d(size_t(gsize) * gsize, max_cost);
   for (unsigned u = 0; u < gsize; ++u) {
-    for (auto e : g.EdgesEI(u)) vd[u][e.to] = std::min(vd[u][e.to], f(e.info));
-    vd[u][u] = TEdgeCost();
-  }
-  for (unsigned k = 0; k < gsize; ++k) {
-    for (unsigned i = 0; i < gsize; ++i) {
-      if (!(vd[i][k] < max_cost)) continue;
-      for (unsigned j = 0; j < gsize; ++j) {
-        if ((vd[k][j] < max_cost) && (vd[i][k] + vd[k][j] < vd[i][j]))
-          vd[i][j] = vd[i][k] + vd[k][j];
-      }
-    }
+    TEdgeCost* du = d.data() + size_t(u) * gsize;
+    for (auto e : g.EdgesEI(u)) du[e.to] = std::min(du[e.to], f(e.info));
+    du[u] = TEdgeCost();
+  }
+  FloydWarshallMatrix(d, gsize, max_cost, threads);
+  std::vector<std::vector<TEdgeCost>> vd(gsize);
+  for (unsigned u = 0; u < gsize; ++u) {
+    auto it = d.begin() + size_t(u) * gsize;
+    vd[u].assign(it, it + gsize);
   }
   return vd;
 }
 }  // namespace distance
 }  // namespace graph
+
+#undef GRAPH_FW_TARGET_AVX2
+#undef GRAPH_FW_USE_AVX2
@@ -1,9 +1,12 @@
 #pragma once
 
+#include "common/base.h"
 #include "common/graph/edge.h"
 #include "common/graph/graph_ei.h"
 #include "common/graph/graph_ei/distance/dijkstra.h"
 #include "common/graph/graph_ei/edge_cost_proxy.h"
+#include "common/heap/ukvm/dheap_inline.h"
+#include "common/thread_pool.h"
 #include "common/vector/min.h"
 
 #include <algorithm>
@@ -13,11 +16,14 @@ namespace graph {
 namespace distance {
 // Johnson algorithm.
 // https://en.wikipedia.org/wiki/Johnson%27s_algorithm
+// Dijkstra runs for different sources are split in chunks between threads,
+// each chunk reuses one heap.
 // Time: O(V (V + E) log(V))
 template <class TGraph, class TEdgeCostFunction, class TEdgeCost>
 inline std::vector<std::vector<TEdgeCost>> Johnson(const TGraph& g,
                                                    const TEdgeCostFunction& f,
-                                                   const TEdgeCost& max_cost) {
+                                                   const TEdgeCost& max_cost,
+                                                   unsigned threads = 1) {
   unsigned gsize = g.Size();
   // Bellman-Ford
   std::vector<TEdgeCost> vh(gsize, TEdgeCost());
@@ -44,11 +50,27 @@ inline std::vector<std::vector<TEdgeCost>> Johnson(const TGraph& g,
   }
   EdgeCostProxy<TEdgeCost> fp;
   std::vector<std::vector<TEdgeCost>> vd(gsize);
-  for (unsigned u = 0; u < gsize; ++u) {
-    auto vu = distance::Dijkstra(g2, fp, u, max_cost - adjust);
-    for (unsigned v = 0; v < gsize; ++v)
-      vu[v] = std::min(vu[v] + vh[v] - vh[u], max_cost);
-    vd[u] = vu;
+  auto run = [&](unsigned first, unsigned last) {
+    heap::ukvm::DHeapInline<4u, TEdgeCost> q(gsize);
+    for (unsigned u = first; u < last; ++u) {
+      distance::Dijkstra(q, g2, fp, u, max_cost - adjust);
+      auto& vu = vd[u];
+      vu.resize(gsize);
+      for (unsigned v = 0; v < gsize; ++v)
+        vu[v] = std::min(q.Get(v) + vh[v] - vh[u], max_cost);
+    }
+  };
+  if ((threads > 1) && (gsize > 1)) {
+    const unsigned chunks = std::min(gsize, 4 * threads);
+    ThreadPool::Shared(threads - 1).ParallelFor(
+        0, chunks,
+        [&](size_t c) {
+          run(unsigned(uint64_t(gsize) * c / chunks),
+              unsigned(uint64_t(gsize) * (c + 1) / chunks));
+        },
+        1);
+  } else {
+    run(0, gsize);
   }
   return vd;
 }
@@ -1,22 +1,36 @@
 #pragma once
 
 #include "common/graph/graph_ei.h"
+#include "common/graph/graph_ei/distance/floyd_warshall.h"
 #include "common/graph/graph_ei/distance/johnson.h"
 #include "common/graph/graph_ei/edge_cost_proxy.h"
 
 #include <vector>
 
 namespace graph {
+// Floyd-Warshall for dense graphs (average degree at least V / 8), Johnson
+// otherwise. Returns empty vector if graph has negative cycle.
 template <class TGraph, class TEdgeCostFunction, class TEdgeCost>
 inline std::vector<std::vector<TEdgeCost>> DistanceAllPairs(
-    const TGraph& g, const TEdgeCostFunction& f, const TEdgeCost& max_cost) {
-  return distance::Johnson(g, f, max_cost);
+    const TGraph& g, const TEdgeCostFunction& f, const TEdgeCost& max_cost,
+    unsigned threads = 1) {
+  const unsigned gsize = g.Size();
+  uint64_t edges = 0;
+  for (unsigned u = 0; u < gsize; ++u) edges += g.Edges(u).size();
+  if (8 * edges < uint64_t(gsize) * gsize)
+    return distance::Johnson(g, f, max_cost, threads);
+  auto vd = distance::FloydWarshall(g, f, max_cost, threads);
+  for (unsigned u = 0; u < gsize; ++u) {
+    if (vd[u][u] < TEdgeCost()) return {};  // Negative cycle
+  }
+  return vd;
 }
 }  // namespace graph
 
 template <class TEdgeInfo, bool directed_edges>
 inline std::vector<std::vector<TEdgeInfo>> DistanceAllPairs(
-    const graph::GraphEI<TEdgeInfo, directed_edges>& g, TEdgeInfo max_cost) {
+    const graph::GraphEI<TEdgeInfo, directed_edges>& g, TEdgeInfo max_cost,
+    unsigned threads = 1) {
   return graph::DistanceAllPairs(g, graph::EdgeCostProxy<TEdgeInfo>(),
-                                 max_cost);
+                                 max_cost, threads);
 }
@@ -0,0 +1,131 @@
+#pragma once
+
+#include "common/base.h"
+#include "common/graph/edge.h"
+
+#include <vector>
+
+namespace graph {
+// Small fixed capacity list returned by GridGraph::Edges and EdgesEI.
+template <class T, unsigned capacity>
+class GridEdgesList {
+ protected:
+  T data[capacity] = {};
+  unsigned nsize = 0;
+
+ public:
+  constexpr void PushBack(const T& x) { data[nsize++] = x; }
+
+  constexpr unsigned Size() const { return nsize; }
+  constexpr size_t size() const { return nsize; }
+  constexpr bool empty() const { return nsize == 0; }
+
+  constexpr const T& operator[](unsigned i) const { return data[i]; }
+
+  constexpr const T* begin() const { return data; }
+  constexpr const T* end() const { return data + nsize; }
+};
+
+// Implicit dx x dy grid graph, vertex (x, y) has index y * dx + x (same as
+// NeighborsDGraph*). Neighbors are computed on the fly in the same order as
+// I2Neighbors*: directions = 2 (right, up), 3 (right, diagonal, up), 4 or 8.
+// Optional blocked cells have no edges. Edge info is the weight of the
+// target cell (1 if weights are not set).
+// Memory: O(1) per cell (only blocked mask and weights if used).
+template <unsigned directions, class TTEdgeInfo = unsigned>
+class GridGraph {
+ public:
+  static_assert((directions == 2) || (directions == 3) || (directions == 4) ||
+                (directions == 8));
+  static const bool directed_edges = (directions < 4);
+  using TEdgeInfo = TTEdgeInfo;
+  using TEdge = Edge<TEdgeInfo>;
+  using TVertices = GridEdgesList<unsigned, directions>;
+  using TEdges = GridEdgesList<TEdge, directions>;
+  using TSelf = GridGraph<directions, TEdgeInfo>;
+
+ protected:
+  unsigned dx, dy;
+  std::vector<uint8_t> blocked;
+  std::vector<TEdgeInfo> weights;
+
+ protected:
+  // Calls f(to) for each neighbor of u inside grid and not blocked.
+  template <class TFunction>
+  constexpr void ForEachNeighbor(unsigned u, TFunction f) const {
+    if (Blocked(u)) return;
+    const unsigned x = u % dx, y = u / dx;
+    const bool r = (x + 1 < dx), l = (x > 0), t = (y + 1 < dy), b = (y > 0);
+    auto add = [&](bool inside, unsigned v) {
+      if (inside && !Blocked(v)) f(v);
+    };
+    add(r, u + 1);
+    if constexpr (directions == 2) {
+      add(t, u + dx);
+    } else if constexpr (directions == 3) {
+      add(r && t, u + dx + 1);
+      add(t, u + dx);
+    } else if constexpr (directions == 4) {
+      add(t, u + dx);
+      add(l, u - 1);
+      add(b, u - dx);
+    } else {
+      add(r && t, u + dx + 1);
+      add(t, u + dx);
+      add(l && t, u + dx - 1);
+      add(l, u - 1);
+      add(l && b, u - dx - 1);
+      add(b, u - dx);
+      add(r && b, u - dx + 1);
+    }
+  }
+
+ public:
+  constexpr GridGraph(unsigned _dx, unsigned _dy) : dx(_dx), dy(_dy) {}
+
+  constexpr unsigned Size() const { return dx * dy; }
+  constexpr unsigned SizeX() const { return dx; }
+  constexpr unsigned SizeY() const { return dy; }
+
+  constexpr unsigned Index(unsigned x, unsigned y) const { return y * dx + x; }
+
+  constexpr bool Blocked(unsigned u) const {
+    return !blocked.empty() && blocked[u];
+  }
+
+  constexpr void SetBlocked(unsigned u, bool value = true) {
+    if (blocked.empty()) {
+      if (!value) return;
+      blocked.resize(Size(), 0);
+    }
+    blocked[u] = value;
+  }
+
+  constexpr void SetBlocked(const std::vector<uint8_t>& mask) {
+    assert(mask.empty() || (mask.size() == Size()));
+    blocked = mask;
+  }
+
+  constexpr TEdgeInfo Weight(unsigned u) const {
+    return weights.empty() ? TEdgeInfo(1) : weights[u];
+  }
+
+  constexpr void SetWeights(const std::vector<TEdgeInfo>& _weights) {
+    assert(_weights.empty() || (_weights.size() == Size()));
+    weights = _weights;
+  }
+
+  constexpr TVertices Edges(unsigned from) const {
+    TVertices v;
+    ForEachNeighbor(from, [&](unsigned to) { v.PushBack(to); });
+    return v;
+  }
+
+  constexpr TEdges EdgesEI(unsigned from) const {
+    TEdges v;
+    ForEachNeighbor(from,
+                    [&](unsigned to) { v.PushBack(TEdge{to, Weight(to)}); });
+    return v;
+  }
+};
+}  // namespace graph
@@ -0,0 +1,336 @@
+#pragma once
+
+#include "common/base.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace nhash {
+namespace hidden {
+
+/**
+ * @brief Open addressing hash table with Swiss table style control bytes.
+ *
+ * Slots are split in aligned groups of 8. Control byte of a slot is empty,
+ * deleted or 7 bits of the hash of the stored key, whole group is matched
+ * with 64-bit word operations. Groups are visited in triangular order, the
+ * table is rehashed when the number of used and deleted slots reaches 7/8 of
+ * the capacity. Entries are constructed in place in slots and destroyed on
+ * erase and clear. Insert may invalidate iterators and references, clear
+ * keeps allocated memory.
+ *
+ * Lookups are templated on key type (heterogeneous lookup), any K accepted by
+ * THash and comparable with TKey can be used.
+ *
+ * @tparam TKey The type of keys.
+ * @tparam TEntry The type of stored entries, TKey or
+ *   std::pair<const TKey, TValue>.
+ * @tparam THash The hash functor.
+ */
+template <class TKey, class TEntry, class THash>
+class FlatHashTable {
+ public:
+  static constexpr bool is_set = std::is_same_v<TKey, TEntry>;
+  static constexpr size_t npos = size_t(-1);
+
+ protected:
+  static_assert(std::endian::native == std::endian::little);
+
+  static constexpr size_t group_size = 8;
+  static constexpr size_t min_capacity = 16;
+  static constexpr uint8_t ctrl_empty = 0x80;
+  static constexpr uint8_t ctrl_deleted = 0xFE;
+  static constexpr uint64_t lsbs = 0x0101010101010101ull;
+  static constexpr uint64_t msbs = 0x8080808080808080ull;
+
+  union Slot {
+    TEntry entry;
+
+    Slot() {}
+    ~Slot() {}
+  };
+
+  template <bool is_const>
+  class Iterator {
+   public:
+    using TTable = std::conditional_t<is_const, const FlatHashTable,
+                                      FlatHashTable>;
+    using TReference =
+        std::conditional_t<is_const || is_set, const TEntry&, TEntry&>;
+
+   protected:
+    TTable* table;
+    size_t index;
+
+    friend class FlatHashTable;
+
+    void SkipEmpty() {
+      for (; (index < table->ctrl.size()) && (table->ctrl[index] & 0x80);)
+        ++index;
+    }
+
+   public:
+    Iterator() : table(nullptr), index(0) {}
+
+    Iterator(TTable* _table, size_t _index) : table(_table), index(_index) {
+      SkipEmpty();
+    }
+
+    operator Iterator<true>() const { return {table, index}; }
+
+    TReference operator*() const { return table->slots[index].entry; }
+    auto operator->() const { return &**this; }
+
+    Iterator& operator++() {
+      ++index;
+      SkipEmpty();
+      return *this;
+    }
+
+    bool operator==(const Iterator& r) const { return index == r.index; }
+    bool operator!=(const Iterator& r) const { return index != r.index; }
+  };
+
+ public:
+  using value_type = TEntry;
+  using iterator = Iterator<false>;
+  using const_iterator = Iterator<true>;
+
+ protected:
+  std::vector<uint8_t> ctrl;
+  std::unique_ptr<Slot[]> slots;
+  size_t used, growth_left;
+  size_t group_mask;
+  unsigned shift;
+  THash hash;
+
+ protected:
+  static const TKey& Key(const TEntry& entry) {
+    if constexpr (is_set) {
+      return entry;
+    } else {
+      return entry.first;
+    }
+  }
+
+  static constexpr size_t MaxLoad(size_t capacity) {
+    return capacity - capacity / group_size;
+  }
+
+  // Fibonacci hashing on top of THash, so identity hashes are also fine.
+  template <class K>
+  uint64_t HashKey(const K& key) const {
+    return uint64_t(hash(key)) * 0x9E3779B97F4A7C15ull;
+  }
+
+  uint64_t LoadGroup(size_t group) const {
+    uint64_t w;
+    std::memcpy(&w, ctrl.data() + group * group_size, sizeof(w));
+    return w;
+  }
+
+  // May have false positives above a matched byte, keys are compared anyway.
+  static uint64_t MatchByte(uint64_t w, uint8_t b) {
+    const uint64_t x = w ^ (lsbs * b);
+    return (x - lsbs) & ~x & msbs;
+  }
+
+  static uint64_t MatchEmpty(uint64_t w) { return w & ~(w << 6) & msbs; }
+
+  static uint64_t MatchEmptyOrDeleted(uint64_t w) { return w & msbs; }
+
+  static size_t FirstIndex(size_t group, uint64_t mask) {
+    return group * group_size + unsigned(std::countr_zero(mask)) / 8;
+  }
+
+  // First empty or deleted slot for hash h.
+  size_t FindFreeSlot(uint64_t h) const {
+    for (size_t g = h >> shift, step = 0;; g = (g + ++step) & group_mask) {
+      const uint64_t m = MatchEmptyOrDeleted(LoadGroup(g));
+      if (m) return FirstIndex(g, m);
+    }
+  }
+
+  void Rehash(size_t capacity) {
+    assert(std::has_single_bit(capacity) && (capacity >= min_capacity));
+    std::vector<uint8_t> old_ctrl(capacity, ctrl_empty);
+    auto old_slots = std::make_unique<Slot[]>(capacity);
+    old_ctrl.swap(ctrl);
+    old_slots.swap(slots);
+    group_mask = capacity / group_size - 1;
+    shift = 64 - unsigned(std::countr_zero(capacity / group_size));
+    growth_left = MaxLoad(capacity) - used;
+    for (size_t i = 0; i < old_ctrl.size(); ++i) {
+      if (old_ctrl[i] & 0x80) continue;
+      TEntry& entry = old_slots[i].entry;
+      const uint64_t h = HashKey(Key(entry));
+      const size_t j = FindFreeSlot(h);
+      ctrl[j] = uint8_t(h & 0x7F);
+      std::construct_at(&slots[j].entry, std::move(entry));
+      std::destroy_at(&entry);
+    }
+  }
+
+  // Rehash in place if at least half of occupied slots are deleted.
+  void Grow() {
+    const size_t capacity = ctrl.size();
+    if (capacity == 0) {
+      Rehash(min_capacity);
+    } else {
+      Rehash((2 * used <= MaxLoad(capacity)) ? capacity : 2 * capacity);
+    }
+  }
+
+  template <class K>
+  size_t FindIndex(const K& key) const {
+    if (used == 0) return npos;
+    const uint64_t h = HashKey(key);
+    const uint8_t h2 = uint8_t(h & 0x7F);
+    for (size_t g = h >> shift, step = 0;; g = (g + ++step) & group_mask) {
+      const uint64_t w = LoadGroup(g);
+      for (uint64_t m = MatchByte(w, h2); m; m &= m - 1) {
+        const size_t i = FirstIndex(g, m);
+        if (Key(slots[i].entry) == key) return i;
+      }
+      if (MatchEmpty(w)) return npos;
+    }
+  }
+
+  // Returns index of key and true if a new entry was constructed from args.
+  template <class K, class... Args>
+  std::pair<size_t, bool> FindOrEmplace(const K& key, Args&&... args) {
+    const size_t index = FindIndex(key);
+    if (index != npos) return {index, false};
+    if (growth_left == 0) Grow();
+    const uint64_t h = HashKey(key);
+    const size_t i = FindFreeSlot(h);
+    std::construct_at(&slots[i].entry, std::forward<Args>(args)...);
+    if (ctrl[i] == ctrl_empty) --growth_left;
+    ctrl[i] = uint8_t(h & 0x7F);
+    ++used;
+    return {i, true};
+  }
+
+  void EraseIndex(size_t i) {
+    assert(!(ctrl[i] & 0x80));
+    --used;
+    std::destroy_at(&slots[i].entry);
+    // Group that still has an empty slot was never full, so no probe
+    // sequence continues past it and slot can be marked as empty.
+    if (MatchEmpty(LoadGroup(i / group_size))) {
+      ctrl[i] = ctrl_empty;
+      ++growth_left;
+    } else {
+      ctrl[i] = ctrl_deleted;
+    }
+  }
+
+  void Swap(FlatHashTable& r) {
+    ctrl.swap(r.ctrl);
+    slots.swap(r.slots);
+    std::swap(used, r.used);
+    std::swap(growth_left, r.growth_left);
+    std::swap(group_mask, r.group_mask);
+    std::swap(shift, r.shift);
+    std::swap(hash, r.hash);
+  }
+
+ public:
+  FlatHashTable() : used(0), growth_left(0), group_mask(0), shift(64) {}
+
+  FlatHashTable(const FlatHashTable& r)
+      : ctrl(r.ctrl.size(), ctrl_empty),
+        slots(std::make_unique<Slot[]>(r.ctrl.size())),
+        used(r.used),
+        growth_left(r.growth_left),
+        group_mask(r.group_mask),
+        shift(r.shift),
+        hash(r.hash) {
+    for (size_t i = 0; i < ctrl.size(); ++i) {
+      if (r.ctrl[i] & 0x80) continue;
+      std::construct_at(&slots[i].entry, r.slots[i].entry);
+      ctrl[i] = r.ctrl[i];
+    }
+    // Deleted slots are kept, so probe sequences are the same.
+    for (size_t i = 0; i < ctrl.size(); ++i) {
+      if (r.ctrl[i] == ctrl_deleted) ctrl[i] = ctrl_deleted;
+    }
+  }
+
+  FlatHashTable(FlatHashTable&& r) noexcept : FlatHashTable() { Swap(r); }
+
+  FlatHashTable& operator=(FlatHashTable r) noexcept {
+    Swap(r);
+    return *this;
+  }
+
+  ~FlatHashTable() { clear(); }
+
+  size_t size() const { return used; }
+  bool empty() const { return used == 0; }
+  size_t capacity() const { return ctrl.size(); }
+
+  void clear() {
+    for (size_t i = 0; i < ctrl.size(); ++i) {
+      if (ctrl[i] != ctrl_empty) {
+        if (!(ctrl[i] & 0x80)) std::destroy_at(&slots[i].entry);
+        ctrl[i] = ctrl_empty;
+      }
+    }
+    used = 0;
+    growth_left = MaxLoad(ctrl.size());
+  }
+
+  void reserve(size_t count) {
+    if (count <= MaxLoad(ctrl.size())) return;
+    size_t capacity = std::max(min_capacity, ctrl.size());
+    for (; MaxLoad(capacity) < count;) capacity *= 2;
+    Rehash(capacity);
+  }
+
+  iterator begin() { return {this, 0}; }
+  const_iterator begin() const { return {this, 0}; }
+  iterator end() { return {this, ctrl.size()}; }
+  const_iterator end() const { return {this, ctrl.size()}; }
+
+  template <class K>
+  iterator find(const K& key) {
+    const size_t i = FindIndex(key);
+    return (i == npos) ? end() : iterator(this, i);
+  }
+
+  template <class K>
+  const_iterator find(const K& key) const {
+    const size_t i = FindIndex(key);
+    return (i == npos) ? end() : const_iterator(this, i);
+  }
+
+  template <class K>
+  bool contains(const K& key) const {
+    return FindIndex(key) != npos;
+  }
+
+  template <class K>
+  size_t count(const K& key) const {
+    return contains(key) ? 1 : 0;
+  }
+
+  template <class K>
+  size_t erase(const K& key) {
+    const size_t i = FindIndex(key);
+    if (i == npos) return 0;
+    EraseIndex(i);
+    return 1;
+  }
+
+  void erase(const_iterator it) { EraseIndex(it.index); }
+  void erase(iterator it) { EraseIndex(it.index); }
+};
+
+}  // namespace hidden
+}  // namespace nhash
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "common/base.h"
+#include "common/hash.h"
+#include "common/hash/flat_hash_table.h"
+
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+namespace nhash {
+
+/**
+ * @brief Open addressing hash map, see hidden::FlatHashTable.
+ *
+ * Replacement for std::unordered_map without node allocations. Entries are
+ * stored as std::pair<const TKey, TValue>, same as in std::unordered_map.
+ * at throws std::out_of_range if key is missing.
+ *
+ * @tparam TKey The type of keys.
+ * @tparam TValue The type of mapped values.
+ * @tparam THash The hash functor.
+ */
+template <class TKey, class TValue, class THash = DHash<TKey>>
+class FlatMap : public hidden::FlatHashTable<
+                    TKey, std::pair<const TKey, TValue>, THash> {
+ public:
+  using TBase =
+      hidden::FlatHashTable<TKey, std::pair<const TKey, TValue>, THash>;
+  using iterator = typename TBase::iterator;
+
+ protected:
+  template <class K>
+  size_t FindIndexOrThrow(const K& key) const {
+    const size_t i = this->FindIndex(key);
+    if (i == TBase::npos) throw std::out_of_range("FlatMap::at");
+    return i;
+  }
+
+ public:
+  TValue& operator[](const TKey& key) {
+    const auto [i, inserted] = this->FindOrEmplace(
+        key, std::piecewise_construct, std::forward_as_tuple(key),
+        std::tuple<>());
+    return this->slots[i].entry.second;
+  }
+
+  template <class K>
+  TValue& at(const K& key) {
+    return this->slots[FindIndexOrThrow(key)].entry.second;
+  }
+
+  template <class K>
+  const TValue& at(const K& key) const {
+    return this->slots[FindIndexOrThrow(key)].entry.second;
+  }
+
+  std::pair<iterator, bool> insert(
+      const std::pair<const TKey, TValue>& entry) {
+    const auto [i, inserted] = this->FindOrEmplace(entry.first, entry);
+    return {iterator(this, i), inserted};
+  }
+
+  template <class V>
+  std::pair<iterator, bool> emplace(const TKey& key, V&& value) {
+    const auto [i, inserted] =
+        this->FindOrEmplace(key, key, std::forward<V>(value));
+    return {iterator(this, i), inserted};
+  }
+};
+
+}  // namespace nhash
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "common/base.h"
+#include "common/hash.h"
+#include "common/hash/flat_hash_table.h"
+
+#include <utility>
+
+namespace nhash {
+
+/**
+ * @brief Open addressing hash set, see hidden::FlatHashTable.
+ *
+ * Replacement for std::unordered_set without node allocations.
+ *
+ * @tparam TKey The type of keys.
+ * @tparam THash The hash functor.
+ */
+template <class TKey, class THash = DHash<TKey>>
+class FlatSet : public hidden::FlatHashTable<TKey, TKey, THash> {
+ public:
+  using TBase = hidden::FlatHashTable<TKey, TKey, THash>;
+  using iterator = typename TBase::iterator;
+
+ public:
+  std::pair<iterator, bool> insert(const TKey& key) {
+    const auto [i, inserted] = this->FindOrEmplace(key, key);
+    return {iterator(this, i), inserted};
+  }
+};
+
+}  // namespace nhash
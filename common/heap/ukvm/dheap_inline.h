@@ -0,0 +1,370 @@
+#pragma once
+
+#include "common/base.h"
+#include "common/heap/ukvm/data.h"
+
+#include <algorithm>
+#include <bit>
+#include <functional>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HEAP_UKVM_USE_AVX2
+#endif
+
+namespace heap {
+namespace ukvm {
+namespace hidden {
+template <class TValue>
+struct DHeapInlineNode {
+  TValue value;
+  unsigned key;
+};
+
+inline bool DHeapUseAVX2() {
+#ifdef HEAP_UKVM_USE_AVX2
+  static const bool avx2 = __builtin_cpu_supports("avx2");
+  return avx2;
+#else
+  return false;
+#endif
+}
+
+#ifdef HEAP_UKVM_USE_AVX2
+#define HEAP_UKVM_TARGET_AVX2 __attribute__((target("avx2")))
+
+template <class TNode>
+HEAP_UKVM_TARGET_AVX2 inline __m256i Load(const TNode* p) {
+  return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+}
+
+HEAP_UKVM_TARGET_AVX2 inline __m256i Min64(__m256i x, __m256i y) {
+  return _mm256_blendv_epi8(x, y, _mm256_cmpgt_epi64(x, y));
+}
+
+template <bool is_signed>
+HEAP_UKVM_TARGET_AVX2 inline __m256i Min32(__m256i x, __m256i y) {
+  if constexpr (is_signed) {
+    return _mm256_min_epi32(x, y);
+  } else {
+    return _mm256_min_epu32(x, y);
+  }
+}
+
+// Index of a minimum value among d nodes.
+template <unsigned d, class TValue>
+HEAP_UKVM_TARGET_AVX2 inline unsigned MinIndexAVX2(
+    const DHeapInlineNode<TValue>* p) {
+  static_assert(sizeof(DHeapInlineNode<TValue>) == 2 * sizeof(TValue));
+  static_assert((d == 4) || (d == 8));
+  constexpr bool is_signed = std::is_signed_v<TValue>;
+  if constexpr (sizeof(TValue) == 8) {
+    // Two nodes per load, unpack gives values of nodes 0, 2, 1, 3. Unsigned
+    // values are compared as signed after flipping the top bit.
+    const __m256i flip = is_signed ? _mm256_setzero_si256()
+                                   : _mm256_set1_epi64x(int64_t(1ull << 63));
+    const __m256i a = _mm256_xor_si256(
+        _mm256_unpacklo_epi64(Load(p), Load(p + 2)), flip);
+    const __m256i b =
+        (d == 8) ? _mm256_xor_si256(
+                       _mm256_unpacklo_epi64(Load(p + 4), Load(p + 6)), flip)
+                 : a;
+    __m256i m = Min64(a, b);
+    m = Min64(m, _mm256_permute4x64_epi64(m, 0x4E));
+    m = Min64(m, _mm256_permute4x64_epi64(m, 0xB1));
+    unsigned mask = unsigned(
+        _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(a, m))));
+    if constexpr (d == 8) {
+      mask |= unsigned(_mm256_movemask_pd(
+                  _mm256_castsi256_pd(_mm256_cmpeq_epi64(b, m))))
+              << 4;
+    }
+    const unsigned i = unsigned(std::countr_zero(mask));
+    return (i & 4) + ((i & 1) << 1) + ((i & 2) >> 1);
+  } else {
+    // Four nodes per load, keys are replaced with max value.
+    static_assert(sizeof(TValue) == 4);
+    const __m256i vmax =
+        _mm256_set1_epi32(int(std::numeric_limits<TValue>::max()));
+    const __m256i a = _mm256_blend_epi32(Load(p), vmax, 0xAA);
+    const __m256i b =
+        (d == 8) ? _mm256_blend_epi32(Load(p + 4), vmax, 0xAA) : a;
+    __m256i m = Min32<is_signed>(a, b);
+    m = Min32<is_signed>(m, _mm256_permute2x128_si256(m, m, 1));
+    m = Min32<is_signed>(m, _mm256_shuffle_epi32(m, 0x4E));
+    unsigned mask = unsigned(
+        _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(a, m))));
+    if constexpr (d == 8) {
+      mask |= unsigned(_mm256_movemask_ps(
+                  _mm256_castsi256_ps(_mm256_cmpeq_epi32(b, m))))
+              << 8;
+    }
+    return unsigned(std::countr_zero(mask & 0x5555u)) / 2;
+  }
+}
+#endif
+}  // namespace hidden
+
+// Same interface as DHeap, but (value, key) pairs are stored inline in the
+// heap array and heap positions are in a separate key map, so sift steps do
+// not dereference into the key map. Position pos is stored at index
+// pos + d - 1, children of pos are at [d * (pos + 1), d * (pos + 2)) and each
+// group of children starts at a 64-byte boundary (for 8-byte values and d = 4
+// or 4-byte values and d = 8 a group is exactly one cache line). For d in
+// {4, 8}, integral values and std::less min child is selected with AVX2 if
+// CPU supports it; slots after the last element keep the max value, so the
+// whole group is compared.
+// Memory  -- O(N)
+// Add     -- O(log N / log d)
+// DecV    -- O(log N / log d)
+// IncV    -- O(d log N / log d)
+// Top     -- O(1)
+// Pop     -- O(d log N / log d)
+// Init    -- O(N)
+template <unsigned d, class TTValue, class TTCompare = std::less<TTValue>>
+class DHeapInline {
+ public:
+  static constexpr unsigned not_in_heap = unsigned(-1);
+
+  using TValue = TTValue;
+  using TCompare = TTCompare;
+  using TData = Data<TValue>;
+  using TSelf = DHeapInline<d, TValue, TCompare>;
+  using TNode = hidden::DHeapInlineNode<TValue>;
+
+  struct TPositionValue {
+    unsigned heap_position;
+    TValue value;
+  };
+
+  static constexpr bool simd =
+#ifdef HEAP_UKVM_USE_AVX2
+      ((d == 4) || (d == 8)) && std::is_integral_v<TValue> &&
+      ((sizeof(TValue) == 4) || (sizeof(TValue) == 8)) &&
+      std::is_same_v<TCompare, std::less<TValue>>;
+#else
+      false;
+#endif
+
+ protected:
+  static constexpr unsigned shift = d - 1;
+  static constexpr unsigned align = 64 / sizeof(TNode);
+
+  TCompare compare;
+  TNode empty_node;
+  unsigned size;
+  bool use_simd;
+  size_t nshift;
+  std::vector<TNode> nodes;
+  std::vector<TPositionValue> key_map;
+
+ public:
+  explicit DHeapInline(unsigned ukey_size)
+      : size(0), use_simd(simd && hidden::DHeapUseAVX2()) {
+    empty_node.key = not_in_heap;
+    if constexpr (std::numeric_limits<TValue>::is_specialized)
+      empty_node.value = std::numeric_limits<TValue>::max();
+    else
+      empty_node.value = TValue();
+    nodes.resize(size_t(ukey_size) + 2 * d + align, empty_node);
+    // Align groups of children to cache lines. Copies may lose alignment,
+    // so SIMD loads are unaligned.
+    size_t offset = 0;
+    for (auto p = reinterpret_cast<uintptr_t>(nodes.data() + d);
+         (64 % sizeof(TNode) == 0) && (offset < align) &&
+         ((p + offset * sizeof(TNode)) % 64);)
+      ++offset;
+    nshift = offset + shift;
+    key_map.resize(ukey_size, {not_in_heap, TValue()});
+  }
+
+  DHeapInline(const std::vector<TValue>& v, bool skip_heap)
+      : DHeapInline(unsigned(v.size())) {
+    const unsigned n = UKeySize();
+    for (unsigned i = 0; i < n; ++i) key_map[i].value = v[i];
+    if (!skip_heap) {
+      for (unsigned i = 0; i < n; ++i) {
+        nodes[i + nshift] = {v[i], i};
+        key_map[i].heap_position = i;
+      }
+      size = n;
+      Heapify();
+    }
+  }
+
+  bool Empty() const { return size == 0; }
+
+  unsigned Size() const { return size; }
+
+  unsigned UKeySize() const { return unsigned(key_map.size()); }
+
+  bool InHeap(unsigned key) const {
+    return key_map[key].heap_position != not_in_heap;
+  }
+
+  const TValue& Get(unsigned key) const { return key_map[key].value; }
+
+  std::vector<TValue> GetValues() const {
+    const unsigned n = UKeySize();
+    std::vector<TValue> v(n);
+    for (unsigned i = 0; i < n; ++i) v[i] = key_map[i].value;
+    return v;
+  }
+
+ protected:
+  void AddNewKeyI(unsigned key, const TValue& new_value, bool skip_heap) {
+    key_map[key].value = new_value;
+    if (!skip_heap) SiftUp(size++, {new_value, key});
+  }
+
+ public:
+  void AddNewKey(unsigned key, const TValue& new_value,
+                 bool skip_heap = false) {
+    assert(!InHeap(key));
+    AddNewKeyI(key, new_value, skip_heap);
+  }
+
+  void DecreaseValue(unsigned key, const TValue& new_value) {
+    const unsigned key_position = key_map[key].heap_position;
+    if (key_position == not_in_heap) {
+      AddNewKeyI(key, new_value, false);
+    } else {
+      key_map[key].value = new_value;
+      SiftUp(key_position, {new_value, key});
+    }
+  }
+
+  void DecreaseValueIfLess(unsigned key, const TValue& new_value) {
+    if (compare(new_value, key_map[key].value)) DecreaseValue(key, new_value);
+  }
+
+  void IncreaseValue(unsigned key, const TValue& new_value) {
+    const unsigned key_position = key_map[key].heap_position;
+    assert(key_position != not_in_heap);
+    key_map[key].value = new_value;
+    SiftDown(key_position, {new_value, key});
+  }
+
+  void Set(unsigned key, const TValue& new_value) {
+    if (!InHeap(key) || compare(new_value, key_map[key].value))
+      DecreaseValue(key, new_value);
+    else
+      IncreaseValue(key, new_value);
+  }
+
+  void Add(const TData& x) { Set(x.key, x.value); }
+
+  unsigned TopKey() const { return nodes[nshift].key; }
+
+  const TValue& TopValue() const { return nodes[nshift].value; }
+
+  TData Top() const { return {TopKey(), TopValue()}; }
+
+  void Pop() {
+    key_map[TopKey()].heap_position = not_in_heap;
+    const TNode last = nodes[--size + nshift];
+    nodes[size + nshift] = empty_node;
+    if (size) SiftDown(0, last);
+  }
+
+  unsigned ExtractKey() {
+    const unsigned t = TopKey();
+    Pop();
+    return t;
+  }
+
+  const TValue& ExtractValue() {
+    const unsigned key = TopKey();
+    Pop();
+    return key_map[key].value;
+  }
+
+  TData Extract() {
+    const TData t = Top();
+    Pop();
+    return t;
+  }
+
+  void ExtractAll() {
+    for (unsigned i = 0; i < size; ++i) {
+      key_map[nodes[i + nshift].key].heap_position = not_in_heap;
+      nodes[i + nshift] = empty_node;
+    }
+    size = 0;
+  }
+
+ protected:
+  void Place(unsigned pos, const TNode& node) {
+    nodes[pos + nshift] = node;
+    key_map[node.key].heap_position = pos;
+  }
+
+  void SiftUp(unsigned pos, const TNode node) {
+    for (; pos;) {
+      const unsigned npos = (pos - 1) / d;
+      const TNode& parent = nodes[npos + nshift];
+      if (!compare(node.value, parent.value)) break;
+      Place(pos, parent);
+      pos = npos;
+    }
+    Place(pos, node);
+  }
+
+  template <bool avx2>
+  unsigned MinChild(unsigned first) const {
+    const TNode* p = nodes.data() + first + nshift;
+#ifdef HEAP_UKVM_USE_AVX2
+    if constexpr (avx2) return first + hidden::MinIndexAVX2<d>(p);
+#endif
+    unsigned best = 0;
+    for (unsigned i = 1, ie = std::min(d, size - first); i < ie; ++i) {
+      if (compare(p[i].value, p[best].value)) best = i;
+    }
+    return first + best;
+  }
+
+  template <bool avx2>
+  void SiftDownI(unsigned pos, const TNode node) {
+    for (;;) {
+      const unsigned first = d * pos + 1;
+      if (first >= size) break;
+      const unsigned npos = MinChild<avx2>(first);
+      const TNode& child = nodes[npos + nshift];
+      if (!compare(child.value, node.value)) break;
+      Place(pos, child);
+      pos = npos;
+    }
+    Place(pos, node);
+  }
+
+#ifdef HEAP_UKVM_USE_AVX2
+  HEAP_UKVM_TARGET_AVX2 __attribute__((flatten)) void SiftDownAVX2(
+      unsigned pos, const TNode node) {
+    SiftDownI<true>(pos, node);
+  }
+#endif
+
+  void SiftDown(unsigned pos, const TNode node) {
+#ifdef HEAP_UKVM_USE_AVX2
+    if constexpr (simd) {
+      if (use_simd) return SiftDownAVX2(pos, node);
+    }
+#endif
+    SiftDownI<false>(pos, node);
+  }
+
+  void Heapify() {
+    for (unsigned pos = size / d + 1; pos;) {
+      --pos;
+      if (pos < size) SiftDown(pos, nodes[pos + nshift]);
+    }
+  }
+};
+}  // namespace ukvm
+}  // namespace heap
+
+#undef HEAP_UKVM_TARGET_AVX2
+#undef HEAP_UKVM_USE_AVX2
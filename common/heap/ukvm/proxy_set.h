@@ -11,13 +11,14 @@
 
 namespace heap {
 namespace ukvm {
-template <class TTSet>
+template <class TTSet,
+          template <class, class> class TTHashMap = std::unordered_map>
 class ProxySet {
  public:
   using TSet = TTSet;
   using TValue = typename TSet::TValue;
   using TData = Data<TValue>;
-  using TSelf = ProxySet<TSet>;
+  using TSelf = ProxySet<TSet, TTHashMap>;
 
   class TNode : public memory::Node {
    public:
@@ -29,7 +30,7 @@ class ProxySet {
   std::vector<TNode> nodes_key;
   memory::NodesManager<TNode> manager_priority;
   std::vector<TValue> priority;
-  std::unordered_map<TValue, TNode*> queue;
+  TTHashMap<TValue, TNode*> queue;
   TNode* pkey0;
   unsigned size;
 
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "common/base.h"
+#include "common/linear_algebra/bool/m4ri_table.h"
+#include "common/linear_algebra/bool/matrix.h"
+#include "common/linear_algebra/bool/rows_block_add.h"
+#include "common/linear_algebra/bool/rows_block_swap.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace la {
+// Gaussian elimination with Method of Four Russians (M4RI). Columns are
+// processed by blocks of 64. Pivots inside a block are found with row
+// operations restricted to candidate rows, pivot rows are kept reduced to
+// each other. Then all other rows are cleared on the block with 8 lookups
+// in tables of sums of pivot rows (one table per 8 columns), so every row is
+// loaded once per block.
+// Transforms matrix to row echelon form (reduced if reduced is true) and
+// returns pivot columns. Only first columns_limit columns are used for
+// pivots, other columns are transformed with the same row operations.
+constexpr std::vector<unsigned> EchelonForm(MatrixBool& m, bool reduced,
+                                            unsigned columns_limit) {
+  constexpr unsigned bits_per_block = MatrixBool::bits_per_block,
+                     k = M4RITable::max_k, tables = bits_per_block / k;
+  static_assert(tables == 8);
+  assert(columns_limit <= m.Columns());
+  const unsigned rows = m.Rows(), blocks_per_row = m.BlocksPerRow();
+  std::vector<unsigned> pivots;
+  std::vector<M4RITable> vt(tables);
+  std::vector<unsigned> compress(tables << k);
+  unsigned r = 0;
+  for (unsigned c = 0; (c < columns_limit) && (r < rows);
+       c += bits_per_block) {
+    const unsigned ce = std::min(c + bits_per_block, columns_limit),
+                   block = c / bits_per_block;
+    unsigned found = 0, pcolumns[bits_per_block] = {};
+    for (unsigned j = c; (j < ce) && (r + found < rows); ++j) {
+      unsigned i = r + found;
+      for (; i < rows; ++i) {
+        for (unsigned t = 0; t < found; ++t) {
+          if (m.GetBit(i, pcolumns[t])) RowsBlockAdd(m, i, r + t, block);
+        }
+        if (m.GetBit(i, j)) break;
+      }
+      if (i == rows) continue;
+      RowsBlockSwap(m, r + found, i, block);
+      for (unsigned t = 0; t < found; ++t) {
+        if (m.GetBit(r + t, j)) RowsBlockAdd(m, r + t, r + found, block);
+      }
+      pcolumns[found++] = j;
+    }
+    if (found == 0) continue;
+    // Pivots [tfirst[t], tfirst[t + 1]) are in columns [c + 8t, c + 8t + 8).
+    unsigned tfirst[tables + 1] = {};
+    for (unsigned t = 0, p = 0; t < tables; ++t) {
+      tfirst[t] = p;
+      for (; (p < found) && (pcolumns[p] < c + (t + 1) * k);) ++p;
+      tfirst[t + 1] = p;
+    }
+    // Bits of strip to index in the table.
+    for (unsigned t = 0; t < tables; ++t) {
+      for (unsigned x = 0; x < (1u << k); ++x) {
+        unsigned index = 0;
+        for (unsigned p = tfirst[t]; p < tfirst[t + 1]; ++p)
+          index |= ((x >> (pcolumns[p] - c - t * k)) & 1u) << (p - tfirst[t]);
+        compress[(t << k) + x] = index;
+      }
+    }
+    const unsigned width = blocks_per_row - block;
+    for (unsigned t = 0; t < tables; ++t) {
+      const unsigned size = tfirst[t + 1] - tfirst[t];
+      vt[t].Build(m.GetBP(size ? r + tfirst[t] : r, block), blocks_per_row,
+                  size, width);
+    }
+    for (unsigned i = (reduced ? 0 : r + found); i < rows; ++i) {
+      if (i == r) {
+        i += found - 1;
+        continue;
+      }
+      auto p = m.GetBP(i, block);
+      const MatrixBool::TBlockValue x = *p;
+      const MatrixBool::TBlockValue* pt[tables];
+      for (unsigned t = 0; t < tables; ++t)
+        pt[t] = vt[t].Get(compress[(t << k) + (unsigned(x >> (t * k)) & 0xFF)]);
+      for (unsigned j = 0; j < width; ++j) {
+        p[j] ^= pt[0][j] ^ pt[1][j] ^ pt[2][j] ^ pt[3][j] ^ pt[4][j] ^
+                pt[5][j] ^ pt[6][j] ^ pt[7][j];
+      }
+    }
+    pivots.insert(pivots.end(), pcolumns, pcolumns + found);
+    r += found;
+  }
+  return pivots;
+}
+
+constexpr std::vector<unsigned> EchelonForm(MatrixBool& m,
+                                            bool reduced = false) {
+  return EchelonForm(m, reduced, m.Columns());
+}
+}  // namespace la
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "common/base.h"
+
+#include <algorithm>
+#include <bit>
+#include <vector>
+
+namespace la {
+// Table for Method of Four Russians over GF(2). Stores all 2^k sums of k
+// rows, entry with index x is sum of rows i with bit i set in x. Entries are
+// filled in Gray code order, so each one costs a single row addition.
+class M4RITable {
+ public:
+  using TBlockValue = uint64_t;
+
+  static constexpr unsigned max_k = 8;
+
+ protected:
+  unsigned k = 0, width = 0;
+  std::vector<TBlockValue> table;
+
+ public:
+  constexpr unsigned K() const { return k; }
+
+  constexpr unsigned Mask() const { return (1u << k) - 1; }
+
+  // Rows start at first and are separated by stride blocks, only width
+  // blocks of each row are used.
+  constexpr void Build(const TBlockValue* first, size_t stride, unsigned _k,
+                       unsigned _width) {
+    assert(_k <= max_k);
+    k = _k;
+    width = _width;
+    table.resize((size_t(1) << k) * width);
+    std::fill(table.begin(), table.begin() + width, 0ull);
+    for (unsigned i = 1; i < (1u << k); ++i) {
+      const unsigned bit = unsigned(std::countr_zero(i)), g = i ^ (i >> 1);
+      const TBlockValue *pp = table.data() + size_t(g ^ (1u << bit)) * width,
+                        *pr = first + bit * stride;
+      TBlockValue* p = table.data() + size_t(g) * width;
+      for (unsigned j = 0; j < width; ++j) p[j] = pp[j] ^ pr[j];
+    }
+  }
+
+  constexpr const TBlockValue* Get(unsigned index) const {
+    return table.data() + size_t(index) * width;
+  }
+};
+}  // namespace la
@@ -1,8 +1,10 @@
 #pragma once
 
+#include "common/linear_algebra/bool/m4ri_table.h"
 #include "common/linear_algebra/bool/vector.h"
 // #include "common/numeric/utils/bits_count.h"
 #include <algorithm>
+#include <vector>
 
 namespace la {
 class MatrixBool : public VectorBool {
@@ -106,17 +108,40 @@ class MatrixBool : public VectorBool {
     return t;
   }
 
+  // Method of Four Russians. Rows of v are grouped by 8, for each group all
+  // sums are precomputed. Columns of output are processed in chunks, so
+  // tables for one block of columns of this matrix fit in L2 cache.
   constexpr void Mult(const TSelf& v, TSelf& output) const {
     assert((v.rows == columns) && (output.rows == rows) &&
            (output.columns == v.columns));
+    constexpr unsigned k = M4RITable::max_k, tables = bits_per_block / k,
+                       chunk = 32;
+    static_assert(tables == 8);
     output.Clear();
-    for (unsigned i = 0; i < rows; ++i) {
-      for (unsigned j = 0; j < columns; ++j) {
-        if (GetBit(i, j)) {
-          const_biterator pB = v.GetBP(j, 0);
-          for (biterator pC = output.GetBP(i, 0), pCend = pC + blocks_per_row;
-               pC < pCend;)
-            *pC++ ^= *pB++;
+    std::vector<M4RITable> vt(tables);
+    for (unsigned b0 = 0; b0 < v.blocks_per_row; b0 += chunk) {
+      const unsigned width = std::min(chunk, v.blocks_per_row - b0);
+      for (unsigned bj = 0; bj < blocks_per_row; ++bj) {
+        for (unsigned t = 0; t < tables; ++t) {
+          const unsigned j = bj * bits_per_block + t * k;
+          if (j < v.rows) {
+            vt[t].Build(v.GetBP(j, b0), v.blocks_per_row,
+                        std::min(k, v.rows - j), width);
+          } else {
+            vt[t].Build(v.GetBP(0, b0), v.blocks_per_row, 0, width);
+          }
+        }
+        for (unsigned i = 0; i < rows; ++i) {
+          const TBlockValue a = *GetBP(i, bj);
+          if (!a) continue;
+          const TBlockValue* pt[tables];
+          for (unsigned t = 0; t < tables; ++t)
+            pt[t] = vt[t].Get(unsigned(a >> (t * k)) & vt[t].Mask());
+          biterator pC = output.GetBP(i, b0);
+          for (unsigned j = 0; j < width; ++j) {
+            pC[j] ^= pt[0][j] ^ pt[1][j] ^ pt[2][j] ^ pt[3][j] ^ pt[4][j] ^
+                     pt[5][j] ^ pt[6][j] ^ pt[7][j];
+          }
         }
       }
     }
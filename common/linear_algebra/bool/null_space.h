@@ -0,0 +1,28 @@
+#pragma once
+
+#include "common/base.h"
+#include "common/linear_algebra/bool/echelon_form.h"
+#include "common/linear_algebra/bool/matrix.h"
+
+#include <vector>
+
+namespace la {
+// Basis of {x : Ax = 0}, one vector per row. Vector for free column f has
+// 1 in f and values of column f from reduced echelon form in pivot columns.
+constexpr MatrixBool NullSpace(const MatrixBool& A) {
+  MatrixBool m(A);
+  const auto pivots = EchelonForm(m, true);
+  std::vector<bool> is_pivot(A.Columns(), false);
+  for (unsigned j : pivots) is_pivot[j] = true;
+  MatrixBool output(A.Columns() - unsigned(pivots.size()), A.Columns());
+  for (unsigned f = 0, k = 0; f < A.Columns(); ++f) {
+    if (is_pivot[f]) continue;
+    output.Set(k, f, ModularBool::True());
+    for (unsigned i = 0; i < pivots.size(); ++i) {
+      if (m.GetBit(i, f)) output.Set(k, pivots[i], ModularBool::True());
+    }
+    ++k;
+  }
+  return output;
+}
+}  // namespace la
@@ -1,51 +1,48 @@
 #pragma once
 
 #include "common/base.h"
+#include "common/linear_algebra/bool/echelon_form.h"
 #include "common/linear_algebra/bool/matrix.h"
-#include "common/linear_algebra/bool/rows_block_add.h"
-#include "common/linear_algebra/bool/rows_block_swap.h"
 #include "common/linear_algebra/bool/vector.h"
 
+#include <algorithm>
 #include <vector>
 
 namespace la {
+// Solve AX = B for all columns of B at once. Rows of B are appended to rows
+// of A starting from a new block, so every row operation on [A | B] handles
+// 64 right-hand sides per word. Returns false if any system has no solution.
+constexpr bool Solve(const MatrixBool& A, const MatrixBool& B,
+                     MatrixBool& output_X) {
+  assert((A.Rows() == B.Rows()) && (A.Columns() == output_X.Rows()) &&
+         (B.Columns() == output_X.Columns()));
+  const unsigned ab = A.BlocksPerRow(), bb = B.BlocksPerRow();
+  MatrixBool m(A.Rows(), A.BitsPerRow() + B.Columns());
+  for (unsigned i = 0; i < A.Rows(); ++i) {
+    std::copy(A.GetBP(i, 0), A.GetBP(i, 0) + ab, m.GetBP(i, 0));
+    std::copy(B.GetBP(i, 0), B.GetBP(i, 0) + bb, m.GetBP(i, ab));
+  }
+  const auto pivots = EchelonForm(m, true, A.Columns());
+  for (unsigned i = unsigned(pivots.size()); i < m.Rows(); ++i) {
+    const auto p = m.GetBP(i, ab);
+    if (std::any_of(p, p + bb, [](auto x) { return x != 0; })) return false;
+  }
+  output_X.Clear();
+  for (unsigned i = 0; i < pivots.size(); ++i) {
+    const auto p = m.GetBP(i, ab);
+    std::copy(p, p + bb, output_X.GetBP(pivots[i], 0));
+  }
+  return true;
+}
+
 // Solve Ax = b
 constexpr bool Solve(const MatrixBool& A, const VectorBool& b,
                      VectorBool& output_x) {
   assert((A.Rows() == b.Size()) && (A.Columns() == output_x.Size()));
-  MatrixBool m(A);
-  VectorBool v(b);
-  unsigned r = 0;
-  std::vector<unsigned> vj(m.Rows());
-  for (unsigned j = 0; (r < m.Rows()) && (j < m.Columns()); ++j) {
-    for (unsigned i = r; i < m.Rows(); ++i) {
-      if (m.GetBit(i, j)) {
-        RowsBlockSwap(m, r, i, j / MatrixBool::bits_per_block);
-        v.Swap(r, i);
-        break;
-      }
-    }
-    if (m.GetBit(r, j) == 0) continue;
-    VectorBool::TBlockValue vrb = v.GetBit(r);
-    for (unsigned i = r + 1; i < m.Rows(); ++i) {
-      if (m.GetBit(i, j) == 0) continue;
-      RowsBlockAdd(m, i, r, j / MatrixBool::bits_per_block);
-      if (vrb) v.Complement(i);
-    }
-    vj[r++] = j;
-  }
-  for (unsigned i = r; i < m.Rows(); ++i) {
-    if (v.GetBit(i)) return false;
-  }
-  output_x.Clear();
-  for (; r--;) {
-    unsigned j = vj[r];
-    if (v.GetBit(r) == 0) continue;
-    for (unsigned i = 0; i < r; ++i) {
-      if (m.GetBit(i, j)) v.Complement(i);
-    }
-    output_x.Set(j, ModularBool::True());
-  }
+  MatrixBool B(A.Rows(), 1), X(A.Columns(), 1);
+  for (unsigned i = 0; i < A.Rows(); ++i) B.Set(i, 0, b.Get(i));
+  if (!Solve(A, B, X)) return false;
+  for (unsigned i = 0; i < A.Columns(); ++i) output_x.Set(i, X.Get(i, 0));
   return true;
 }
 }  // namespace la
@@ -82,7 +82,10 @@ class VectorBool {
     return *this;
   }
 
-  constexpr void swap(TSelf& r) { data.swap(r.data); }
+  constexpr void swap(TSelf& r) {
+    std::swap(size, r.size);
+    data.swap(r.data);
+  }
 
   constexpr TValue Get(unsigned i) const {
     TValue t;
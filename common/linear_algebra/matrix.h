@@ -1,8 +1,10 @@
 #pragma once
 
+#include "common/linear_algebra/mult/blocked.h"
 #include "common/linear_algebra/vector.h"
 
 #include <algorithm>
+#include <type_traits>
 
 namespace la {
 template <class TTValue>
@@ -105,7 +107,17 @@ class Matrix : public Vector<TTValue> {
     return t;
   }
 
+  // Cache-blocked multiplication, rows of output are split between threads.
+  void Mult(const TSelf& v, TSelf& output, unsigned threads) const {
+    assert((v.rows == columns) && (output.rows == rows) &&
+           (output.columns == v.columns));
+    mult::Blocked<TValue>::Mult(TBase::data.data(), v.data.data(),
+                                output.data.data(), rows, columns,
+                                output.columns, threads);
+  }
+
   constexpr void Mult(const TSelf& v, TSelf& output) const {
+    if (!std::is_constant_evaluated()) return Mult(v, output, 1);
     assert((v.rows == columns) && (output.rows == rows) &&
            (output.columns == v.columns));
     const unsigned columns2 = output.columns;
@@ -161,6 +173,23 @@ class Matrix : public Vector<TTValue> {
     return ans;
   }
 
+  TSelf PowU(uint64_t pow, unsigned threads) const {
+    assert(rows == columns);
+    TSelf ans(rows, columns), x = *this, t(rows, columns);
+    ans.SetDiagonal(TValue(1));
+    for (; pow; pow >>= 1) {
+      if (pow & 1) {
+        ans.Mult(x, t, threads);
+        ans.swap(t);
+      }
+      if (pow > 1) {
+        x.Mult(x, t, threads);
+        x.swap(t);
+      }
+    }
+    return ans;
+  }
+
   constexpr void AddXXT(const TVector& x) {
     assert((x.Size() == rows) && (rows == columns));
     iterator p = begin();
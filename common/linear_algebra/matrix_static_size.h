@@ -1,5 +1,6 @@
 #pragma once
 
+#include "common/linear_algebra/mult/lazy.h"
 #include "common/linear_algebra/vector_static_size.h"
 
 #include <algorithm>
@@ -82,6 +83,24 @@ class MatrixStaticSize : public VectorStaticSize<TTValue, rows * columns> {
   template <unsigned columns2>
   constexpr void Mult(const MatrixStaticSize<TValue, columns, columns2>& v,
                       MatrixStaticSize<TValue, rows, columns2>& output) const {
+    using TLazy = mult::Lazy<TValue>;
+    if constexpr (TLazy::enabled) {
+      // Row of output is accumulated without reduction.
+      for (unsigned i = 0; i < rows; ++i) {
+        uint64_t s[columns2] = {};
+        for (unsigned k = 0; k < columns; ++k) {
+          const uint64_t x = TLazy::Raw((*this)(i, k));
+          for (unsigned j = 0; j < columns2; ++j)
+            s[j] += x * TLazy::Raw(v(k, j));
+          if ((k + 1) % TLazy::max_terms == 0) {
+            for (unsigned j = 0; j < columns2; ++j) s[j] = TLazy::Fold(s[j]);
+          }
+        }
+        for (unsigned j = 0; j < columns2; ++j)
+          output(i, j) = TLazy::Reduce(s[j]);
+      }
+      return;
+    }
     output.Clear();
     const_iterator pA = TBase::begin();
     for (unsigned i = 0; i < rows; ++i) {
@@ -0,0 +1,222 @@
+#pragma once
+
+#include "common/base.h"
+#include "common/linear_algebra/mult/lazy.h"
+#include "common/modular/static/fft_simd.h"
+#include "common/thread_pool.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace la {
+namespace mult {
+// Cache-blocked multiplication of row-major matrices
+//   C[rows x columns] = A[rows x inner] * B[inner x columns].
+// Panels of B (kc x nc) and blocks of A (mc x kc) are packed and multiplied
+// by mr x nr register tiles. For Lazy types raw values are packed and
+// accumulated in uint64_t, otherwise blocks are multiplied with TValue
+// operators in i-k-j order. If threads > 1 and the product is not small,
+// blocks of rows are processed in parallel on the shared pool, each task
+// packs its own panels. Lazy tiles use AVX2 if the CPU supports it.
+template <class TValue>
+class Blocked {
+ protected:
+  using TLazy = Lazy<TValue>;
+
+  static constexpr unsigned mr = 4, nr = 8;
+  static constexpr unsigned mc = 64, kc = 256, nc = 512;
+  // Products with fewer multiplications run in the calling thread.
+  static constexpr uint64_t min_parallel_size = (1ull << 21);
+
+  // Products of packed A (kb x mr) and packed B (kb x nr) tiles.
+  static void KernelBase(const uint32_t* a, const uint32_t* b, unsigned kb,
+                         uint64_t (&output)[mr][nr]) {
+    // Half of the tile at once, so accumulators fit in registers.
+    for (unsigned h = 0; h < nr; h += nr / 2) {
+      uint64_t acc[mr][nr / 2] = {};
+      for (unsigned k0 = 0; k0 < kb; k0 += TLazy::max_terms) {
+        const unsigned k1 = std::min(kb, k0 + TLazy::max_terms);
+        for (unsigned k = k0; k < k1; ++k) {
+          const uint32_t *ak = a + k * mr, *bk = b + k * nr + h;
+          for (unsigned i = 0; i < mr; ++i) {
+            const uint64_t x = ak[i];
+            for (unsigned j = 0; j < nr / 2; ++j) acc[i][j] += x * bk[j];
+          }
+        }
+        for (unsigned i = 0; i < mr; ++i) {
+          for (unsigned j = 0; j < nr / 2; ++j)
+            acc[i][j] = TLazy::Fold(acc[i][j]);
+        }
+      }
+      for (unsigned i = 0; i < mr; ++i) {
+        for (unsigned j = 0; j < nr / 2; ++j) output[i][h + j] = acc[i][j];
+      }
+    }
+  }
+
+#ifdef MSTATIC_FFT_USE_AVX2
+#define LA_MULT_TARGET_AVX2 __attribute__((target("avx2")))
+  // Row of the tile is two registers with 4 lanes of 64 bits.
+  LA_MULT_TARGET_AVX2 static void KernelAVX2(const uint32_t* a,
+                                              const uint32_t* b, unsigned kb,
+                                              uint64_t (&output)[mr][nr]) {
+    static_assert((mr == 4) && (nr == 8));
+    const __m256i mask = _mm256_set1_epi64x(int64_t(TLazy::mask)),
+                  r = _mm256_set1_epi64x(int64_t(TLazy::r));
+    __m256i acc[mr][2];
+    for (unsigned i = 0; i < mr; ++i)
+      acc[i][0] = acc[i][1] = _mm256_setzero_si256();
+    for (unsigned k0 = 0; k0 < kb; k0 += TLazy::max_terms) {
+      const unsigned k1 = std::min(kb, k0 + TLazy::max_terms);
+      for (unsigned k = k0; k < k1; ++k) {
+        const __m256i bk = _mm256_loadu_si256(
+                          reinterpret_cast<const __m256i*>(b + k * nr)),
+                      b0 = _mm256_cvtepu32_epi64(_mm256_castsi256_si128(bk)),
+                      b1 = _mm256_cvtepu32_epi64(
+                          _mm256_extracti128_si256(bk, 1));
+        for (unsigned i = 0; i < mr; ++i) {
+          const __m256i x = _mm256_set1_epi64x(int64_t(a[k * mr + i]));
+          acc[i][0] = _mm256_add_epi64(acc[i][0], _mm256_mul_epu32(x, b0));
+          acc[i][1] = _mm256_add_epi64(acc[i][1], _mm256_mul_epu32(x, b1));
+        }
+      }
+      for (unsigned i = 0; i < mr; ++i) {
+        for (unsigned j = 0; j < 2; ++j) {
+          const __m256i x = acc[i][j];
+          acc[i][j] = _mm256_add_epi64(
+              _mm256_mul_epu32(_mm256_srli_epi64(x, 32), r),
+              _mm256_and_si256(x, mask));
+        }
+      }
+    }
+    for (unsigned i = 0; i < mr; ++i) {
+      for (unsigned j = 0; j < 2; ++j)
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(output[i] + 4 * j),
+                            acc[i][j]);
+    }
+  }
+#undef LA_MULT_TARGET_AVX2
+#endif
+
+  // Tile of packed A times packed B added to c.
+  static void Kernel(const uint32_t* a, const uint32_t* b, unsigned kb,
+                     uint64_t* c, size_t ldc, unsigned rows,
+                     unsigned columns) {
+    uint64_t acc[mr][nr];
+#ifdef MSTATIC_FFT_USE_AVX2
+    if (modular::mstatic::simd::UseAVX2()) {
+      KernelAVX2(a, b, kb, acc);
+    } else {
+      KernelBase(a, b, kb, acc);
+    }
+#else
+    KernelBase(a, b, kb, acc);
+#endif
+    for (unsigned i = 0; i < rows; ++i) {
+      for (unsigned j = 0; j < columns; ++j)
+        c[i * ldc + j] = TLazy::Add(c[i * ldc + j], acc[i][j]);
+    }
+  }
+
+  // Rows [r0, r1) of C.
+  static void MultRowsLazy(const TValue* A, const TValue* B, TValue* C,
+                           unsigned r0, unsigned r1, unsigned inner,
+                           unsigned columns) {
+    const size_t kmax = std::min(kc, inner),
+                 mmax = std::min(mc, r1 - r0) + mr - 1,
+                 nmax = std::min(nc, columns) + nr - 1;
+    std::vector<uint32_t> pa(kmax * (mmax - mmax % mr)),
+        pb(kmax * (nmax - nmax % nr));
+    std::vector<uint64_t> c(size_t(r1 - r0) * columns, 0);
+    for (unsigned jc = 0; jc < columns; jc += nc) {
+      const unsigned nb = std::min(nc, columns - jc);
+      for (unsigned pc = 0; pc < inner; pc += kc) {
+        const unsigned kb = std::min(kc, inner - pc);
+        // pb[jr][k][j] = B[pc + k][jc + jr * nr + j]
+        for (unsigned jr = 0; jr < nb; jr += nr) {
+          uint32_t* p = pb.data() + size_t(jr) * kb;
+          const unsigned l = std::min(nr, nb - jr);
+          for (unsigned k = 0; k < kb; ++k, p += nr) {
+            const TValue* b = B + size_t(pc + k) * columns + jc + jr;
+            for (unsigned j = 0; j < l; ++j) p[j] = TLazy::Raw(b[j]);
+            std::fill(p + l, p + nr, 0u);
+          }
+        }
+        for (unsigned ic = r0; ic < r1; ic += mc) {
+          const unsigned mb = std::min(mc, r1 - ic);
+          // pa[ir][k][i] = A[ic + ir * mr + i][pc + k]
+          for (unsigned ir = 0; ir < mb; ir += mr) {
+            uint32_t* p = pa.data() + size_t(ir) * kb;
+            const unsigned l = std::min(mr, mb - ir);
+            for (unsigned i = 0; i < mr; ++i) {
+              const TValue* a = A + size_t(ic + ir + i) * inner + pc;
+              for (unsigned k = 0; k < kb; ++k)
+                p[k * mr + i] = (i < l) ? TLazy::Raw(a[k]) : 0u;
+            }
+          }
+          for (unsigned ir = 0; ir < mb; ir += mr) {
+            for (unsigned jr = 0; jr < nb; jr += nr) {
+              Kernel(pa.data() + size_t(ir) * kb, pb.data() + size_t(jr) * kb,
+                     kb, c.data() + size_t(ic + ir - r0) * columns + jc + jr,
+                     columns, std::min(mr, mb - ir), std::min(nr, nb - jr));
+            }
+          }
+        }
+      }
+    }
+    for (size_t i = 0; i < c.size(); ++i)
+      C[size_t(r0) * columns + i] = TLazy::Reduce(c[i]);
+  }
+
+  static void MultRowsBase(const TValue* A, const TValue* B, TValue* C,
+                           unsigned r0, unsigned r1, unsigned inner,
+                           unsigned columns) {
+    std::fill(C + size_t(r0) * columns, C + size_t(r1) * columns, TValue(0));
+    for (unsigned jc = 0; jc < columns; jc += nc) {
+      const unsigned nb = std::min(nc, columns - jc);
+      for (unsigned pc = 0; pc < inner; pc += kc) {
+        const unsigned kb = std::min(kc, inner - pc);
+        for (unsigned i = r0; i < r1; ++i) {
+          const TValue* a = A + size_t(i) * inner + pc;
+          TValue* c = C + size_t(i) * columns + jc;
+          for (unsigned k = 0; k < kb; ++k) {
+            const TValue x = a[k];
+            const TValue* b = B + size_t(pc + k) * columns + jc;
+            for (unsigned j = 0; j < nb; ++j) c[j] += b[j] * x;
+          }
+        }
+      }
+    }
+  }
+
+  static void MultRows(const TValue* A, const TValue* B, TValue* C,
+                       unsigned r0, unsigned r1, unsigned inner,
+                       unsigned columns) {
+    if constexpr (TLazy::enabled) {
+      MultRowsLazy(A, B, C, r0, r1, inner, columns);
+    } else {
+      MultRowsBase(A, B, C, r0, r1, inner, columns);
+    }
+  }
+
+ public:
+  static void Mult(const TValue* A, const TValue* B, TValue* C, unsigned rows,
+                   unsigned inner, unsigned columns, unsigned threads = 1) {
+    if ((rows == 0) || (columns == 0)) return;
+    const unsigned blocks = (rows + mc - 1) / mc;
+    if ((threads <= 1) || (blocks <= 1) ||
+        (uint64_t(rows) * inner * columns < min_parallel_size)) {
+      MultRows(A, B, C, 0, rows, inner, columns);
+      return;
+    }
+    ThreadPool::Shared(threads - 1).ParallelFor(
+        0, blocks,
+        [&](size_t b) {
+          const unsigned r0 = unsigned(b) * mc;
+          MultRows(A, B, C, r0, std::min(rows, r0 + mc), inner, columns);
+        },
+        1);
+  }
+};
+}  // namespace mult
+}  // namespace la
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "common/base.h"
+#include "common/modular/static/modular.h"
+
+#include <algorithm>
+
+namespace la {
+namespace mult {
+// Sums of products without reduction after each operation. Disabled by
+// default, values are multiplied and added with TValue operators.
+template <class TValue>
+class Lazy {
+ public:
+  static constexpr bool enabled = false;
+};
+
+// Modular values with p < 2^31. Products are accumulated in uint64_t and
+// folded with 2^32 = r (mod p) every max_terms additions, value is reduced
+// once at the end.
+template <uint64_t mod, bool is_prime>
+class Lazy<modular::mstatic::Modular<mod, is_prime, true>> {
+ public:
+  using TValue = modular::mstatic::Modular<mod, is_prime, true>;
+
+  static constexpr bool enabled = (mod < (1ull << 31));
+
+  static constexpr uint64_t mask = (1ull << 32) - 1;
+  static constexpr uint64_t r = (1ull << 32) % mod;
+  // Upper bound for Fold output.
+  static constexpr uint64_t folded = mask * mod;
+
+  // Number of products that could be added to folded value.
+  static constexpr unsigned max_terms = unsigned(std::min<uint64_t>(
+      (~0ull - folded) / std::max<uint64_t>((mod - 1) * (mod - 1), 1),
+      1u << 16));
+
+  static constexpr uint32_t Raw(const TValue& x) { return uint32_t(x.Get()); }
+
+  // Returns value less or equal than folded and equal to x modulo p.
+  static constexpr uint64_t Fold(uint64_t x) {
+    return (x >> 32) * r + (x & mask);
+  }
+
+  // Sum of two folded values.
+  static constexpr uint64_t Add(uint64_t x, uint64_t y) { return Fold(x + y); }
+
+  static constexpr TValue Reduce(uint64_t x) { return TValue(x % mod); }
+};
+}  // namespace mult
+}  // namespace la
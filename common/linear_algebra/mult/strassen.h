@@ -0,0 +1,96 @@
+#pragma once
+
+#include "common/base.h"
+#include "common/linear_algebra/matrix.h"
+
+#include <algorithm>
+
+namespace la {
+namespace mult {
+namespace hidden {
+// Block of m starting from (r0, c0), padded with zeros up to h x w.
+template <class TValue>
+inline Matrix<TValue> StrassenBlock(const Matrix<TValue>& m, unsigned r0,
+                                    unsigned c0, unsigned h, unsigned w) {
+  Matrix<TValue> b(h, w, TValue(0));
+  const unsigned rows = std::min(h, m.Rows() - std::min(r0, m.Rows())),
+                 columns = std::min(w, m.Columns() - std::min(c0, m.Columns()));
+  for (unsigned i = 0; i < rows; ++i) {
+    for (unsigned j = 0; j < columns; ++j) b(i, j) = m(r0 + i, c0 + j);
+  }
+  return b;
+}
+
+template <class TValue>
+inline void StrassenStore(const Matrix<TValue>& b, unsigned r0, unsigned c0,
+                          Matrix<TValue>& m) {
+  const unsigned rows = std::min(b.Rows(), m.Rows() - std::min(r0, m.Rows())),
+                 columns = std::min(b.Columns(),
+                                    m.Columns() - std::min(c0, m.Columns()));
+  for (unsigned i = 0; i < rows; ++i) {
+    for (unsigned j = 0; j < columns; ++j) m(r0 + i, c0 + j) = b(i, j);
+  }
+}
+}  // namespace hidden
+
+// Strassen multiplication C = A * B with 7 products of half size blocks.
+// Odd dimensions are padded with zeros, blocks with any dimension not above
+// threshold are multiplied with Matrix::Mult. TValue should be a ring.
+template <class TValue>
+inline void Strassen(const Matrix<TValue>& A, const Matrix<TValue>& B,
+                     Matrix<TValue>& C, unsigned threshold = 256,
+                     unsigned threads = 1) {
+  assert((B.Rows() == A.Columns()) && (C.Rows() == A.Rows()) &&
+         (C.Columns() == B.Columns()));
+  const unsigned rows = A.Rows(), inner = A.Columns(), columns = B.Columns();
+  if (std::min({rows, inner, columns}) <= std::max(threshold, 1u)) {
+    A.Mult(B, C, threads);
+    return;
+  }
+  const unsigned m = (rows + 1) / 2, k = (inner + 1) / 2,
+                 n = (columns + 1) / 2;
+  auto block = [](const Matrix<TValue>& x, unsigned i, unsigned j, unsigned h,
+                  unsigned w) {
+    return hidden::StrassenBlock(x, i * h, j * w, h, w);
+  };
+  const auto A11 = block(A, 0, 0, m, k), A12 = block(A, 0, 1, m, k),
+             A21 = block(A, 1, 0, m, k), A22 = block(A, 1, 1, m, k);
+  const auto B11 = block(B, 0, 0, k, n), B12 = block(B, 0, 1, k, n),
+             B21 = block(B, 1, 0, k, n), B22 = block(B, 1, 1, k, n);
+  auto mult = [&](const Matrix<TValue>& x, const Matrix<TValue>& y) {
+    Matrix<TValue> z(m, n);
+    Strassen(x, y, z, threshold, threads);
+    return z;
+  };
+  const auto M1 = mult(A11 + A22, B11 + B22), M2 = mult(A21 + A22, B11),
+             M3 = mult(A11, B12 - B22), M4 = mult(A22, B21 - B11),
+             M5 = mult(A11 + A12, B22), M6 = mult(A21 - A11, B11 + B12),
+             M7 = mult(A12 - A22, B21 + B22);
+  hidden::StrassenStore(M1 + M4 - M5 + M7, 0, 0, C);
+  hidden::StrassenStore(M3 + M5, 0, n, C);
+  hidden::StrassenStore(M2 + M4, m, 0, C);
+  hidden::StrassenStore(M1 - M2 + M3 + M6, m, n, C);
+}
+
+template <class TValue>
+inline Matrix<TValue> StrassenPowU(const Matrix<TValue>& A, uint64_t pow,
+                                   unsigned threshold = 256,
+                                   unsigned threads = 1) {
+  assert(A.Rows() == A.Columns());
+  const unsigned size = A.Rows();
+  Matrix<TValue> ans(size), x = A, t(size);
+  ans.SetDiagonal(TValue(1));
+  for (; pow; pow >>= 1) {
+    if (pow & 1) {
+      Strassen(ans, x, t, threshold, threads);
+      ans.swap(t);
+    }
+    if (pow > 1) {
+      Strassen(x, x, t, threshold, threads);
+      x.swap(t);
+    }
+  }
+  return ans;
+}
+}  // namespace mult
+}  // namespace la
@@ -0,0 +1,349 @@
+#pragma once
+
+#include "common/base.h"
+#include "common/memory/node.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace memory {
+
+/**
+ * @brief Manages a pool of nodes in stable chunks with an intrusive free list.
+ *
+ * Nodes are stored in chunks of geometrically growing size. Chunks are never
+ * moved or reallocated, so pointers to nodes stay valid until clear_memory().
+ * Chunk 0 has 2^s slots and chunk k > 0 has 2^(s+k-1) slots, so the node
+ * with raw index i is found in O(1) with a few bit operations.
+ *
+ * Released nodes are kept in a singly linked list threaded through the
+ * slots. The link is stored next to the node rather than in its bytes,
+ * because reuse() relies on the node state surviving release (e.g. treap
+ * heights set in initialize()).
+ *
+ * release_all() forgets all nodes in O(1) without calling release() on
+ * them. Slots that were already used get reuse() before initialize() when
+ * they are handed out again, as after clear().
+ *
+ * @tparam TNode The type of node to manage. Must be derived from memory::Node.
+ * @tparam huge_pages If true, chunks are aligned to 2MB and advised to use
+ *                    transparent huge pages where supported.
+ */
+template <typename TNode, bool huge_pages = false>
+class ArenaNodesManager {
+  static_assert(std::is_base_of_v<Node, TNode>,
+                "TNode must be derived from memory::Node");
+
+ public:
+  using NodeType = TNode;
+
+  // Flags indicating supported operations
+  static constexpr bool support_at = true;
+  static constexpr bool support_index = false;
+
+ protected:
+  struct Slot {
+    NodeType node;
+    Slot* next_free = nullptr;
+  };
+
+  static constexpr size_t max_chunks = 48;
+  static constexpr unsigned min_log_first_chunk = 6;
+  static constexpr size_t huge_page_size = (size_t(1) << 21);
+
+ public:
+  /**
+   * @brief Constructs an arena with initial capacity.
+   *
+   * @param initial_capacity The initial number of nodes to reserve. Size of
+   *                         the first chunk is chosen to cover it.
+   */
+  [[nodiscard]] explicit ArenaNodesManager(size_t initial_capacity = 0) {
+    init(initial_capacity);
+  }
+
+  /**
+   * @brief Initializes the arena with the specified capacity.
+   *
+   * If no memory is allocated yet, the first chunk is resized to cover
+   * initial_capacity, otherwise it works as reserve().
+   *
+   * @param initial_capacity The initial number of nodes to reserve.
+   */
+  void init(size_t initial_capacity) {
+    if (chunks_ == 0) {
+      const size_t n = initial_capacity ? initial_capacity - 1 : 0;
+      log_first_chunk_ =
+          std::max(min_log_first_chunk, unsigned(std::bit_width(n)));
+    }
+    reserve(initial_capacity);
+  }
+
+  ArenaNodesManager(const ArenaNodesManager&) = delete;
+  ArenaNodesManager& operator=(const ArenaNodesManager&) = delete;
+
+  /**
+   * @brief Move constructor. Chunks are transferred, node pointers stay
+   *        valid.
+   */
+  ArenaNodesManager(ArenaNodesManager&& other) noexcept { swap(other); }
+
+  /**
+   * @brief Move assignment operator. Chunks are transferred, node pointers
+   *        stay valid.
+   */
+  ArenaNodesManager& operator=(ArenaNodesManager&& other) noexcept {
+    if (this != &other) {
+      clear_memory();
+      swap(other);
+    }
+    return *this;
+  }
+
+  ~ArenaNodesManager() { clear_memory(); }
+
+  void swap(ArenaNodesManager& other) noexcept {
+    std::swap(chunk_, other.chunk_);
+    std::swap(chunks_, other.chunks_);
+    std::swap(log_first_chunk_, other.log_first_chunk_);
+    std::swap(capacity_, other.capacity_);
+    std::swap(used_nodes_, other.used_nodes_);
+    std::swap(touched_nodes_, other.touched_nodes_);
+    std::swap(released_nodes_, other.released_nodes_);
+    std::swap(free_list_, other.free_list_);
+  }
+
+  /**
+   * @brief Reserves space for at least the specified number of nodes.
+   *
+   * New chunks are allocated until capacity covers new_capacity, existing
+   * nodes are not moved.
+   *
+   * @param new_capacity The minimum number of nodes to reserve.
+   */
+  void reserve(size_t new_capacity) {
+    while (capacity_ < new_capacity) add_chunk();
+  }
+
+  /**
+   * @brief Reserves additional space for the specified number of nodes.
+   *
+   * @param additional_nodes The number of additional nodes to reserve.
+   */
+  void reserve_additional(size_t additional_nodes) {
+    if (available_capacity() < additional_nodes)
+      reserve(used_nodes_ + additional_nodes);
+  }
+
+  /**
+   * @brief Creates a new node or reuses a released one.
+   *
+   * @return Pointer to the new or reused node.
+   */
+  [[nodiscard]] NodeType* create() {
+    if (free_list_) {
+      Slot* s = free_list_;
+      free_list_ = s->next_free;
+      --released_nodes_;
+      s->node.reuse();
+      return &s->node;
+    }
+
+    if (used_nodes_ == capacity_) add_chunk();
+    NodeType* node = &slot(used_nodes_)->node;
+    if (used_nodes_ < touched_nodes_) {
+      node->reuse();
+    } else {
+      ++touched_nodes_;
+    }
+    node->initialize(unsigned(used_nodes_++));
+    return node;
+  }
+
+  /**
+   * @brief Releases a node for future reuse.
+   *
+   * @param node Pointer to the node to release. Must be a valid node pointer
+   *             that was previously created by this manager.
+   */
+  void release(NodeType* node) {
+    node->release();
+    // node is the first member of Slot.
+    Slot* s = reinterpret_cast<Slot*>(node);
+    s->next_free = free_list_;
+    free_list_ = s;
+    ++released_nodes_;
+  }
+
+  /**
+   * @brief Releases all nodes in O(1) and keeps the memory allocated.
+   *
+   * release() is not called for nodes.
+   */
+  void release_all() noexcept {
+    used_nodes_ = 0;
+    released_nodes_ = 0;
+    free_list_ = nullptr;
+  }
+
+  /**
+   * @brief Returns the total capacity of the node pool.
+   */
+  [[nodiscard]] size_t capacity() const noexcept { return capacity_; }
+
+  /**
+   * @brief Returns the number of currently used nodes.
+   */
+  [[nodiscard]] size_t used() const noexcept {
+    return used_nodes_ - released_nodes_;
+  }
+
+  /**
+   * @brief Returns the number of nodes that can be created without
+   *        requiring additional memory allocation.
+   */
+  [[nodiscard]] size_t available_capacity() const noexcept {
+    return capacity() - used();
+  }
+
+  /**
+   * @brief Returns a pointer to a node by its raw index.
+   *
+   * Raw index is the order of the first creation of the node, the same as
+   * index passed to initialize().
+   *
+   * @param index The index of the node, must be less than capacity().
+   * @return Pointer to the node at the specified index.
+   */
+  [[nodiscard]] NodeType* at(size_t index) { return &slot(index)->node; }
+
+  /**
+   * @brief Returns a pointer to a node by its raw index (const version).
+   */
+  [[nodiscard]] const NodeType* at(size_t index) const {
+    return &slot(index)->node;
+  }
+
+  /**
+   * @brief Gets the index of a node.
+   *
+   * This function is only supported in ContiguousNodesManager.
+   * Using it with other node managers will result in a compile error.
+   */
+  [[nodiscard]] size_t index(const NodeType*) {
+    static_assert(sizeof(NodeType) == 0,
+                  "index() is only supported in ContiguousNodesManager. "
+                  "Please use ContiguousNodesManager instead of "
+                  "ArenaNodesManager.");
+    return 0;
+  }
+
+  /**
+   * @brief Removes all nodes and frees allocated memory.
+   */
+  void clear_memory() {
+    for (size_t i = 0; i < used_nodes_; ++i) slot(i)->node.release();
+    for (size_t k = 0; k < chunks_; ++k) {
+      const size_t size = chunk_size(k);
+      for (size_t i = 0; i < size; ++i) chunk_[k][i].~Slot();
+      deallocate(chunk_[k], size);
+      chunk_[k] = nullptr;
+    }
+    chunks_ = 0;
+    capacity_ = 0;
+    used_nodes_ = 0;
+    touched_nodes_ = 0;
+    released_nodes_ = 0;
+    free_list_ = nullptr;
+  }
+
+  /**
+   * @brief Removes all nodes but keeps the memory allocated.
+   *
+   * Same as release_all() but calls release() for all nodes.
+   */
+  void clear() {
+    for (size_t i = 0; i < used_nodes_; ++i) slot(i)->node.release();
+    release_all();
+  }
+
+ protected:
+  [[nodiscard]] size_t chunk_size(size_t k) const {
+    return size_t(1) << (log_first_chunk_ + (k ? k - 1 : 0));
+  }
+
+  [[nodiscard]] Slot* slot(size_t index) const {
+    const size_t h = index >> log_first_chunk_;
+    if (h == 0) return chunk_[0] + index;
+    const unsigned k = unsigned(std::bit_width(h));
+    return chunk_[k] + (index - (size_t(1) << (log_first_chunk_ + k - 1)));
+  }
+
+  static size_t allocation_size(size_t slots) {
+    const size_t bytes = slots * sizeof(Slot);
+    if constexpr (huge_pages) {
+      return (bytes + huge_page_size - 1) & ~(huge_page_size - 1);
+    } else {
+      return bytes;
+    }
+  }
+
+  static Slot* allocate(size_t slots) {
+    const size_t bytes = allocation_size(slots);
+    void* p = nullptr;
+    if constexpr (huge_pages) {
+      p = std::aligned_alloc(huge_page_size, bytes);
+      if (!p) throw std::bad_alloc();
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+      madvise(p, bytes, MADV_HUGEPAGE);
+#endif
+    } else {
+      p = ::operator new(bytes, std::align_val_t(alignof(Slot)));
+    }
+    return static_cast<Slot*>(p);
+  }
+
+  static void deallocate(Slot* p, [[maybe_unused]] size_t slots) {
+    if constexpr (huge_pages) {
+      std::free(p);
+    } else {
+      ::operator delete(p, std::align_val_t(alignof(Slot)));
+    }
+  }
+
+  void add_chunk() {
+    assert(chunks_ < max_chunks);
+    const size_t size = chunk_size(chunks_);
+    Slot* p = allocate(size);
+    for (size_t i = 0; i < size; ++i) new (p + i) Slot();
+    chunk_[chunks_++] = p;
+    capacity_ += size;
+  }
+
+ protected:
+  Slot* chunk_[max_chunks] = {};
+  size_t chunks_{0};
+  unsigned log_first_chunk_{min_log_first_chunk};
+  size_t capacity_{0};
+  size_t used_nodes_{0};     // Nodes handed out since last release_all.
+  size_t touched_nodes_{0};  // Nodes initialized at least once.
+  size_t released_nodes_{0};
+  Slot* free_list_{nullptr};
+};
+
+/**
+ * @brief ArenaNodesManager with huge page aligned chunks. Could be used as
+ *        template template argument for trees and heaps.
+ */
+template <typename TNode>
+using HugePagesArenaNodesManager = ArenaNodesManager<TNode, true>;
+
+}  // namespace memory
@@ -290,7 +290,7 @@ class BlocksManager {
     used_blocks_ = 0;
     current_index1_ = 0;
     current_index2_ = 0;
-    std::stack<NodeType*>().swap(released_blocks_);
+    std::stack<NodeType*, std::vector<NodeType*>>().swap(released_blocks_);
     std::vector<std::vector<NodeType>>().swap(nodes_);
   }
 
@@ -321,7 +321,7 @@ class BlocksManager {
     used_blocks_ = 0;
     current_index1_ = 0;
     current_index2_ = 0;
-    std::stack<NodeType*>().swap(released_blocks_);
+    std::stack<NodeType*, std::vector<NodeType*>>().swap(released_blocks_);
   }
 
   /**
@@ -345,7 +345,7 @@ class BlocksManager {
   size_t used_blocks_ = 0;
   size_t current_index1_ = 0;
   size_t current_index2_ = 0;
-  std::stack<NodeType*> released_blocks_;
+  std::stack<NodeType*, std::vector<NodeType*>> released_blocks_;
 };
 
 }  // namespace memory
@@ -241,7 +241,7 @@ class ContiguousNodesManager {
   constexpr void clear_memory() {
     for (size_t i = 0; i < used_nodes_; ++i) nodes_[i].release();
     used_nodes_ = 0;
-    std::stack<NodeType*>().swap(released_nodes_);
+    std::stack<NodeType*, std::vector<NodeType*>>().swap(released_nodes_);
     std::vector<NodeType>().swap(nodes_);
     first_ = nullptr;
   }
@@ -259,7 +259,7 @@ class ContiguousNodesManager {
       nodes_[i].reuse();
     }
     used_nodes_ = 0;
-    std::stack<NodeType*>().swap(released_nodes_);
+    std::stack<NodeType*, std::vector<NodeType*>>().swap(released_nodes_);
   }
 
   /**
@@ -279,7 +279,7 @@ class ContiguousNodesManager {
  protected:
   std::vector<NodeType> nodes_;
   size_t used_nodes_{0};
-  std::stack<NodeType*> released_nodes_;
+  std::stack<NodeType*, std::vector<NodeType*>> released_nodes_;
   NodeType* first_;
 };
 
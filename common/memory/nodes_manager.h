@@ -8,6 +8,7 @@
 #include <stack>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 namespace memory {
 
@@ -230,7 +231,7 @@ class NodesManager {
   constexpr void clear_memory() {
     for (size_t i = 0; i < used_nodes_; ++i) nodes_[i].release();
     used_nodes_ = 0;
-    std::stack<NodeType*>().swap(released_nodes_);
+    std::stack<NodeType*, std::vector<NodeType*>>().swap(released_nodes_);
     std::deque<NodeType>().swap(nodes_);
   }
 
@@ -247,13 +248,13 @@ class NodesManager {
       nodes_[i].reuse();
     }
     used_nodes_ = 0;
-    std::stack<NodeType*>().swap(released_nodes_);
+    std::stack<NodeType*, std::vector<NodeType*>>().swap(released_nodes_);
   }
 
  protected:
   std::deque<NodeType> nodes_;
   size_t used_nodes_{0};
-  std::stack<NodeType*> released_nodes_;
+  std::stack<NodeType*, std::vector<NodeType*>> released_nodes_;
 };
 
 }  // namespace memory
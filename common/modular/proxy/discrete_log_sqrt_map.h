@@ -3,14 +3,22 @@
 #include "common/base.h"
 #include "common/factorization/base.h"
 #include "common/modular/arithmetic.h"
+#include "common/modular/proxy/montgomery.h"
 #include "common/modular/utils/primitive_root.h"
 #include "common/numeric/utils/usqrt.h"
 
 #include <algorithm>
-#include <unordered_map>
+#include <bit>
+#include <span>
+#include <vector>
 
 // Calculate discrete logarithm using "Baby-step giant-step" algorithm
 // ( https://en.wikipedia.org/wiki/Baby-step_giant-step ). Default m = sqrt(P).
+// For Q queries with the same prime m = sqrt(P * Q) minimizes total time.
+// Baby steps are stored in Montgomery form as 32-bit (key, index) pairs
+// grouped by hash bucket (~10 bytes per step). LogMany runs giant steps for
+// a batch of queries together, offsets for the next round and table buckets
+// for the current round are prefetched.
 // Prebuild:
 //   O(m) time, O(m) memory
 // Log:
@@ -20,21 +28,59 @@ namespace proxy {
 class DiscreteLogSqrtMap {
  public:
   using TModularA = TArithmetic_P32U;
+  using TMontgomery = Montgomery<uint64_t>;
 
  protected:
+  static constexpr unsigned batch_size = 16;
+
   uint64_t p, primitive;
-  uint64_t m, ippm;
-  std::unordered_map<uint64_t, uint64_t> vmap;
+  uint64_t m, giant_steps;
+  TMontgomery mg;
+  uint64_t ippm;  // primitive^(-m) in Montgomery form
+  unsigned shift;
+  // Baby steps primitive^i for bucket b are table[offsets[b], offsets[b+1]),
+  // each value is (key << 32) + i.
+  std::vector<uint32_t> offsets;
+  std::vector<uint64_t> table;
+
+ protected:
+  size_t Bucket(uint64_t key) const {
+    return uint32_t(key * 0x9E3779B1u) >> shift;
+  }
+
+  // Index i with primitive^i = key or m if key is not in table.
+  uint64_t Find(uint64_t key) const {
+    const size_t b = Bucket(key);
+    for (uint32_t i = offsets[b], ie = offsets[b + 1]; i < ie; ++i) {
+      if ((table[i] >> 32) == key) return uint32_t(table[i]);
+    }
+    return m;
+  }
 
  public:
   void Build() {
-    vmap.clear();
-    uint64_t r = 1;
+    if (p == 2) return;
+    assert(p < (1ull << 32));
+    mg = TMontgomery(p);
+    const unsigned bits = std::max(1u, unsigned(std::bit_width(m)) - 1);
+    shift = 32 - bits;
+    std::vector<uint64_t> keys(m);
+    offsets.assign((size_t(1) << bits) + 1, 0);
+    uint64_t r = mg.One();
+    const uint64_t g = mg.To(primitive);
     for (uint64_t i = 0; i < m; ++i) {
-      vmap[r] = i;
-      r = TModularA::Mult(r, primitive, p);
+      keys[i] = r;
+      ++offsets[Bucket(r) + 1];
+      r = mg.Mult(r, g);
     }
-    ippm = TModularA::Inverse(TModularA::PowU(primitive, m, p), p);
+    for (size_t b = 1; b < offsets.size(); ++b) offsets[b] += offsets[b - 1];
+    table.resize(m);
+    std::vector<uint32_t> position(offsets.begin(), offsets.end() - 1);
+    for (uint64_t i = 0; i < m; ++i)
+      table[position[Bucket(keys[i])]++] = (keys[i] << 32) + i;
+    // r = primitive^m
+    ippm = mg.To(TModularA::Inverse(mg.From(r), p));
+    giant_steps = (p - 1 + m - 1) / m;
   }
 
   DiscreteLogSqrtMap(uint64_t prime, uint64_t pprimitive)
@@ -45,7 +91,7 @@ class DiscreteLogSqrtMap {
 
   DiscreteLogSqrtMap(uint64_t prime, uint64_t pprimitive, uint64_t size)
       : p(prime), primitive(pprimitive) {
-    m = std::min(size, p - 1);
+    m = std::max<uint64_t>(std::min(size, p - 1), 1);
     Build();
   }
 
@@ -58,17 +104,69 @@ class DiscreteLogSqrtMap {
       : DiscreteLogSqrtMap(
             prime, FindSmallestPrimitiveRoot(prime, p1_factorization), size) {}
 
+  // Baby steps count for expected number of queries.
+  static uint64_t BabyStepsForQueries(uint64_t prime, uint64_t queries) {
+    // More than p - 1 queries do not change the answer, (p - 1)^2 fits in
+    // 64 bits.
+    queries = std::clamp<uint64_t>(queries, 1, prime - 1);
+    return USqrt((prime - 1) * queries) + 1;
+  }
+
   uint64_t Log(uint64_t x) const {
     x = TModularA::ApplyU(x, p);
     assert(x);
-    for (uint64_t i = 0; i * m <= p; ++i) {
-      auto it = vmap.find(x);
-      if (it != vmap.end()) return i * m + it->second;
-      x = TModularA::Mult(x, ippm, p);
+    if (p == 2) return 0;
+    x = mg.To(x);
+    for (uint64_t i = 0; i < giant_steps; ++i) {
+      const uint64_t j = Find(x);
+      if (j < m) return i * m + j;
+      x = mg.Mult(x, ippm);
     }
     assert(false);
     return 0;
   }
+
+  // Same as Log for each value.
+  std::vector<uint64_t> LogMany(std::span<const uint64_t> values) const {
+    std::vector<uint64_t> output(values.size(), 0);
+    if (p == 2) return output;
+    // Active queries: current value, giant step and index in output.
+    uint64_t x[batch_size], steps[batch_size];
+    size_t index[batch_size];
+    unsigned active = 0;
+    size_t next = 0;
+    for (;;) {
+      for (; (active < batch_size) && (next < values.size()); ++next) {
+        const uint64_t v = TModularA::ApplyU(values[next], p);
+        assert(v);
+        x[active] = mg.To(v);
+        __builtin_prefetch(&offsets[Bucket(x[active])]);
+        steps[active] = 0;
+        index[active++] = next;
+      }
+      if (!active) break;
+      // Offsets were prefetched in the previous round.
+      for (unsigned k = 0; k < active; ++k)
+        __builtin_prefetch(&table[offsets[Bucket(x[k])]]);
+      for (unsigned k = 0; k < active;) {
+        const uint64_t j = Find(x[k]);
+        if (j < m) {
+          output[index[k]] = steps[k] * m + j;
+          --active;
+          x[k] = x[active];
+          steps[k] = steps[active];
+          index[k] = index[active];
+        } else {
+          assert(steps[k] + 1 < giant_steps);
+          x[k] = mg.Mult(x[k], ippm);
+          __builtin_prefetch(&offsets[Bucket(x[k])]);
+          ++steps[k];
+          ++k;
+        }
+      }
+    }
+    return output;
+  }
 };
 }  // namespace proxy
 }  // namespace modular
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "common/base.h"
+
+#include <type_traits>
+
+namespace modular {
+namespace proxy {
+namespace hidden {
+// lvalue * rvalue = high * 2^64 + low
+constexpr void MultFull(uint64_t lvalue, uint64_t rvalue, uint64_t& high,
+                        uint64_t& low) {
+  const __uint128_t r = __uint128_t(lvalue) * rvalue;
+  high = uint64_t(r >> 64);
+  low = uint64_t(r);
+}
+
+// lvalue * rvalue = high * 2^128 + low
+constexpr void MultFull(__uint128_t lvalue, __uint128_t rvalue,
+                        __uint128_t& high, __uint128_t& low) {
+  const uint64_t l0 = uint64_t(lvalue), l1 = uint64_t(lvalue >> 64),
+                 r0 = uint64_t(rvalue), r1 = uint64_t(rvalue >> 64);
+  const __uint128_t p00 = __uint128_t(l0) * r0, p01 = __uint128_t(l0) * r1,
+                    p10 = __uint128_t(l1) * r0, p11 = __uint128_t(l1) * r1;
+  const __uint128_t middle = (p00 >> 64) + uint64_t(p01) + uint64_t(p10);
+  low = (middle << 64) | uint64_t(p00);
+  high = p11 + (p01 >> 64) + (p10 >> 64) + (middle >> 64);
+}
+}  // namespace hidden
+
+// Montgomery form for odd modulus mod with R = 2^w, w is number of bits in
+// TValue. Value x is stored as x * R % mod in [0, mod), multiplication needs
+// two full products and no division.
+// https://en.wikipedia.org/wiki/Montgomery_modular_multiplication
+template <class TTValue = uint64_t>
+class Montgomery {
+ public:
+  using TValue = TTValue;
+  static_assert(std::is_same_v<TValue, uint64_t> ||
+                std::is_same_v<TValue, __uint128_t>);
+  static constexpr unsigned bits = 8 * sizeof(TValue);
+
+ protected:
+  TValue mod, mod_inverse, r1, r2;
+
+ public:
+  constexpr explicit Montgomery(TValue _mod = 1) : mod(_mod) {
+    assert(mod & 1);
+    // Initial value is correct for 5 bits, each Newton iteration doubles
+    // number of correct bits.
+    mod_inverse = (3 * mod) ^ 2;
+    for (unsigned i = 0; i < ((bits == 64) ? 4 : 5); ++i)
+      mod_inverse *= 2 - mod * mod_inverse;
+    r1 = (TValue(0) - mod) % mod;
+    if constexpr (bits == 64) {
+      r2 = uint64_t((__uint128_t(r1) * r1) % mod);
+    } else {
+      r2 = r1;
+      for (unsigned i = 0; i < bits; ++i) r2 = Add(r2, r2);
+    }
+  }
+
+  constexpr TValue GetMod() const { return mod; }
+
+  // x * R^-1 % mod for x = high * R + low, high < mod.
+  constexpr TValue Reduce(TValue high, TValue low) const {
+    TValue mh = 0, ml = 0;
+    hidden::MultFull(TValue(low * mod_inverse), mod, mh, ml);
+    return (high >= mh) ? high - mh : high + (mod - mh);
+  }
+
+  constexpr TValue To(TValue value) const {
+    TValue high = 0, low = 0;
+    hidden::MultFull(value % mod, r2, high, low);
+    return Reduce(high, low);
+  }
+
+  constexpr TValue From(TValue value) const { return Reduce(0, value); }
+
+  constexpr TValue One() const { return r1; }
+
+  constexpr TValue Add(TValue lvalue, TValue rvalue) const {
+    return (lvalue >= mod - rvalue) ? lvalue - (mod - rvalue)
+                                    : lvalue + rvalue;
+  }
+
+  constexpr TValue Sub(TValue lvalue, TValue rvalue) const {
+    return (lvalue >= rvalue) ? lvalue - rvalue : lvalue + (mod - rvalue);
+  }
+
+  constexpr TValue Mult(TValue lvalue, TValue rvalue) const {
+    TValue high = 0, low = 0;
+    hidden::MultFull(lvalue, rvalue, high, low);
+    return Reduce(high, low);
+  }
+
+  constexpr TValue Sqr(TValue value) const { return Mult(value, value); }
+
+  constexpr TValue PowU(TValue value, TValue pow) const {
+    TValue r = One();
+    for (; pow; pow >>= 1) {
+      if (pow & 1) r = Mult(r, value);
+      value = Sqr(value);
+    }
+    return r;
+  }
+};
+}  // namespace proxy
+}  // namespace modular
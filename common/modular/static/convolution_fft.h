@@ -3,12 +3,19 @@
 #include "common/base.h"
 #include "common/modular.h"
 #include "common/modular/static/fft.h"
-#include "common/modular/utils/merge_remainders.h"
+#include "common/modular/static/fft_parallel.h"
+#include "common/modular/static/fft_simd.h"
 
+#include <algorithm>
+#include <bit>
 #include <vector>
 
 namespace modular {
 namespace mstatic {
+// Convolution modulo 32-bit prime p. If p - 1 is divisible by a large power
+// of 2 (e.g. 998244353 = 2^23*7*17 + 1), lengths up to that power use a
+// single transform modulo p. Otherwise three transforms modulo NTT-friendly
+// primes are combined with Garner's algorithm.
 template <class TModular>
 class ConvolutionFFT {
  protected:
@@ -16,7 +23,10 @@ class ConvolutionFFT {
 
   static constexpr unsigned log2_maxn = 26;
 
-  using TModularA = modular::TArithmetic_P32U;
+  static constexpr uint64_t p = TModular::GetMod();
+  static constexpr unsigned log2_direct = unsigned(std::countr_zero(p - 1));
+  static constexpr bool direct = (log2_direct >= 10);
+
   using TModular1 = ModularPrime32<2013265921>;  // 2^27*3*5 + 1
   using TModular2 = ModularPrime32<1811939329>;  // 2^26*3^2 + 1
   using TModular3 = ModularPrime32<469762049>;   // 2^26*7 + 1, 3
@@ -24,49 +34,166 @@ class ConvolutionFFT {
   using TMFFT2 = modular::mstatic::FFT<TModular2, log2_maxn, 13>;
   using TMFFT3 = modular::mstatic::FFT<TModular3, log2_maxn, 3>;
 
+  static constexpr uint64_t p1 = TModular1::GetMod(), p2 = TModular2::GetMod(),
+                            p3 = TModular3::GetMod();
+
  protected:
-  template <class TModularNew>
-  static constexpr std::vector<TModularNew> ChangeModular(
-      const std::vector<TModular>& a) {
-    std::vector<TModularNew> v(a.size());
-    for (size_t i = 0; i < a.size(); ++i) v[i] = TModularNew(a[i].Get());
+  static void Load(const TModular* a, size_t size, unsigned n, uint32_t* v1,
+                   uint32_t* v2, uint32_t* v3) {
+    assert(size <= n);
+    for (size_t i = 0; i < size; ++i) {
+      const uint64_t x = a[i].Get();
+      v1[i] = uint32_t(x % p1);
+      v2[i] = uint32_t(x % p2);
+      v3[i] = uint32_t(x % p3);
+    }
+    for (uint32_t* v : {v1, v2, v3}) std::fill(v + size, v + n, 0u);
+  }
+
+  static void Load(const std::vector<TModular>& a, unsigned n, uint32_t* v1,
+                   uint32_t* v2, uint32_t* v3) {
+    Load(a.data(), a.size(), n, v1, v2, v3);
+  }
+
+  // Garner's algorithm: x = v1 + p1 * k2 + p1 * p2 * k3.
+  static std::vector<TModular> Restore(unsigned n, uint32_t* v1, uint32_t* v2,
+                                       uint32_t* v3) {
+    constexpr uint64_t c12 = TModular2(p1).Inverse().Get(),
+                       c13 = TModular3(p1).Inverse().Get(),
+                       c23 = TModular3(p2).Inverse().Get();
+    simd::GarnerStep(v1, v2, n, p2, c12);
+    simd::GarnerStep(v1, v3, n, p3, c13);
+    simd::GarnerStep(v2, v3, n, p3, c23);
+    const TModular mp12 = TModular(p1) * TModular(p2);
+    std::vector<TModular> v(n);
+    for (unsigned i = 0; i < n; ++i)
+      v[i] = TModular(v1[i] + p1 * v2[i]) + mp12 * TModular(v3[i]);
     return v;
   }
 
-  static constexpr std::vector<TModular> Restore(
-      const std::vector<TModular1>& v1, const std::vector<TModular2>& v2,
-      const std::vector<TModular3>& v3) {
-    constexpr uint64_t p1 = TModular1::GetMod(), p2 = TModular2::GetMod(),
-                       p3 = TModular3::GetMod(), p12 = p1 * p2,
-                       p12m3 = p12 % p3;
-    assert((v1.size() == v2.size()) && (v1.size() == v3.size()));
-    const TModular mp12(p12);
-    std::vector<TModular> v(v1.size());
-    for (size_t i = 0; i < v1.size(); ++i) {
-      const auto v12 =
-          MergeRemainders<TModularA>(p1, v1[i].Get(), p2, v2[i].Get());
-      const uint64_t p12m =
-          TModularA::Div(TModularA::SubSafe(v3[i].Get(), v12, p3), p12m3, p3);
-      v[i] = mp12 * TModular(p12m) + TModular(v12);
+  // Calls f(fft, i, q) for residue i modulo q, residues are independent and
+  // processed in parallel if FFTParallel is enabled for this size.
+  template <class TFunction>
+  static void ForResidues(unsigned n, const TFunction& f) {
+    auto g = [&](size_t i) {
+      if (i == 0) {
+        f(TMFFT1::GetFFT(), i, p1);
+      } else if (i == 1) {
+        f(TMFFT2::GetFFT(), i, p2);
+      } else {
+        f(TMFFT3::GetFFT(), i, p3);
+      }
+    };
+    if (FFTParallel::Use(n)) {
+      FFTParallel::For(3, g);
+    } else {
+      for (size_t i = 0; i < 3; ++i) g(i);
     }
-    return v;
+  }
+
+  static void Convolution(unsigned n, uint32_t* v1, uint32_t* v2, uint32_t* v3,
+                          uint32_t* u1, uint32_t* u2, uint32_t* u3) {
+    uint32_t* v[3] = {v1, v2, v3};
+    uint32_t* u[3] = {u1, u2, u3};
+    ForResidues(n, [&](const auto& fft, size_t i, uint64_t) {
+      fft.ConvolutionInPlace(n, v[i], u[i]);
+    });
   }
 
  public:
+  // Operand of cyclic convolutions of length n in transformed form. It
+  // could be reused in several products, e.g. between Newton steps.
+  struct Transformed {
+    unsigned n = 0;
+    std::vector<uint32_t> v;
+  };
+
+  static constexpr unsigned GetNForFFT(unsigned l) {
+    return TMFFT1::GetNForFFT(l);
+  }
+
+  // Transform modulo p is possible for length n.
+  static constexpr bool Direct(unsigned n) {
+    return direct && (n <= (1ull << log2_direct));
+  }
+
+  // a[0, size) with size <= n, n is a power of 2.
+  static Transformed Transform(const TModular* a, size_t size, unsigned n) {
+    Transformed t;
+    t.n = n;
+    if constexpr (direct) {
+      if (Direct(n)) {
+        assert(size <= n);
+        t.v.resize(n);
+        for (size_t i = 0; i < size; ++i) t.v[i] = uint32_t(a[i].Get());
+        FFTA<TModular>::GetFFT().Transform(n, t.v.data());
+        return t;
+      }
+    }
+    t.v.resize(3 * size_t(n));
+    uint32_t* v = t.v.data();
+    Load(a, size, n, v, v + n, v + 2 * n);
+    ForResidues(n, [&](const auto& fft, size_t i, uint64_t) {
+      fft.Transform(n, v + i * n);
+    });
+    return t;
+  }
+
+  static Transformed Transform(const std::vector<TModular>& a, unsigned n) {
+    return Transform(a.data(), a.size(), n);
+  }
+
+  // Cyclic convolution of length n.
+  static std::vector<TModular> CyclicConvolution(const Transformed& a,
+                                                 const Transformed& b) {
+    assert(a.n == b.n);
+    const unsigned n = a.n;
+    thread_local std::vector<uint32_t> buffer;
+    buffer = a.v;
+    uint32_t* v = buffer.data();
+    if constexpr (direct) {
+      if (Direct(n)) {
+        simd::MultPointwise(v, b.v.data(), n, p);
+        FFTA<TModular>::GetFFT().TransformInv(n, v);
+        return std::vector<TModular>(v, v + n);
+      }
+    }
+    ForResidues(n, [&](const auto& fft, size_t i, uint64_t q) {
+      simd::MultPointwise(v + i * n, b.v.data() + i * n, n, q);
+      fft.TransformInv(n, v + i * n);
+    });
+    return Restore(n, v, v + n, v + 2 * n);
+  }
+
   static std::vector<TModular> Convolution(const std::vector<TModular>& a) {
-    return Restore(TMFFT1::SConvolution(ChangeModular<TModular1>(a)),
-                   TMFFT2::SConvolution(ChangeModular<TModular2>(a)),
-                   TMFFT3::SConvolution(ChangeModular<TModular3>(a)));
+    thread_local std::vector<uint32_t> buffer;
+    const size_t size = 2 * a.size();
+    const unsigned n = TMFFT1::GetNForFFT(unsigned(size));
+    if constexpr (direct) {
+      if (Direct(n)) return FFTA<TModular>::GetFFT().Convolution(a);
+    }
+    buffer.resize(std::max<size_t>(buffer.size(), 3 * size_t(n)));
+    uint32_t *v1 = buffer.data(), *v2 = v1 + n, *v3 = v2 + n;
+    Load(a, n, v1, v2, v3);
+    Convolution(n, v1, v2, v3, v1, v2, v3);
+    return Restore(n, v1, v2, v3);
   }
 
   static std::vector<TModular> Convolution(const std::vector<TModular>& a,
                                            const std::vector<TModular>& b) {
-    return Restore(TMFFT1::SConvolution(ChangeModular<TModular1>(a),
-                                        ChangeModular<TModular1>(b)),
-                   TMFFT2::SConvolution(ChangeModular<TModular2>(a),
-                                        ChangeModular<TModular2>(b)),
-                   TMFFT3::SConvolution(ChangeModular<TModular3>(a),
-                                        ChangeModular<TModular3>(b)));
+    thread_local std::vector<uint32_t> buffer;
+    const size_t size = a.size() + b.size();
+    const unsigned n = TMFFT1::GetNForFFT(unsigned(size));
+    if constexpr (direct) {
+      if (Direct(n)) return FFTA<TModular>::GetFFT().Convolution(a, b);
+    }
+    buffer.resize(std::max<size_t>(buffer.size(), 6 * size_t(n)));
+    uint32_t *v1 = buffer.data(), *v2 = v1 + n, *v3 = v2 + n, *u1 = v3 + n,
+             *u2 = u1 + n, *u3 = u2 + n;
+    Load(a, n, v1, v2, v3);
+    Load(b, n, u1, u2, u3);
+    Convolution(n, v1, v2, v3, u1, u2, u3);
+    return Restore(n, v1, v2, v3);
   }
 };
 }  // namespace mstatic
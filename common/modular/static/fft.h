@@ -2,15 +2,28 @@
 
 #include "common/base.h"
 #include "common/factorization/utils/factorization_base.h"
+#include "common/modular/static/fft_parallel.h"
+#include "common/modular/static/fft_simd.h"
 #include "common/modular/utils/primitive_root.h"
 #include "common/numeric/bits/ulog2.h"
 
 #include <algorithm>
+#include <atomic>
+#include <bit>
 #include <mutex>
 #include <vector>
 
 namespace modular {
 namespace mstatic {
+// In-place radix-4 NTT. Twiddles use Shoup multiplication and values are
+// kept lazily reduced in [0, 2p) (in [0, p) for p >= 2^31) between
+// butterflies. Levels with at least 8 butterflies per block use AVX2
+// kernels if the CPU supports them (and p < 2^31). Large transforms are
+// split between threads if FFTParallel is enabled. The raw API works on
+// caller-owned uint32_t buffers:
+//   Transform: natural order -> bit-reversed order.
+//   TransformInv: bit-reversed order -> natural order, inverse transform
+//     including division by n.
 template <class TModular, unsigned log2_maxn, unsigned primitive_root>
 class FFT {
  public:
@@ -21,43 +34,73 @@ class FFT {
   static constexpr uint64_t p = TModular::GetMod();
   static constexpr unsigned maxn = (1u << log2_maxn);
   static constexpr TModular primitive = primitive_root;
+  static constexpr bool lazy = (p < (1ull << 31));
+  static constexpr uint64_t p2 = (lazy ? 2 * p : p);
 
+  static_assert(p < (1ull << 32));
   static_assert(((p - 1) % maxn) == 0);
   static_assert(IsPrimitiveRoot(p, FactorizeBase(p - 1), primitive_root));
 
  protected:
   mutable std::mutex m;
-  mutable std::vector<TVector> roots;
-  mutable std::vector<std::vector<unsigned>> bit_rev_map;
+  // roots[k] for block size 2^k and j < 2^(k-2) stores w^j, w^2j, w^3j
+  // with Shoup companions in chunks of 8 j: {w^j}, {w^j}', {w^2j}, ...
+  mutable std::vector<std::vector<uint32_t>> roots;
+  // Number of initialized roots, published after InitK (roots capacity is
+  // reserved, so ready entries are never moved).
+  mutable std::atomic<unsigned> roots_size;
+  uint32_t iroot, iroot_shoup;
 
  protected:
-  constexpr void InitK(unsigned k) const {
-    const uint64_t n = (1u << k);
-    const TModular nroot = primitive.PowU((p - 1) / n);
+  static constexpr uint32_t Shoup(uint64_t w) {
+    return uint32_t((w << 32) / p);
+  }
+
+  // x < 2^32, result in [0, p2).
+  static constexpr uint32_t MultShoup(uint64_t x, uint64_t w, uint64_t ws) {
+    const uint64_t r = x * w - ((x * ws) >> 32) * p;
+    if constexpr (lazy) {
+      return uint32_t(r);
+    } else {
+      return uint32_t((r >= p) ? r - p : r);
+    }
+  }
+
+  // x < 2 * p2, result in [0, p2).
+  static constexpr uint32_t Reduce(uint64_t x) {
+    return uint32_t((x >= p2) ? x - p2 : x);
+  }
+
+  static constexpr uint32_t Normalize(uint32_t x) {
+    return (x >= p) ? x - uint32_t(p) : x;
+  }
+
+  void InitK(unsigned k) const {
+    const unsigned q = (1u << k) / 4;
+    const TModular w = primitive.PowU((p - 1) >> k);
+    std::vector<uint32_t> v(48 * ((q + 7) / 8));
     TModular r(1);
-    roots.push_back({});
-    auto& vr = roots.back();
-    vr.resize(n);
-    for (unsigned i = 0; i < n; ++i) {
-      vr[i] = r;
-      r *= nroot;
+    for (unsigned j = 0; j < q; ++j) {
+      const TModular r2 = r * r, r3 = r2 * r;
+      uint32_t* vj = &v[48 * (j / 8) + (j % 8)];
+      vj[0] = uint32_t(r.Get());
+      vj[8] = Shoup(r.Get());
+      vj[16] = uint32_t(r2.Get());
+      vj[24] = Shoup(r2.Get());
+      vj[32] = uint32_t(r3.Get());
+      vj[40] = Shoup(r3.Get());
+      r *= w;
     }
-    assert(r == 1);
-    bit_rev_map.push_back({});
-    const auto& vbp = bit_rev_map[bit_rev_map.size() - 2];
-    auto& vb = bit_rev_map.back();
-    vb.resize(n);
-    for (unsigned i = 0; i < n; ++i)
-      vb[i] = vbp[i / 2] + ((i & 1) ? n / 2 : 0u);
+    roots.push_back(std::move(v));
   }
 
-  constexpr void Init() {
+  void Init() {
     roots.clear();
     roots.reserve(log2_maxn + 1);
-    roots.push_back({TModular(1u)});
-    bit_rev_map.clear();
-    bit_rev_map.reserve(log2_maxn + 1);
-    bit_rev_map.push_back({0});
+    roots.resize(2);
+    roots_size.store(2, std::memory_order_release);
+    iroot = uint32_t(primitive.PowU((p - 1) / 4).Get());
+    iroot_shoup = Shoup(iroot);
   }
 
   static constexpr void FFTI_Adjust(TVector& output) {
@@ -66,6 +109,147 @@ class FFT {
     for (auto& o : output) o *= invn;
   }
 
+  // Radix-4 butterflies on a[j + i * q] for i < 4, j < count. vr points to
+  // the twiddles for j = 0.
+  void DIF4(uint32_t* a, unsigned q, unsigned count, const uint32_t* vr,
+            [[maybe_unused]] bool use_simd) const {
+#ifdef MSTATIC_FFT_USE_AVX2
+    if (use_simd && (count % 8 == 0))
+      return simd::avx2::DIF4(a, q, count, vr, p, iroot, iroot_shoup);
+#endif
+    uint32_t *a0 = a, *a1 = a0 + q, *a2 = a1 + q, *a3 = a2 + q;
+    for (unsigned j = 0; j < count; ++j) {
+      const uint32_t* w = vr + 48 * (j / 8) + (j % 8);
+      const uint64_t x0 = a0[j], x1 = a1[j], x2 = a2[j], x3 = a3[j];
+      const uint64_t t0 = Reduce(x0 + x2), t1 = Reduce(x0 + p2 - x2),
+                     t2 = Reduce(x1 + x3),
+                     t3 = MultShoup(Reduce(x1 + p2 - x3), iroot, iroot_shoup);
+      a0[j] = Reduce(t0 + t2);
+      a1[j] = MultShoup(Reduce(t0 + p2 - t2), w[16], w[24]);
+      a2[j] = MultShoup(Reduce(t1 + t3), w[0], w[8]);
+      a3[j] = MultShoup(Reduce(t1 + p2 - t3), w[32], w[40]);
+    }
+  }
+
+  void DIT4(uint32_t* a, unsigned q, unsigned count, const uint32_t* vr,
+            [[maybe_unused]] bool use_simd) const {
+#ifdef MSTATIC_FFT_USE_AVX2
+    if (use_simd && (count % 8 == 0))
+      return simd::avx2::DIT4(a, q, count, vr, p, iroot, iroot_shoup);
+#endif
+    uint32_t *a0 = a, *a1 = a0 + q, *a2 = a1 + q, *a3 = a2 + q;
+    for (unsigned j = 0; j < count; ++j) {
+      const uint32_t* w = vr + 48 * (j / 8) + (j % 8);
+      const uint64_t x0 = a0[j], b1 = MultShoup(a1[j], w[16], w[24]),
+                     b2 = MultShoup(a2[j], w[0], w[8]),
+                     b3 = MultShoup(a3[j], w[32], w[40]);
+      const uint64_t s0 = Reduce(x0 + b1), s1 = Reduce(x0 + p2 - b1),
+                     s2 = Reduce(b2 + b3),
+                     s3 = MultShoup(Reduce(b2 + p2 - b3), iroot, iroot_shoup);
+      a0[j] = Reduce(s0 + s2);
+      a1[j] = Reduce(s1 + s3);
+      a2[j] = Reduce(s0 + p2 - s2);
+      a3[j] = Reduce(s1 + p2 - s3);
+    }
+  }
+
+  static void Radix2(unsigned n, uint32_t* a) {
+    for (unsigned s = 0; s < n; s += 2) {
+      const uint64_t x0 = a[s], x1 = a[s + 1];
+      a[s] = Reduce(x0 + x1);
+      a[s + 1] = Reduce(x0 + p2 - x1);
+    }
+  }
+
+  // Splits [0, n) in chunks of size unit for FFTParallel::For.
+  template <class TFunction>
+  static void ForChunks(unsigned n, unsigned unit, const TFunction& f) {
+    FFTParallel::For((n + unit - 1) / unit, [&](size_t i) {
+      const unsigned first = unsigned(i) * unit;
+      f(first, std::min(first + unit, n));
+    });
+  }
+
+  // Chunk size for parallel levels, multiple of 8.
+  static unsigned ParallelUnit(unsigned n) {
+    return std::max(1024u, std::bit_floor(n / (16 * FFTParallel::Threads())));
+  }
+
+  // One radix-4 level with block size m.
+  template <bool dif>
+  void Level(unsigned n, uint32_t* a, unsigned m, bool use_simd,
+             bool parallel) const {
+    const unsigned q = m / 4;
+    const uint32_t* vr = roots[numeric::ULog2(m)].data();
+    auto f = [&](unsigned s, unsigned j, unsigned count) {
+      if constexpr (dif) {
+        DIF4(a + s + j, q, count, vr + 48 * (j / 8), use_simd);
+      } else {
+        DIT4(a + s + j, q, count, vr + 48 * (j / 8), use_simd);
+      }
+    };
+    if (!parallel) {
+      for (unsigned s = 0; s < n; s += m) f(s, 0, q);
+    } else if (const unsigned unit = ParallelUnit(n); q >= unit) {
+      ForChunks(n / 4, unit, [&](unsigned first, unsigned last) {
+        f((first / q) * m, first % q, last - first);
+      });
+    } else {
+      ForChunks(n / m, unit / q, [&](unsigned first, unsigned last) {
+        for (unsigned b = first; b < last; ++b) f(b * m, 0, q);
+      });
+    }
+  }
+
+  void Radix2(unsigned n, uint32_t* a, bool parallel) const {
+    if (!parallel) return Radix2(n, a);
+    ForChunks(n, 2 * ParallelUnit(n), [&](unsigned first, unsigned last) {
+      Radix2(last - first, a + first);
+    });
+  }
+
+  // Decimation in frequency, natural order -> bit-reversed order.
+  void DIF(unsigned n, uint32_t* a) const {
+    const bool use_simd = lazy && simd::UseAVX2(),
+               parallel = FFTParallel::Use(n);
+    unsigned m = n;
+    for (; m >= 4; m /= 4) Level<true>(n, a, m, use_simd, parallel);
+    if (m == 2) Radix2(n, a, parallel);
+  }
+
+  // Decimation in time with the same roots, bit-reversed order -> natural
+  // order. Computes the forward transform (not the inverse).
+  void DIT(unsigned n, uint32_t* a) const {
+    const bool use_simd = lazy && simd::UseAVX2(),
+               parallel = FFTParallel::Use(n);
+    unsigned m = 4;
+    if (numeric::ULog2(n) & 1) {
+      Radix2(n, a, parallel);
+      m = 8;
+    }
+    for (; m <= n; m *= 4) Level<false>(n, a, m, use_simd, parallel);
+  }
+
+  static void BitReverse(unsigned n, uint32_t* a) {
+    for (unsigned i = 1, j = 0; i < n; ++i) {
+      unsigned bit = n >> 1;
+      for (; j & bit; bit >>= 1) j ^= bit;
+      j ^= bit;
+      if (i < j) std::swap(a[i], a[j]);
+    }
+  }
+
+  static void Load(unsigned n, const TVector& vx, uint32_t* a) {
+    const unsigned l = std::min<unsigned>(n, unsigned(vx.size()));
+    for (unsigned i = 0; i < l; ++i) a[i] = uint32_t(vx[i].Get());
+    std::fill(a + l, a + n, 0u);
+  }
+
+  static void Store(unsigned n, const uint32_t* a, TVector& output) {
+    output.resize(n);
+    for (unsigned i = 0; i < n; ++i) output[i] = TModular(Normalize(a[i]));
+  }
+
  public:
   static constexpr unsigned GetNForFFT(unsigned l) {
     unsigned n = 1;
@@ -75,56 +259,112 @@ class FFT {
 
   static constexpr unsigned MaxN() { return maxn; }
 
-  constexpr FFT() { Init(); }
+  FFT() { Init(); }
 
   void AdjustK(unsigned k) const {
-    if (roots.size() <= k) {
+    if (roots_size.load(std::memory_order_acquire) <= k) {
       const std::lock_guard<std::mutex> lock(m);
-      for (unsigned l = roots.size(); l <= k; ++l) InitK(l);
+      for (unsigned l = unsigned(roots.size()); l <= k; ++l) {
+        InitK(l);
+        roots_size.store(l + 1, std::memory_order_release);
+      }
     }
   }
 
-  constexpr TVector Apply(unsigned n, const TVector& vx) const {
+  // a[0, n) with values in [0, p) in natural order. Output is in
+  // bit-reversed order with values in [0, 2p).
+  void Transform(unsigned n, uint32_t* a) const {
+    assert((n > 0) && (maxn % n == 0));
+    AdjustK(numeric::ULog2(n));
+    DIF(n, a);
+  }
+
+  // a[0, n) in bit-reversed order with values as returned by Transform.
+  // Output is the inverse transform in natural order with values in [0, p).
+  void TransformInv(unsigned n, uint32_t* a) const {
     assert((n > 0) && (maxn % n == 0));
-    const unsigned k = numeric::ULog2(n);
-    AdjustK(k);
-    TVector output(n);
-    for (unsigned i = 0; i < n; ++i)
-      output[i] = (bit_rev_map[k][i] < vx.size()) ? vx[bit_rev_map[k][i]] : 0;
-
-    TVector current(n);
-    for (unsigned l = 1, kl = 1; l < n; l <<= 1, ++kl) {
-      const TVector& current_roots = roots[kl];
-      for (unsigned pdest = 0; pdest < n; pdest += l) {
-        for (unsigned i = 0; i < l; ++i, ++pdest) {
-          const TModular v = current_roots[i] * output[pdest + l];
-          current[pdest] = output[pdest] + v;
-          current[pdest + l] = output[pdest] - v;
-        }
+    AdjustK(numeric::ULog2(n));
+    DIT(n, a);
+    const uint32_t invn = uint32_t(TModular(n).Inverse().Get()),
+                   invn_shoup = Shoup(invn);
+    // Reverse a[1, n) and divide by n.
+    auto f = [&](unsigned first, unsigned last) {
+      for (unsigned i = first; i < last; ++i) {
+        const uint32_t x = a[i];
+        a[i] = Normalize(MultShoup(a[n - i], invn, invn_shoup));
+        if (i != n - i) a[n - i] = Normalize(MultShoup(x, invn, invn_shoup));
       }
-      output.swap(current);
+    };
+    a[0] = Normalize(MultShoup(a[0], invn, invn_shoup));
+    if (FFTParallel::Use(n)) {
+      ForChunks(n / 2, ParallelUnit(n), [&](unsigned first, unsigned last) {
+        f(first + 1, last + 1);
+      });
+    } else {
+      f(1, n / 2 + 1);
     }
+  }
+
+  // a = a * b (cyclic convolution of length n), both buffers are caller
+  // owned. b is overwritten. a and b could be the same buffer.
+  void ConvolutionInPlace(unsigned n, uint32_t* a, uint32_t* b) const {
+    if (!FFTParallel::Use(n)) {
+      Transform(n, a);
+      if (b != a) Transform(n, b);
+      simd::MultPointwise(a, b, n, p);
+    } else {
+      FFTParallel::For((b != a) ? 2 : 1,
+                       [&](size_t i) { Transform(n, i ? b : a); });
+      ForChunks(n, ParallelUnit(n), [&](unsigned first, unsigned last) {
+        simd::MultPointwise(a + first, b + first, last - first, p);
+      });
+    }
+    TransformInv(n, a);
+  }
+
+  TVector Apply(unsigned n, const TVector& vx) const {
+    thread_local std::vector<uint32_t> buffer;
+    buffer.resize(std::max<size_t>(buffer.size(), n));
+    Load(n, vx, buffer.data());
+    Transform(n, buffer.data());
+    BitReverse(n, buffer.data());
+    TVector output;
+    Store(n, buffer.data(), output);
     return output;
   }
 
-  constexpr TVector ApplyInv(unsigned n, const TVector& vx) const {
+  TVector ApplyInv(unsigned n, const TVector& vx) const {
     TVector output = Apply(n, vx);
     FFTI_Adjust(output);
     return output;
   }
 
-  constexpr TVector Convolution(const TVector& vx) const {
-    const unsigned n = GetNForFFT(unsigned(2 * vx.size()));
-    auto vf = Apply(n, vx);
-    for (auto& f : vf) f *= f;
-    return ApplyInv(n, vf);
+  void Convolution(const TVector& vx1, const TVector& vx2,
+                   TVector& output) const {
+    thread_local std::vector<uint32_t> buffer1, buffer2;
+    const unsigned n = GetNForFFT(unsigned(vx1.size() + vx2.size()));
+    buffer1.resize(std::max<size_t>(buffer1.size(), n));
+    Load(n, vx1, buffer1.data());
+    if (&vx1 == &vx2) {
+      ConvolutionInPlace(n, buffer1.data(), buffer1.data());
+    } else {
+      buffer2.resize(std::max<size_t>(buffer2.size(), n));
+      Load(n, vx2, buffer2.data());
+      ConvolutionInPlace(n, buffer1.data(), buffer2.data());
+    }
+    Store(n, buffer1.data(), output);
   }
 
-  constexpr TVector Convolution(const TVector& vx1, const TVector& vx2) const {
-    const unsigned n = GetNForFFT(unsigned(vx1.size() + vx2.size()));
-    auto vf1 = Apply(n, vx1), vf2 = Apply(n, vx2);
-    for (unsigned i = 0; i < n; ++i) vf1[i] *= vf2[i];
-    return ApplyInv(n, vf1);
+  TVector Convolution(const TVector& vx) const {
+    TVector output;
+    Convolution(vx, vx, output);
+    return output;
+  }
+
+  TVector Convolution(const TVector& vx1, const TVector& vx2) const {
+    TVector output;
+    Convolution(vx1, vx2, output);
+    return output;
   }
 
  public:
@@ -134,19 +374,18 @@ class FFT {
   }
 
   static TVector SApply(unsigned n, const TVector& vx) {
-    GetFFT().Apply(n, vx);
+    return GetFFT().Apply(n, vx);
   }
 
   static TVector SApplyInv(unsigned n, const TVector& vx) {
-    GetFFT().ApplyInv(n, vx);
+    return GetFFT().ApplyInv(n, vx);
   }
 
-  static constexpr TVector SConvolution(const TVector& vx) {
+  static TVector SConvolution(const TVector& vx) {
     return GetFFT().Convolution(vx);
   }
 
-  static constexpr TVector SConvolution(const TVector& vx1,
-                                        const TVector& vx2) {
+  static TVector SConvolution(const TVector& vx1, const TVector& vx2) {
     return GetFFT().Convolution(vx1, vx2);
   }
 };
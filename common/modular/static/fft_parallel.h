@@ -0,0 +1,63 @@
+#pragma once
+
+#include "common/base.h"
+#include "common/thread_pool.h"
+
+#include <algorithm>
+#include <memory>
+#include <thread>
+
+namespace modular {
+namespace mstatic {
+// Opt-in multithreading for FFT based convolutions, disabled by default.
+// Transforms with length below min_size always run in the calling thread.
+// Enable and Disable should not be called while transforms are running.
+class FFTParallel {
+ public:
+  static constexpr size_t default_min_size = (1u << 16);
+
+ protected:
+  struct State {
+    std::unique_ptr<ThreadPool> pool;
+    unsigned threads = 1;
+    size_t min_size = default_min_size;
+  };
+
+  static State& GetState() {
+    static State s;
+    return s;
+  }
+
+ public:
+  static void Enable(unsigned threads = std::thread::hardware_concurrency(),
+                     size_t min_size = default_min_size) {
+    auto& s = GetState();
+    s.pool.reset();
+    s.threads = std::max(threads, 1u);
+    s.min_size = min_size;
+    if (s.threads > 1) s.pool = std::make_unique<ThreadPool>(s.threads - 1);
+  }
+
+  static void Disable() { Enable(1); }
+
+  static unsigned Threads() { return GetState().threads; }
+
+  static bool Use(size_t n) {
+    const auto& s = GetState();
+    return (s.threads > 1) && (n >= s.min_size);
+  }
+
+  // Runs f(i) for i in [0, n). The calling thread takes part in the work,
+  // nested calls from tasks are safe.
+  template <class TFunction>
+  static void For(size_t n, const TFunction& f) {
+    auto& s = GetState();
+    if (s.threads <= 1) {
+      for (size_t i = 0; i < n; ++i) f(i);
+    } else {
+      s.pool->ParallelFor(0, n, f, 1);
+    }
+  }
+};
+}  // namespace mstatic
+}  // namespace modular
@@ -0,0 +1,207 @@
+#pragma once
+
+#include "common/base.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define MSTATIC_FFT_USE_AVX2
+#endif
+
+namespace modular {
+namespace mstatic {
+namespace simd {
+inline bool HasAVX2() {
+#ifdef MSTATIC_FFT_USE_AVX2
+  return __builtin_cpu_supports("avx2");
+#else
+  return false;
+#endif
+}
+
+// Runtime switch for AVX2 kernels, initialized from CPUID. Could be turned
+// off to compare with the scalar fallback.
+inline bool& UseAVX2() {
+  static bool avx2 = HasAVX2();
+  return avx2;
+}
+
+// x^-1 mod 2^32 for odd x.
+constexpr uint32_t InverseMod32(uint32_t x) {
+  uint32_t r = x;
+  for (unsigned i = 0; i < 5; ++i) r *= 2 - x * r;
+  return r;
+}
+
+#ifdef MSTATIC_FFT_USE_AVX2
+// Kernels for p < 2^31 working on 8 lanes of 32 bits. Values are kept in
+// [0, p) and all pointers could be unaligned.
+namespace avx2 {
+#define MSTATIC_FFT_TARGET_AVX2 __attribute__((target("avx2")))
+
+MSTATIC_FFT_TARGET_AVX2 inline __m256i Load(const uint32_t* a) {
+  return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a));
+}
+
+MSTATIC_FFT_TARGET_AVX2 inline void Store(uint32_t* a, __m256i x) {
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(a), x);
+}
+
+// x < 2p
+MSTATIC_FFT_TARGET_AVX2 inline __m256i Normalize(__m256i x, __m256i p) {
+  return _mm256_min_epu32(x, _mm256_sub_epi32(x, p));
+}
+
+MSTATIC_FFT_TARGET_AVX2 inline __m256i Add(__m256i x, __m256i y, __m256i p) {
+  return Normalize(_mm256_add_epi32(x, y), p);
+}
+
+MSTATIC_FFT_TARGET_AVX2 inline __m256i Sub(__m256i x, __m256i y, __m256i p) {
+  return Normalize(_mm256_add_epi32(_mm256_sub_epi32(x, y), p), p);
+}
+
+MSTATIC_FFT_TARGET_AVX2 inline __m256i MultHigh(__m256i x, __m256i y) {
+  const __m256i e = _mm256_srli_epi64(_mm256_mul_epu32(x, y), 32),
+                o = _mm256_mul_epu32(_mm256_srli_epi64(x, 32),
+                                     _mm256_srli_epi64(y, 32));
+  return _mm256_blend_epi32(e, o, 0xAA);
+}
+
+// x * w mod p, ws = floor(w * 2^32 / p), x < 2^32.
+MSTATIC_FFT_TARGET_AVX2 inline __m256i MultShoup(__m256i x, __m256i w,
+                                                 __m256i ws, __m256i p) {
+  const __m256i q = MultHigh(x, ws);
+  return Normalize(
+      _mm256_sub_epi32(_mm256_mullo_epi32(x, w), _mm256_mullo_epi32(q, p)), p);
+}
+
+// x * y * 2^-32 mod p, pinv = p^-1 mod 2^32, x, y < p.
+MSTATIC_FFT_TARGET_AVX2 inline __m256i MultMontgomery(__m256i x, __m256i y,
+                                                      __m256i p,
+                                                      __m256i pinv) {
+  const __m256i xye = _mm256_mul_epu32(x, y),
+                xyo = _mm256_mul_epu32(_mm256_srli_epi64(x, 32),
+                                       _mm256_srli_epi64(y, 32));
+  const __m256i te = _mm256_sub_epi64(
+                    xye, _mm256_mul_epu32(_mm256_mul_epu32(xye, pinv), p)),
+                to = _mm256_sub_epi64(
+                    xyo, _mm256_mul_epu32(_mm256_mul_epu32(xyo, pinv), p));
+  const __m256i t = _mm256_blend_epi32(_mm256_srli_epi64(te, 32), to, 0xAA);
+  return _mm256_min_epu32(t, _mm256_add_epi32(t, p));
+}
+
+// Radix-4 decimation in frequency butterflies on a[j + i * q] for i < 4,
+// j < count, count % 8 = 0. vr holds twiddles in chunks of 8: {w^j}, {w^j}',
+// {w^2j}, {w^2j}', {w^3j}, {w^3j}'.
+MSTATIC_FFT_TARGET_AVX2 inline void DIF4(uint32_t* a, unsigned q,
+                                         unsigned count, const uint32_t* vr,
+                                         uint32_t p, uint32_t iroot,
+                                         uint32_t iroot_shoup) {
+  const __m256i vp = _mm256_set1_epi32(int(p)),
+                vi = _mm256_set1_epi32(int(iroot)),
+                vis = _mm256_set1_epi32(int(iroot_shoup));
+  uint32_t *a0 = a, *a1 = a0 + q, *a2 = a1 + q, *a3 = a2 + q;
+  for (unsigned j = 0; j < count; j += 8, vr += 48) {
+    const __m256i x0 = Normalize(Load(a0 + j), vp),
+                  x1 = Normalize(Load(a1 + j), vp),
+                  x2 = Normalize(Load(a2 + j), vp),
+                  x3 = Normalize(Load(a3 + j), vp);
+    const __m256i t0 = Add(x0, x2, vp), t1 = Sub(x0, x2, vp),
+                  t2 = Add(x1, x3, vp),
+                  t3 = MultShoup(Sub(x1, x3, vp), vi, vis, vp);
+    Store(a0 + j, Add(t0, t2, vp));
+    Store(a1 + j,
+          MultShoup(Sub(t0, t2, vp), Load(vr + 16), Load(vr + 24), vp));
+    Store(a2 + j, MultShoup(Add(t1, t3, vp), Load(vr), Load(vr + 8), vp));
+    Store(a3 + j,
+          MultShoup(Sub(t1, t3, vp), Load(vr + 32), Load(vr + 40), vp));
+  }
+}
+
+// Radix-4 decimation in time butterflies, same layout as DIF4.
+MSTATIC_FFT_TARGET_AVX2 inline void DIT4(uint32_t* a, unsigned q,
+                                         unsigned count, const uint32_t* vr,
+                                         uint32_t p, uint32_t iroot,
+                                         uint32_t iroot_shoup) {
+  const __m256i vp = _mm256_set1_epi32(int(p)),
+                vi = _mm256_set1_epi32(int(iroot)),
+                vis = _mm256_set1_epi32(int(iroot_shoup));
+  uint32_t *a0 = a, *a1 = a0 + q, *a2 = a1 + q, *a3 = a2 + q;
+  for (unsigned j = 0; j < count; j += 8, vr += 48) {
+    const __m256i x0 = Normalize(Load(a0 + j), vp),
+                  b1 = MultShoup(Load(a1 + j), Load(vr + 16), Load(vr + 24),
+                                 vp),
+                  b2 = MultShoup(Load(a2 + j), Load(vr), Load(vr + 8), vp),
+                  b3 = MultShoup(Load(a3 + j), Load(vr + 32), Load(vr + 40),
+                                 vp);
+    const __m256i s0 = Add(x0, b1, vp), s1 = Sub(x0, b1, vp),
+                  s2 = Add(b2, b3, vp),
+                  s3 = MultShoup(Sub(b2, b3, vp), vi, vis, vp);
+    Store(a0 + j, Add(s0, s2, vp));
+    Store(a1 + j, Add(s1, s3, vp));
+    Store(a2 + j, Sub(s0, s2, vp));
+    Store(a3 + j, Sub(s1, s3, vp));
+  }
+}
+
+// a[i] = a[i] * b[i] mod p for a[i], b[i] < 2p, i < n, n % 8 = 0.
+MSTATIC_FFT_TARGET_AVX2 inline void MultPointwise(uint32_t* a,
+                                                  const uint32_t* b, size_t n,
+                                                  uint32_t p) {
+  const uint64_t r = (1ull << 32) % p;
+  const __m256i vp = _mm256_set1_epi32(int(p)),
+                vpinv = _mm256_set1_epi32(int(InverseMod32(p))),
+                vr = _mm256_set1_epi32(int(r)),
+                vrs = _mm256_set1_epi32(int((r << 32) / p));
+  for (size_t i = 0; i < n; i += 8) {
+    const __m256i x = MultMontgomery(Normalize(Load(a + i), vp),
+                                     Normalize(Load(b + i), vp), vp, vpinv);
+    Store(a + i, MultShoup(x, vr, vrs, vp));
+  }
+}
+
+// b[i] = (b[i] - a[i]) * c mod q, c < q, i < n, n % 8 = 0.
+MSTATIC_FFT_TARGET_AVX2 inline void GarnerStep(const uint32_t* a, uint32_t* b,
+                                               size_t n, uint32_t q,
+                                               uint32_t c) {
+  const __m256i vq = _mm256_set1_epi32(int(q)),
+                vc = _mm256_set1_epi32(int(c)),
+                vcs = _mm256_set1_epi32(int((uint64_t(c) << 32) / q));
+  for (size_t i = 0; i < n; i += 8) {
+    Store(b + i, Sub(MultShoup(Load(b + i), vc, vcs, vq),
+                     MultShoup(Load(a + i), vc, vcs, vq), vq));
+  }
+}
+#undef MSTATIC_FFT_TARGET_AVX2
+}  // namespace avx2
+#endif
+
+// a[i] = a[i] * b[i] mod p for a[i], b[i] < 2p.
+inline void MultPointwise(uint32_t* a, const uint32_t* b, size_t n,
+                          uint64_t p) {
+  size_t i = 0;
+#ifdef MSTATIC_FFT_USE_AVX2
+  if ((p < (1ull << 31)) && UseAVX2()) {
+    i = n & ~size_t(7);
+    avx2::MultPointwise(a, b, i, uint32_t(p));
+  }
+#endif
+  for (; i < n; ++i) a[i] = uint32_t((uint64_t(a[i]) * b[i]) % p);
+}
+
+// Mixed radix digit from Chinese remainder theorem:
+// b[i] = (b[i] - a[i]) * c mod q, c < q.
+inline void GarnerStep(const uint32_t* a, uint32_t* b, size_t n, uint64_t q,
+                       uint64_t c) {
+  size_t i = 0;
+#ifdef MSTATIC_FFT_USE_AVX2
+  if ((q < (1ull << 31)) && UseAVX2()) {
+    i = n & ~size_t(7);
+    avx2::GarnerStep(a, b, i, uint32_t(q), uint32_t(c));
+  }
+#endif
+  for (; i < n; ++i)
+    b[i] = uint32_t(((b[i] % q + q - a[i] % q) % q) * c % q);
+}
+}  // namespace simd
+}  // namespace mstatic
+}  // namespace modular
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "common/base.h"
+#include "common/modular/arithmetic.h"
+#include "common/modular/utils/legendre_symbol.h"
+
+#include <algorithm>
+
+// Tonelli-Shanks algorithm, a should be a quadratic residue modulo prime p.
+// Returns the smaller root.
+template <class TModularA = modular::TArithmetic_P32U>
+constexpr uint64_t SqrtModPrime(uint64_t a, uint64_t p) {
+  a %= p;
+  if ((p == 2) || (a == 0)) return a;
+  assert(LegendreSymbol<TModularA>(a, p) == 1);
+  uint64_t q = p - 1;
+  unsigned s = 0;
+  for (; (q & 1) == 0; q >>= 1) ++s;
+  uint64_t z = 2;
+  for (; LegendreSymbol<TModularA>(z, p) != -1;) ++z;
+  uint64_t c = TModularA::PowU(z, q, p), t = TModularA::PowU(a, q, p),
+           x = TModularA::PowU(a, (q + 1) / 2, p);
+  for (unsigned m = s; t != 1;) {
+    unsigned i = 0;
+    for (uint64_t tt = t; tt != 1; tt = TModularA::Sqr(tt, p)) ++i;
+    uint64_t b = c;
+    for (unsigned j = i + 1; j < m; ++j) b = TModularA::Sqr(b, p);
+    x = TModularA::Mult(x, b, p);
+    c = TModularA::Sqr(b, p);
+    t = TModularA::Mult(t, c, p);
+    m = i;
+  }
+  return std::min(x, p - x);
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "common/numeric/long/division/base.h"
+#include "common/numeric/long/division/recursive.h"
+#include "common/numeric/long/unsigned.h"
+
+#include <utility>
+
+namespace numeric {
+namespace nlong {
+namespace division {
+inline std::pair<Unsigned, Unsigned> DivModAuto(const Unsigned& a,
+                                                const Unsigned& b) {
+  return ((b.Size() < 1000) || (a.Size() < b.Size() + 1000))
+             ? DivModBase(a, b)
+             : DivModRecursive(a, b);
+}
+}  // namespace division
+}  // namespace nlong
+}  // namespace numeric
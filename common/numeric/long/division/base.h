@@ -0,0 +1,16 @@
+#pragma once
+
+#include "common/numeric/long/unsigned.h"
+
+#include <utility>
+
+namespace numeric {
+namespace nlong {
+namespace division {
+constexpr std::pair<Unsigned, Unsigned> DivModBase(const Unsigned& a,
+                                                   const Unsigned& b) {
+  return a.DivModBase(b);
+}
+}  // namespace division
+}  // namespace nlong
+}  // namespace numeric
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "common/numeric/long/unsigned.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace numeric {
+namespace nlong {
+namespace division {
+// Restoring division, one bit per iteration.
+constexpr std::pair<Unsigned, Unsigned> DivModBits(const Unsigned& a,
+                                                   const Unsigned& b) {
+  assert(!b.Empty());
+  if (a.Empty()) return {};
+  Unsigned tl(a), tr(b), q;
+  const size_t total_shift = 1 + std::max(a.Size(), b.Size()) - b.Size();
+  tr.ShiftBlocksRight(total_shift);
+  for (size_t i = 0; i < 32 * total_shift; ++i) {
+    q.ShiftBitsRight(1);
+    tr.ShiftBitsLeft(1);
+    if (tr <= tl) {
+      tl -= tr;
+      q += 1;
+    }
+  }
+  return {q, tl};
+}
+}  // namespace division
+}  // namespace nlong
+}  // namespace numeric
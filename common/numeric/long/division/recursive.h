@@ -0,0 +1,104 @@
+#pragma once
+
+#include "common/numeric/long/division/base.h"
+#include "common/numeric/long/unsigned.h"
+#include "common/numeric/long/unsigned/multiplication.h"
+#include "common/numeric/long/unsigned/ulog2.h"
+
+#include <algorithm>
+#include <tuple>
+#include <utility>
+
+namespace numeric {
+namespace nlong {
+namespace division {
+// Burnikel-Ziegler recursive division, O(M(n) log n).
+class Recursive {
+ public:
+  using TData = Unsigned::TData;
+  using TPair = std::pair<Unsigned, Unsigned>;
+
+ protected:
+  static constexpr size_t base_limit = 128;
+
+ protected:
+  // Blocks [first, last) of a.
+  static Unsigned Blocks(const Unsigned& a, size_t first, size_t last) {
+    first = std::min(first, a.Size());
+    last = std::min(last, a.Size());
+    const auto& v = a.Data();
+    return Unsigned(TData(v.begin() + first, v.begin() + last));
+  }
+
+  // high * 2^(32 * shift) + low, low < 2^(32 * shift).
+  static Unsigned Join(const Unsigned& high, const Unsigned& low,
+                       size_t shift) {
+    assert(low.Size() <= shift);
+    if (high.Empty()) return low;
+    TData v(low.Data());
+    v.resize(shift, 0);
+    v.insert(v.end(), high.Data().begin(), high.Data().end());
+    return Unsigned(v);
+  }
+
+  // b has exactly n blocks with highest bit set, a < b * 2^(32 * n).
+  static TPair Div2n1n(const Unsigned& a, const Unsigned& b, size_t n) {
+    if ((n & 1) || (n < base_limit)) return DivModBase(a, b);
+    const size_t h = n / 2;
+    auto [q1, r1] = Div3n2n(Blocks(a, h, 4 * h), b, h);
+    auto [q2, r2] = Div3n2n(Join(r1, Blocks(a, 0, h), h), b, h);
+    return {Join(q1, q2, h), r2};
+  }
+
+  // b has exactly 2h blocks with highest bit set, a < b * 2^(32 * h).
+  static TPair Div3n2n(const Unsigned& a, const Unsigned& b, size_t h) {
+    const Unsigned a1 = Blocks(a, 2 * h, 3 * h), b1 = Blocks(b, h, 2 * h);
+    Unsigned q, r;
+    if (a1 < b1) {
+      std::tie(q, r) = Div2n1n(Blocks(a, h, 3 * h), b1, h);
+    } else {
+      q = Unsigned(TData(h, ~0u));
+      r = (Blocks(a, h, 3 * h) + b1) - Join(b1, Unsigned(), h);
+    }
+    const Unsigned d = Mult(q, Blocks(b, 0, h));
+    r = Join(r, Blocks(a, 0, h), h);
+    for (; r < d; r += b) q -= Unsigned(1u);
+    return {q, r - d};
+  }
+
+ public:
+  static TPair DivMod(const Unsigned& a, const Unsigned& b) {
+    assert(!b.Empty());
+    if ((b.Size() < base_limit) || (a.Size() < b.Size() + base_limit))
+      return DivModBase(a, b);
+    size_t m = 1;
+    for (; m * base_limit <= b.Size();) m *= 2;
+    const size_t n = ((b.Size() - 1) / m + 1) * m;
+    const size_t shift = 32 * (n - b.Size()) + __builtin_clz(b.Data().back());
+    const Unsigned bb = b << shift, aa = a << shift;
+    assert(bb.Size() == n);
+    const size_t t =
+        std::max<size_t>(2, (ULog2(aa) + 32 * n + 1) / (32 * n));
+    TData q((t - 1) * n);
+    Unsigned z = Blocks(aa, (t - 2) * n, t * n), r;
+    for (size_t i = t - 1; i--;) {
+      auto [qi, ri] = Div2n1n(z, bb, n);
+      std::copy(qi.Data().begin(), qi.Data().end(), q.begin() + i * n);
+      if (i) {
+        z = Join(ri, Blocks(aa, (i - 1) * n, i * n), n);
+      } else {
+        r.swap(ri);
+      }
+    }
+    r >>= shift;
+    return {Unsigned(q), r};
+  }
+};
+
+inline std::pair<Unsigned, Unsigned> DivModRecursive(const Unsigned& a,
+                                                     const Unsigned& b) {
+  return Recursive::DivMod(a, b);
+}
+}  // namespace division
+}  // namespace nlong
+}  // namespace numeric
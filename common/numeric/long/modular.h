@@ -3,6 +3,7 @@
 #include "common/base.h"
 #include "common/modular/arithmetic.h"
 #include "common/numeric/long/unsigned.h"
+#include "common/numeric/long/unsigned/division.h"
 #include "common/numeric/long/unsigned/multiplication.h"
 
 namespace numeric {
@@ -13,7 +14,7 @@ class Modular {
   static consteval bool IsModPrime() { return is_prime; }
 
   static constexpr Unsigned Apply(const Unsigned& value, const Unsigned& mod) {
-    return value % mod;
+    return Mod(value, mod);
   }
 
   static constexpr Unsigned Add(const Unsigned& lvalue, const Unsigned& rvalue,
@@ -50,7 +51,7 @@ class Modular {
 
   static constexpr Unsigned Mult(const Unsigned& lvalue, const Unsigned& rvalue,
                                  const Unsigned& mod) {
-    return numeric::nlong::Mult(lvalue, rvalue) % mod;
+    return Mod(numeric::nlong::Mult(lvalue, rvalue), mod);
   }
 
   static constexpr Unsigned MultSafe(const Unsigned& lvalue,
@@ -60,7 +61,7 @@ class Modular {
   }
 
   static constexpr Unsigned Sqr(const Unsigned& value, const Unsigned& mod) {
-    return numeric::nlong::Sqr(value) % mod;
+    return Mod(numeric::nlong::Sqr(value), mod);
   }
 
   static constexpr Unsigned SqrSafe(const Unsigned& value,
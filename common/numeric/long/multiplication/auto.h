@@ -2,18 +2,27 @@
 
 #include "common/numeric/long/multiplication/base.h"
 #include "common/numeric/long/multiplication/fft.h"
+#include "common/numeric/long/multiplication/toom.h"
 #include "common/numeric/long/unsigned.h"
 
+#include <algorithm>
+
 namespace numeric {
 namespace nlong {
 namespace multiplication {
+constexpr size_t auto_fft_cutoff = 2000;
+
 inline Unsigned SqrAuto(const Unsigned& a) {
-  return (a.Size() < 100) ? SqrBase(a) : SqrFFT(a);
+  return (a.Size() < Toom::default_karatsuba_cutoff) ? SqrBase(a)
+         : (a.Size() < auto_fft_cutoff)              ? SqrToom(a)
+                                                     : SqrFFT(a);
 }
 
 inline Unsigned MultAuto(const Unsigned& a, const Unsigned& b) {
-  return ((a.Size() < 100) || (b.Size() < 100)) ? MultBase(a, b)
-                                                : MultFFT(a, b);
+  const size_t l = std::min(a.Size(), b.Size());
+  return (l < Toom::default_karatsuba_cutoff) ? MultBase(a, b)
+         : (l < auto_fft_cutoff)              ? MultToom(a, b)
+                                              : MultFFT(a, b);
 }
 }  // namespace multiplication
 }  // namespace nlong
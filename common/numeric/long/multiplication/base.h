@@ -2,16 +2,34 @@
 
 #include "common/numeric/long/unsigned.h"
 
+#include <algorithm>
+
 namespace numeric {
 namespace nlong {
 namespace multiplication {
-constexpr Unsigned MultBase(const Unsigned& a, const Unsigned& b) {
-  Unsigned r;
-  for (auto it = b.end(); it != b.begin();) {
-    r.ShiftBlocksRight(1);
-    r += a * *(--it);
+// r[0, na + nb) = a * b, r must not overlap with a or b.
+constexpr void MultBase(const uint32_t* a, size_t na, const uint32_t* b,
+                        size_t nb, uint32_t* r) {
+  std::fill(r, r + na + nb, 0u);
+  for (size_t i = 0; i < nb; ++i, ++r) {
+    const uint64_t bi = b[i];
+    uint64_t t64 = 0;
+    if (bi) {
+      for (size_t j = 0; j < na; ++j) {
+        t64 += a[j] * bi + r[j];
+        r[j] = uint32_t(t64);
+        t64 >>= 32;
+      }
+    }
+    r[na] = uint32_t(t64);
   }
-  return r;
+}
+
+constexpr Unsigned MultBase(const Unsigned& a, const Unsigned& b) {
+  if (a.Empty() || b.Empty()) return Unsigned();
+  Unsigned::TData v(a.Size() + b.Size());
+  MultBase(a.Data().data(), a.Size(), b.Data().data(), b.Size(), v.data());
+  return Unsigned(v);
 }
 
 constexpr Unsigned SqrBase(const Unsigned& a) { return MultBase(a, a); }
@@ -2,9 +2,11 @@
 
 #include "common/modular.h"
 #include "common/modular/static/fft.h"
-#include "common/modular/utils/merge_remainders.h"
+#include "common/modular/static/fft_parallel.h"
+#include "common/modular/static/fft_simd.h"
 #include "common/numeric/long/unsigned.h"
 
+#include <algorithm>
 #include <vector>
 
 namespace numeric {
@@ -24,25 +26,23 @@ class FFT {
   using TMFFT2 = modular::mstatic::FFT<TModular2, log2_maxn + 1u, 13>;
 
  protected:
-  template <class TModular>
-  static constexpr std::vector<TModular> Convert(const Unsigned& a) {
-    std::vector<TModular> v;
-    v.reserve(2 * a.Size());
-    for (auto ai : a) {
-      v.push_back(ai & mask16);
-      v.push_back(ai >> 16);
+  static void Convert(const Unsigned& a, unsigned n, uint32_t* v) {
+    const size_t l = a.Size();
+    for (size_t i = 0; i < l; ++i) {
+      v[2 * i] = a.Data()[i] & mask16;
+      v[2 * i + 1] = a.Data()[i] >> 16;
     }
-    return v;
+    std::fill(v + 2 * l, v + n, 0u);
   }
 
-  static constexpr Unsigned Restore(const std::vector<TModular1>& v1,
-                                    const std::vector<TModular2>& v2) {
-    assert(v1.size() == v2.size());
+  static Unsigned Restore(unsigned n, const uint32_t* v1, uint32_t* v2) {
+    constexpr uint64_t p1 = TModular1::GetMod(),
+                       c12 = TModular2(p1).Inverse().Get();
+    modular::mstatic::simd::GarnerStep(v1, v2, n, TModular2::GetMod(), c12);
     uint64_t t64 = 0;
-    Unsigned::TData v(v1.size() / 2, 0);
-    for (size_t i = 0; i < v1.size(); ++i) {
-      t64 += MergeRemainders<modular::TArithmetic_P32U>(
-          TModular1::GetMod(), v1[i].Get(), TModular2::GetMod(), v2[i].Get());
+    Unsigned::TData v(n / 2, 0);
+    for (size_t i = 0; i < n; ++i) {
+      t64 += v1[i] + p1 * v2[i];
       const uint32_t t16 = uint32_t(t64) & mask16;
       v[i / 2] += (i % 2) ? (t16 << 16) : t16;
       t64 >>= 16;
@@ -51,20 +51,50 @@ class FFT {
     return Unsigned(v);
   }
 
+  static Unsigned MultI(const Unsigned& a, const Unsigned& b, bool sqr) {
+    thread_local std::vector<uint32_t> buffer;
+    const unsigned n =
+        TMFFT1::GetNForFFT(unsigned(2 * (a.Size() + b.Size())));
+    buffer.resize(std::max<size_t>(buffer.size(), 4 * size_t(n)));
+    uint32_t *v1 = buffer.data(), *v2 = v1 + n, *u1 = v2 + n, *u2 = u1 + n;
+    Convert(a, n, v1);
+    Convert(a, n, v2);
+    if (sqr) {
+      u1 = v1;
+      u2 = v2;
+    } else {
+      Convert(b, n, u1);
+      Convert(b, n, u2);
+    }
+    auto f = [&](size_t i) {
+      if (i == 0) {
+        TMFFT1::GetFFT().ConvolutionInPlace(n, v1, u1);
+      } else {
+        TMFFT2::GetFFT().ConvolutionInPlace(n, v2, u2);
+      }
+    };
+    if (modular::mstatic::FFTParallel::Use(n)) {
+      modular::mstatic::FFTParallel::For(2, f);
+    } else {
+      f(0);
+      f(1);
+    }
+    return Restore(n, v1, v2);
+  }
+
  public:
   static consteval uint64_t MaxN() { return (1ull << log2_maxn); }
 
   static Unsigned Sqr(const Unsigned& a) {
     assert(2 * a.Size() <= MaxN());
-    return Restore(TMFFT1::SConvolution(Convert<TModular1>(a)),
-                   TMFFT2::SConvolution(Convert<TModular2>(a)));
+    if (a.Empty()) return Unsigned();
+    return MultI(a, a, true);
   }
 
   static Unsigned Mult(const Unsigned& a, const Unsigned& b) {
     assert((a.Size() + b.Size()) <= (1u << log2_maxn));
-    return Restore(
-        TMFFT1::SConvolution(Convert<TModular1>(a), Convert<TModular1>(b)),
-        TMFFT2::SConvolution(Convert<TModular2>(a), Convert<TModular2>(b)));
+    if (a.Empty() || b.Empty()) return Unsigned();
+    return MultI(a, b, false);
   }
 };
 
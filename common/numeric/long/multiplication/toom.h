@@ -0,0 +1,294 @@
+#pragma once
+
+#include "common/numeric/long/multiplication/base.h"
+#include "common/numeric/long/unsigned.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace numeric {
+namespace nlong {
+namespace multiplication {
+// Schoolbook, Karatsuba and Toom-3 multiplication on raw blocks. All
+// temporary buffers are taken from one arena allocated per top level call.
+class Toom {
+ public:
+  static constexpr size_t default_karatsuba_cutoff = 40;
+  static constexpr size_t default_toom3_cutoff = 400;
+
+ protected:
+  size_t karatsuba_cutoff, toom3_cutoff;
+  std::vector<uint32_t> arena;
+  size_t arena_top = 0;
+
+ protected:
+  uint32_t* Allocate(size_t n) {
+    assert(arena_top + n <= arena.size());
+    uint32_t* p = arena.data() + arena_top;
+    arena_top += n;
+    return p;
+  }
+
+  // r[0, n) = a + b, returns carry. r may be equal to a or b.
+  static uint32_t AddN(uint32_t* r, const uint32_t* a, const uint32_t* b,
+                       size_t n) {
+    uint64_t t64 = 0;
+    for (size_t i = 0; i < n; ++i) {
+      t64 += uint64_t(a[i]) + b[i];
+      r[i] = uint32_t(t64);
+      t64 >>= 32;
+    }
+    return uint32_t(t64);
+  }
+
+  // r[0, n) = a - b, returns borrow. r may be equal to a or b.
+  static uint32_t SubN(uint32_t* r, const uint32_t* a, const uint32_t* b,
+                       size_t n) {
+    int64_t i64 = 0;
+    for (size_t i = 0; i < n; ++i) {
+      i64 += int64_t(a[i]) - int64_t(b[i]);
+      r[i] = uint32_t(i64);
+      i64 >>= 32;
+    }
+    return uint32_t(-i64);
+  }
+
+  // r[0, nr) += a[0, na), na <= nr, returns carry.
+  static uint32_t AddTo(uint32_t* r, size_t nr, const uint32_t* a,
+                        size_t na) {
+    uint64_t t64 = 0;
+    size_t i = 0;
+    for (; i < na; ++i) {
+      t64 += uint64_t(r[i]) + a[i];
+      r[i] = uint32_t(t64);
+      t64 >>= 32;
+    }
+    for (; t64 && (i < nr); ++i) {
+      t64 += r[i];
+      r[i] = uint32_t(t64);
+      t64 >>= 32;
+    }
+    return uint32_t(t64);
+  }
+
+  // r[0, nr) -= a[0, na), na <= nr, returns borrow.
+  static uint32_t SubFrom(uint32_t* r, size_t nr, const uint32_t* a,
+                          size_t na) {
+    int64_t i64 = 0;
+    size_t i = 0;
+    for (; i < na; ++i) {
+      i64 += int64_t(r[i]) - int64_t(a[i]);
+      r[i] = uint32_t(i64);
+      i64 >>= 32;
+    }
+    for (; i64 && (i < nr); ++i) {
+      i64 += int64_t(r[i]);
+      r[i] = uint32_t(i64);
+      i64 >>= 32;
+    }
+    return uint32_t(-i64);
+  }
+
+  // Copies a[0, na) to r[0, n) with zero padding.
+  static void Copy(uint32_t* r, size_t n, const uint32_t* a, size_t na) {
+    std::copy(a, a + na, r);
+    std::fill(r + na, r + n, 0u);
+  }
+
+  // r[0, n) = |a - b| for a, b with n blocks, returns true if a < b.
+  static bool AbsDiff(uint32_t* r, const uint32_t* a, const uint32_t* b,
+                      size_t n) {
+    size_t i = n;
+    for (; i && (a[i - 1] == b[i - 1]);) --i;
+    const bool less = i && (a[i - 1] < b[i - 1]);
+    if (less) {
+      SubN(r, b, a, n);
+    } else {
+      SubN(r, a, b, n);
+    }
+    return less;
+  }
+
+  // Two's complement helpers for Toom-3 interpolation.
+  static void Negate(uint32_t* r, size_t n) {
+    uint64_t t64 = 1;
+    for (size_t i = 0; i < n; ++i) {
+      t64 += uint32_t(~r[i]);
+      r[i] = uint32_t(t64);
+      t64 >>= 32;
+    }
+  }
+
+  static void ShiftRight1(uint32_t* r, size_t n) {
+    for (size_t i = 0; i + 1 < n; ++i) r[i] = (r[i] >> 1) | (r[i + 1] << 31);
+    r[n - 1] = uint32_t(int32_t(r[n - 1]) >> 1);
+  }
+
+  static void DivExact3(uint32_t* r, size_t n) {
+    constexpr uint32_t inv3 = 0xAAAAAAABu;
+    uint32_t c = 0;
+    for (size_t i = 0; i < n; ++i) {
+      const uint32_t s = r[i], t = s - c;
+      c = (s < c) ? 1 : 0;
+      const uint32_t q = t * inv3;
+      r[i] = q;
+      c += (q >= 0x55555556u) + (q >= 0xAAAAAAABu);
+    }
+  }
+
+  // r[0, na + nb) = a * b, r must not overlap with a or b.
+  void MultRec(const uint32_t* a, size_t na, const uint32_t* b, size_t nb,
+               uint32_t* r) {
+    if (na < nb) {
+      std::swap(a, b);
+      std::swap(na, nb);
+    }
+    if (nb < karatsuba_cutoff) {
+      MultBase(a, na, b, nb, r);
+    } else if (na >= 2 * nb) {
+      MultUnbalanced(a, na, b, nb, r);
+    } else if ((nb < toom3_cutoff) || (nb <= 2 * ((na + 2) / 3))) {
+      MultKaratsuba(a, na, b, nb, r);
+    } else {
+      MultToom3(a, na, b, nb, r);
+    }
+  }
+
+  // na >= 2 * nb, a is split in blocks of nb.
+  void MultUnbalanced(const uint32_t* a, size_t na, const uint32_t* b,
+                      size_t nb, uint32_t* r) {
+    const size_t top = arena_top;
+    uint32_t* t = Allocate(2 * nb);
+    std::fill(r, r + na + nb, 0u);
+    for (size_t i = 0; i < na; i += nb) {
+      const size_t l = std::min(nb, na - i);
+      MultRec(a + i, l, b, nb, t);
+      AddTo(r + i, na + nb - i, t, l + nb);
+    }
+    arena_top = top;
+  }
+
+  // nb <= na < 2 * nb.
+  void MultKaratsuba(const uint32_t* a, size_t na, const uint32_t* b,
+                     size_t nb, uint32_t* r) {
+    const size_t h = (na + 1) / 2, nr = na + nb, top = arena_top;
+    assert(nb >= h);
+    MultRec(a, h, b, h, r);
+    MultRec(a + h, na - h, b + h, nb - h, r + 2 * h);
+    uint32_t *da = Allocate(h), *db = Allocate(h), *zm = Allocate(2 * h),
+             *t = Allocate(2 * h + 1);
+    Copy(da, h, a + h, na - h);
+    Copy(db, h, b + h, nb - h);
+    const bool sa = AbsDiff(da, a, da, h), sb = AbsDiff(db, b, db, h);
+    MultRec(da, h, db, h, zm);
+    Copy(t, 2 * h + 1, r, 2 * h);
+    AddTo(t, 2 * h + 1, r + 2 * h, nr - 2 * h);
+    if (sa == sb) {
+      SubFrom(t, 2 * h + 1, zm, 2 * h);
+    } else {
+      AddTo(t, 2 * h + 1, zm, 2 * h);
+    }
+    AddTo(r + h, nr - h, t, std::min(2 * h + 1, nr - h));
+    arena_top = top;
+  }
+
+  // Points 0, 1, -1, 2, inf.
+  void MultToom3(const uint32_t* a, size_t na, const uint32_t* b, size_t nb,
+                 uint32_t* r) {
+    const size_t k = (na + 2) / 3, ke = k + 1, l = 2 * k + 3, nr = na + nb,
+                 top = arena_top;
+    assert(nb > 2 * k);
+    uint32_t *a1 = Allocate(ke), *am1 = Allocate(ke), *a2 = Allocate(ke),
+             *b1 = Allocate(ke), *bm1 = Allocate(ke), *b2 = Allocate(ke);
+    const bool sa = Evaluate(a, na, k, a1, am1, a2),
+               sb = Evaluate(b, nb, k, b1, bm1, b2);
+    uint32_t *w0 = Allocate(l), *w1 = Allocate(l), *wm1 = Allocate(l),
+             *w2 = Allocate(l), *winf = Allocate(l);
+    MultRec(a, k, b, k, w0);
+    std::fill(w0 + 2 * k, w0 + l, 0u);
+    MultRec(a1, ke, b1, ke, w1);
+    MultRec(am1, ke, bm1, ke, wm1);
+    MultRec(a2, ke, b2, ke, w2);
+    for (uint32_t* w : {w1, wm1, w2}) w[l - 1] = 0;
+    if (sa != sb) Negate(wm1, l);
+    MultRec(a + 2 * k, na - 2 * k, b + 2 * k, nb - 2 * k, winf);
+    std::fill(winf + nr - 4 * k, winf + l, 0u);
+
+    // w2 = c1 + c2 + 3c3 + 5c4
+    SubN(w2, w2, wm1, l);
+    DivExact3(w2, l);
+    // w1 = c1 + c3
+    SubN(w1, w1, wm1, l);
+    ShiftRight1(w1, l);
+    // wm1 = -c1 + c2 - c3 + c4
+    SubN(wm1, wm1, w0, l);
+    // w2 = c1 + 2c3 + 2c4
+    SubN(w2, w2, wm1, l);
+    ShiftRight1(w2, l);
+    // wm1 = c2
+    AddN(wm1, wm1, w1, l);
+    SubN(wm1, wm1, winf, l);
+    // w2 = c3
+    SubN(w2, w2, w1, l);
+    SubN(w2, w2, winf, l);
+    SubN(w2, w2, winf, l);
+    // w1 = c1
+    SubN(w1, w1, w2, l);
+
+    Copy(r, nr, w0, 2 * k);
+    std::copy(winf, winf + nr - 4 * k, r + 4 * k);
+    AddTo(r + k, nr - k, w1, std::min(l, nr - k));
+    AddTo(r + 2 * k, nr - 2 * k, wm1, std::min(l, nr - 2 * k));
+    AddTo(r + 3 * k, nr - 3 * k, w2, std::min(l, nr - 3 * k));
+    arena_top = top;
+  }
+
+  // Values at 1, -1 and 2 for a = a2 * x^2 + a1 * x + a0, x = 2^(32k).
+  // Returns true if the value at -1 is negative.
+  static bool Evaluate(const uint32_t* a, size_t na, size_t k, uint32_t* v1,
+                       uint32_t* vm1, uint32_t* v2) {
+    const size_t ke = k + 1;
+    Copy(v2, ke, a + k, k);
+    Copy(v1, ke, a, k);
+    AddTo(v1, ke, a + 2 * k, na - 2 * k);
+    const bool s = AbsDiff(vm1, v1, v2, ke);
+    AddN(v1, v1, v2, ke);
+    Copy(v2, ke, a + 2 * k, na - 2 * k);
+    AddN(v2, v2, v2, ke);
+    AddTo(v2, ke, a + k, k);
+    AddN(v2, v2, v2, ke);
+    AddTo(v2, ke, a, k);
+    return s;
+  }
+
+ public:
+  explicit Toom(size_t _karatsuba_cutoff = default_karatsuba_cutoff,
+                size_t _toom3_cutoff = default_toom3_cutoff)
+      : karatsuba_cutoff(std::max<size_t>(_karatsuba_cutoff, 4)),
+        toom3_cutoff(std::max<size_t>(_toom3_cutoff, 16)) {}
+
+  Unsigned Mult(const Unsigned& a, const Unsigned& b) {
+    if (a.Empty() || b.Empty()) return Unsigned();
+    const size_t na = a.Size(), nb = b.Size();
+    arena.resize(16 * (na + nb) + 1024);
+    arena_top = 0;
+    Unsigned::TData v(na + nb);
+    MultRec(a.Data().data(), na, b.Data().data(), nb, v.data());
+    return Unsigned(v);
+  }
+
+  Unsigned Sqr(const Unsigned& a) { return Mult(a, a); }
+};
+
+inline Unsigned MultKaratsuba(const Unsigned& a, const Unsigned& b) {
+  return Toom(Toom::default_karatsuba_cutoff, ~size_t(0)).Mult(a, b);
+}
+
+inline Unsigned MultToom(const Unsigned& a, const Unsigned& b) {
+  return Toom().Mult(a, b);
+}
+
+inline Unsigned SqrToom(const Unsigned& a) { return Toom().Sqr(a); }
+}  // namespace multiplication
+}  // namespace nlong
+}  // namespace numeric
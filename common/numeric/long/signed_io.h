@@ -11,9 +11,9 @@
 namespace numeric {
 namespace nlong {
 constexpr Signed SignedParse(const std::string& s, unsigned base = 10) {
-  return s.empty()       ? Signed()
-         : (s[0] == '-') ? Signed(false, UnsignedParse(s.substr(1), base))
-                         : Signed(UnsignedParse(s, base));
+  if (s.empty()) return Signed();
+  if (s[0] == '-') return Signed(false, UnsignedParse(s.substr(1), base));
+  return Signed(UnsignedParse(s, base));
 }
 
 inline std::istream& operator>>(std::istream& s, Signed& ls) {
@@ -3,6 +3,7 @@
 #include "common/base.h"
 
 #include <algorithm>
+#include <utility>
 #include <vector>
 
 namespace numeric {
@@ -328,36 +329,71 @@ class Unsigned {
     return t;
   }
 
-  constexpr Unsigned operator/(const Unsigned& r) const {
+  // Knuth algorithm D, O(Size() * r.Size()).
+  constexpr std::pair<Unsigned, Unsigned> DivModBase(const Unsigned& r) const {
     assert(!r.Empty());
-    if (Empty()) return Unsigned();
-    Unsigned tl(*this), tr(r), lu;
-    const size_t total_shift = 1 + std::max(Size(), r.Size()) - r.Size();
-    tr.ShiftBlocksRight(total_shift);
-    for (size_t i = 0; i < 32 * total_shift; ++i) {
-      lu.ShiftBitsRight(1);
-      tr.ShiftBitsLeft(1);
-      if (tr <= tl) {
-        tl -= tr;
-        lu += 1;
+    if (*this < r) return {Unsigned(), *this};
+    if (r.Size() == 1) {
+      const uint32_t u = r.data[0];
+      return {*this / u, Unsigned(*this % u)};
+    }
+    const size_t n = r.Size(), m = Size() - n;
+    const unsigned shift = __builtin_clz(r.data.back());
+    TData vn(n), un(Size() + 1);
+    for (size_t i = n - 1; i; --i)
+      vn[i] = uint32_t(((uint64_t(r.data[i]) << 32) | r.data[i - 1]) >>
+                       (32 - shift));
+    vn[0] = r.data[0] << shift;
+    un[Size()] = uint32_t(uint64_t(data.back()) >> (32 - shift));
+    for (size_t i = Size() - 1; i; --i)
+      un[i] = uint32_t(((uint64_t(data[i]) << 32) | data[i - 1]) >>
+                       (32 - shift));
+    un[0] = data[0] << shift;
+
+    TData q(m + 1);
+    const uint64_t b = (1ull << 32), vh = vn[n - 1], vl = vn[n - 2];
+    for (size_t j = m + 1; j--;) {
+      const uint64_t t64 = (uint64_t(un[j + n]) << 32) | un[j + n - 1];
+      uint64_t qhat = t64 / vh, rhat = t64 % vh;
+      for (; (qhat >= b) || (qhat * vl > ((rhat << 32) | un[j + n - 2]));) {
+        --qhat;
+        rhat += vh;
+        if (rhat >= b) break;
+      }
+      int64_t k = 0, t = 0;
+      for (size_t i = 0; i < n; ++i) {
+        const uint64_t p = qhat * vn[i];
+        t = int64_t(un[i + j]) - k - int64_t(p & 0xFFFFFFFFu);
+        un[i + j] = uint32_t(t);
+        k = int64_t(p >> 32) - (t >> 32);
       }
+      t = int64_t(un[j + n]) - k;
+      un[j + n] = uint32_t(t);
+      if (t < 0) {
+        --qhat;
+        uint64_t c = 0;
+        for (size_t i = 0; i < n; ++i) {
+          c += uint64_t(un[i + j]) + vn[i];
+          un[i + j] = uint32_t(c);
+          c >>= 32;
+        }
+        un[j + n] += uint32_t(c);
+      }
+      q[j] = uint32_t(qhat);
     }
-    return lu;
+
+    TData rem(n);
+    for (size_t i = 0; i < n; ++i)
+      rem[i] = uint32_t(((uint64_t(un[i + 1]) << 32) | un[i]) >> shift);
+    return {Unsigned(q), Unsigned(rem)};
+  }
+
+  constexpr Unsigned operator/(const Unsigned& r) const {
+    return DivModBase(r).first;
   }
 
   constexpr Unsigned operator%(const Unsigned& r) const {
-    assert(!r.Empty());
-    if (Empty()) return Unsigned();
-    Unsigned tl(*this), tr(r);
-    const size_t total_shift = 1 + std::max(Size(), r.Size()) - r.Size();
-    tr.ShiftBlocksRight(total_shift);
-    for (size_t i = 0; i < 32 * total_shift; ++i) {
-      tr.ShiftBitsLeft(1);
-      if (tr <= tl) {
-        tl -= tr;
-      }
-    }
-    return tl;
+    return DivModBase(r).second;
   }
 
   constexpr Unsigned& operator/=(const Unsigned& r) {
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "common/numeric/long/division/auto.h"
+#include "common/numeric/long/unsigned.h"
+
+#include <utility>
+
+namespace numeric {
+namespace nlong {
+inline std::pair<Unsigned, Unsigned> DivMod(const Unsigned& a,
+                                            const Unsigned& b) {
+  return division::DivModAuto(a, b);
+}
+
+inline Unsigned Div(const Unsigned& a, const Unsigned& b) {
+  return DivMod(a, b).first;
+}
+
+inline Unsigned Mod(const Unsigned& a, const Unsigned& b) {
+  return DivMod(a, b).second;
+}
+}  // namespace nlong
+}  // namespace numeric
@@ -0,0 +1,142 @@
+#pragma once
+
+#include "common/base.h"
+#include "common/numeric/long/unsigned.h"
+#include "common/numeric/long/unsigned/division.h"
+#include "common/numeric/long/unsigned/multiplication.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace numeric {
+namespace nlong {
+// Divide-and-conquer radix conversion. Digits are grouped in chunks of
+// base^k < 2^32 and chunks are merged or split on powers base^(k*2^j).
+// Static ParseDigits and ToStringDigits are quadratic digit by digit
+// versions usable in constant expressions.
+class Radix {
+ protected:
+  static constexpr size_t base_limit = 32;
+
+  unsigned base, chunk_digits;
+  uint32_t chunk_base;
+  std::vector<Unsigned> powers;
+
+ protected:
+  static constexpr unsigned DigitValue(char c) {
+    return ((c >= '0') && (c <= '9'))   ? unsigned(c - '0')
+           : ((c >= 'a') && (c <= 'z')) ? unsigned(c - 'a' + 10)
+           : ((c >= 'A') && (c <= 'Z')) ? unsigned(c - 'A' + 10)
+                                        : 36u;
+  }
+
+  static constexpr char DigitChar(unsigned d) {
+    return (d < 10) ? char('0' + d) : char('a' + d - 10);
+  }
+
+  // powers[j] = chunk_base^(2^j).
+  void AdjustPowers(size_t j) {
+    if (powers.empty()) powers.push_back(Unsigned(chunk_base));
+    for (; powers.size() <= j;) powers.push_back(Sqr(powers.back()));
+  }
+
+  uint32_t ParseChunk(const std::string& s, size_t first, size_t last) const {
+    uint32_t x = 0;
+    for (size_t i = first; i < last; ++i) {
+      const unsigned d = DigitValue(s[i]);
+      assert(d < base);
+      x = x * base + d;
+    }
+    return x;
+  }
+
+  void WriteChunk(uint32_t x, size_t width, std::string& output) const {
+    const size_t l = output.size();
+    for (; x; x /= base) output.push_back(DigitChar(x % base));
+    for (; output.size() < l + width;) output.push_back('0');
+    std::reverse(output.begin() + l, output.end());
+  }
+
+  // Writes x < chunk_base^(2^(j+1)), padded to chunk_digits*2^(j+1) if pad.
+  void Write(const Unsigned& x, int j, bool pad, std::string& output) {
+    if ((j < 0) || (x.Size() <= base_limit)) {
+      std::vector<uint32_t> vc;
+      for (Unsigned t(x); !t.Empty(); t /= chunk_base)
+        vc.push_back(t % chunk_base);
+      if (pad) vc.resize(size_t(1) << (j + 1), 0);
+      for (size_t i = vc.size(); i--;)
+        WriteChunk(vc[i], (pad || (i + 1 < vc.size())) ? chunk_digits : 0,
+                   output);
+      return;
+    }
+    const auto [q, r] = DivMod(x, powers[j]);
+    if (pad || !q.Empty()) {
+      Write(q, j - 1, pad, output);
+      Write(r, j - 1, true, output);
+    } else {
+      Write(r, j - 1, false, output);
+    }
+  }
+
+ public:
+  explicit Radix(unsigned _base = 10) : base(_base) {
+    assert((base >= 2) && (base <= 36));
+    chunk_digits = 1;
+    uint64_t t = base;
+    for (; t * base < (1ull << 32); t *= base) ++chunk_digits;
+    chunk_base = uint32_t(t);
+  }
+
+  static constexpr Unsigned ParseDigits(const std::string& s, unsigned base) {
+    assert((base >= 2) && (base <= 36));
+    Unsigned x;
+    for (char c : s) {
+      const unsigned d = DigitValue(c);
+      assert(d < base);
+      x *= base;
+      x += d;
+    }
+    return x;
+  }
+
+  static constexpr std::string ToStringDigits(const Unsigned& x,
+                                              unsigned base) {
+    assert((base >= 2) && (base <= 36));
+    if (x.Empty()) return "0";
+    std::vector<unsigned> v = x.ToVector(base);
+    std::string s;
+    s.reserve(v.size());
+    for (size_t i = v.size(); i--;) s.push_back(DigitChar(v[i]));
+    return s;
+  }
+
+  Unsigned Parse(const std::string& s) {
+    std::vector<Unsigned> v;
+    for (size_t last = s.size(); last;) {
+      const size_t first = (last > chunk_digits) ? last - chunk_digits : 0;
+      v.push_back(Unsigned(ParseChunk(s, first, last)));
+      last = first;
+    }
+    for (size_t j = 0; v.size() > 1; ++j) {
+      AdjustPowers(j);
+      std::vector<Unsigned> vnext((v.size() + 1) / 2);
+      for (size_t i = 0; i < v.size() / 2; ++i)
+        vnext[i] = v[2 * i] + Mult(v[2 * i + 1], powers[j]);
+      if (v.size() & 1) vnext.back().swap(v.back());
+      v.swap(vnext);
+    }
+    return v.empty() ? Unsigned() : v[0];
+  }
+
+  std::string ToString(const Unsigned& x) {
+    if (x.Empty()) return "0";
+    size_t j = 0;
+    for (AdjustPowers(0); !(x < powers[j]);) AdjustPowers(++j);
+    std::string s;
+    Write(x, int(j) - 1, false, s);
+    return s;
+  }
+};
+}  // namespace nlong
+}  // namespace numeric
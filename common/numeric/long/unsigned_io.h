@@ -1,23 +1,19 @@
 #pragma once
 
 #include "common/numeric/long/unsigned.h"
+#include "common/numeric/long/unsigned/radix.h"
 
 #include <iostream>
 #include <istream>
 #include <ostream>
 #include <string>
+#include <type_traits>
 
 namespace numeric {
 namespace nlong {
 constexpr Unsigned UnsignedParse(const std::string& s, unsigned base = 10) {
-  assert(base == 10);
-  Unsigned lu;
-  for (char c : s) {
-    lu *= base;
-    assert((c >= '0') && (c <= '9'));
-    lu += unsigned(c - '0');
-  }
-  return lu;
+  if (std::is_constant_evaluated()) return Radix::ParseDigits(s, base);
+  return Radix(base).Parse(s);
 }
 
 inline std::istream& operator>>(std::istream& s, Unsigned& lu) {
@@ -34,14 +30,8 @@ inline Unsigned UnsignedReadBase(unsigned base = 10) {
 }
 
 constexpr std::string ToString(const Unsigned& lu, unsigned base = 10) {
-  if (lu.Empty()) return "0";
-  assert(base == 10);
-  std::vector<unsigned> v = lu.ToVector(base);
-  std::reverse(v.begin(), v.end());
-  std::string s;
-  s.reserve(v.size());
-  for (unsigned u : v) s.push_back('0' + char(u));
-  return s;
+  if (std::is_constant_evaluated()) return Radix::ToStringDigits(lu, base);
+  return Radix(base).ToString(lu);
 }
 
 inline std::ostream& operator<<(std::ostream& s, const Unsigned& lu) {
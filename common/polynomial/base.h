@@ -46,6 +46,9 @@ class Base {
     Normalize();
   }
 
+  bool operator==(const TSelf& r) const { return data == r.data; }
+  bool operator!=(const TSelf& r) const { return data != r.data; }
+
   iterator begin() { return &data.front(); }
   const_iterator begin() const { return &data.front(); }
   iterator end() { return begin() + Size(); }
@@ -57,6 +60,7 @@ class Base {
       data.push_back(v);
     else
       data[0] += v;
+    Normalize();
     return *Me();
   }
 
@@ -65,6 +69,7 @@ class Base {
       data.push_back(-v);
     else
       data[0] -= v;
+    Normalize();
     return *Me();
   }
 
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "common/modular.h"
+#include "common/modular/static/convolution.h"
+#include "common/polynomial/modular/multiplication.h"
+#include "common/polynomial/modular/newton.h"
+#include "common/polynomial/polynomial.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace polynomial {
+// Returns {q, r} with a = b * q + r and deg r < deg b.
+// Quotient is rev(rev(a) / rev(b)) modulo x^(deg a - deg b + 1).
+template <uint64_t prime>
+inline std::pair<Polynomial<ModularPrime32<prime>>,
+                 Polynomial<ModularPrime32<prime>>>
+DivMod(const Polynomial<ModularPrime32<prime>>& a,
+       const Polynomial<ModularPrime32<prime>>& b) {
+  using TNewton = hidden::SeriesNewton<prime>;
+  using TModular = ModularPrime32<prime>;
+  using TPolynomial = Polynomial<TModular>;
+  assert(!b.Empty());
+  if (a.Size() < b.Size()) return {TPolynomial(), a};
+  const unsigned k = a.Size() - b.Size() + 1;
+  std::vector<TModular> q(k);
+  if (std::min(k, b.Size()) <= TNewton::naive_size) {
+    std::vector<TModular> r = a.Data();
+    const TModular bi = b[b.Size() - 1].Inverse();
+    for (unsigned i = k; i-- > 0;) {
+      q[i] = r[i + b.Size() - 1] * bi;
+      for (unsigned j = 0; j < b.Size(); ++j) r[i + j] -= q[i] * b[j];
+    }
+    r.resize(b.Size() - 1);
+    return {TPolynomial(q), TPolynomial(r)};
+  }
+  std::vector<TModular> ra(a.Data().rbegin(), a.Data().rbegin() + k),
+      rb(b.Data().rbegin(), b.Data().rend());
+  const auto rq =
+      modular::mstatic::Convolution(ra, TNewton::Inverse(rb, k));
+  std::reverse_copy(rq.begin(), rq.begin() + k, q.begin());
+  TPolynomial pq(q);
+  return {pq, a - b * pq};
+}
+}  // namespace polynomial
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "common/modular.h"
+#include "common/polynomial/modular/newton.h"
+#include "common/polynomial/polynomial.h"
+
+#include <algorithm>
+
+namespace polynomial {
+// exp(a) modulo x^n, a[0] should be 0 and n < prime.
+// Newton iteration f_2m = f (1 + a - log f) with g = 1 / f modulo x^m kept
+// along with f:
+//   q = a' mod x^(m-1), w = q + g (f' - f q) = log(f)' mod x^(2m-1).
+// Transform of f is shared by f * q and f * (a - log f).
+template <uint64_t prime>
+inline Polynomial<ModularPrime32<prime>> Exp(
+    const Polynomial<ModularPrime32<prime>>& a, unsigned n) {
+  using TNewton = hidden::SeriesNewton<prime>;
+  using TModular = ModularPrime32<prime>;
+  using TVector = typename TNewton::TVector;
+  using TFFT = typename TNewton::TFFT;
+  assert(a[0] == TModular());
+  assert(n < prime);
+  if (n == 0) return {};
+  const TVector h = TNewton::Data(a, n), inv = TNewton::Inverses(n);
+
+  // k f_k = sum i h_i f_(k-i)
+  const unsigned m0 = std::min(n, TNewton::naive_size);
+  TVector f(m0);
+  f[0] = TModular(1);
+  for (unsigned k = 1; k < m0; ++k) {
+    TModular s;
+    for (unsigned i = 1; i <= k; ++i) s += TModular(i) * h[i] * f[k - i];
+    f[k] = s * inv[k];
+  }
+  TVector g = TNewton::InverseBase(f, m0);
+
+  for (unsigned m = m0; m < n; m *= 2) {
+    if (g.size() < m) TNewton::InverseStep(f, g);
+    const unsigned l = 2 * m;
+    TVector q(m - 1);
+    for (unsigned i = 0; i + 1 < m; ++i) q[i] = h[i + 1] * TModular(i + 1);
+    const auto tf = TNewton::Transform(f, 0, m, l);
+    const auto fq =
+        TFFT::CyclicConvolution(tf, TNewton::Transform(q, 0, m - 1, l));
+    // f' - f q is zero modulo x^(m-1) and deg f' < m - 1.
+    TVector r(m);
+    for (unsigned i = 0; i < m; ++i) r[i] = -fq[m - 1 + i];
+    const auto gr = TFFT::CyclicConvolution(TNewton::Transform(g, 0, m, l),
+                                            TNewton::Transform(r, 0, m, l));
+    // a - log f is zero modulo x^m.
+    TVector d(m);
+    for (unsigned i = 0; (i < m) && (m + i < n); ++i)
+      d[i] = h[m + i] - gr[i] * inv[m + i];
+    const auto fd = TFFT::CyclicConvolution(tf, TNewton::Transform(d, 0, m, l));
+    f.resize(l);
+    for (unsigned i = 0; i < m; ++i) f[m + i] = fd[i];
+  }
+  f.resize(n);
+  return Polynomial<TModular>(f);
+}
+}  // namespace polynomial
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "common/modular.h"
+#include "common/polynomial/modular/newton.h"
+#include "common/polynomial/polynomial.h"
+
+namespace polynomial {
+// 1 / a modulo x^n, a[0] should be non-zero.
+template <uint64_t prime>
+inline Polynomial<ModularPrime32<prime>> Inverse(
+    const Polynomial<ModularPrime32<prime>>& a, unsigned n) {
+  using TNewton = hidden::SeriesNewton<prime>;
+  if (n == 0) return {};
+  return Polynomial<ModularPrime32<prime>>(
+      TNewton::Inverse(TNewton::Data(a, n), n));
+}
+}  // namespace polynomial
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "common/modular.h"
+#include "common/modular/static/convolution.h"
+#include "common/polynomial/modular/newton.h"
+#include "common/polynomial/polynomial.h"
+
+namespace polynomial {
+// log(a) modulo x^n, a[0] should be 1 and n < prime.
+template <uint64_t prime>
+inline Polynomial<ModularPrime32<prime>> Log(
+    const Polynomial<ModularPrime32<prime>>& a, unsigned n) {
+  using TNewton = hidden::SeriesNewton<prime>;
+  using TModular = ModularPrime32<prime>;
+  assert(a[0] == TModular(1));
+  assert(n < prime);
+  if (n <= 1) return {};
+  // log(a)' = a' / a
+  const auto v = TNewton::Data(a, n);
+  typename TNewton::TVector da(n - 1);
+  for (unsigned i = 1; i < n; ++i) da[i - 1] = v[i] * TModular(i);
+  const auto q = modular::mstatic::Convolution(da, TNewton::Inverse(v, n - 1));
+  const auto inv = TNewton::Inverses(n);
+  typename TNewton::TVector r(n);
+  for (unsigned i = 1; i < n; ++i) r[i] = q[i - 1] * inv[i];
+  return Polynomial<TModular>(r);
+}
+}  // namespace polynomial
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "common/base.h"
+#include "common/modular.h"
+#include "common/modular/static/convolution_fft.h"
+#include "common/polynomial/polynomial.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace polynomial {
+namespace hidden {
+// Helpers for Newton iterations on power series. Series are stored as
+// vectors of the first coefficients. Each step doubles precision with cyclic
+// convolutions of length 2m, operands used twice are transformed once.
+template <uint64_t prime>
+class SeriesNewton {
+ public:
+  using TModular = ModularPrime32<prime>;
+  using TVector = std::vector<TModular>;
+  using TFFT = modular::mstatic::ConvolutionFFT<TModular>;
+  using TTransformed = typename TFFT::Transformed;
+
+  // Series smaller than this are processed with quadratic algorithms.
+  static constexpr unsigned naive_size = 32;
+
+ public:
+  // First n coefficients of a.
+  static TVector Data(const Polynomial<TModular>& a, unsigned n) {
+    TVector v(n);
+    const auto& d = a.Data();
+    std::copy(d.begin(), d.begin() + std::min(n, a.Size()), v.begin());
+    return v;
+  }
+
+  // a[first, first + size) for cyclic convolutions of length n.
+  static TTransformed Transform(const TVector& a, size_t first, size_t size,
+                                unsigned n) {
+    first = std::min(first, a.size());
+    size = std::min(size, a.size() - first);
+    return TFFT::Transform(a.data() + first, size, n);
+  }
+
+  // Inverse of f modulo x^n.
+  static TVector InverseBase(const TVector& f, unsigned n) {
+    assert(!f.empty() && (f[0] != TModular()));
+    const TModular f0i = f[0].Inverse();
+    TVector g(n);
+    for (unsigned k = 0; k < n; ++k) {
+      TModular s = (k == 0) ? TModular(1) : TModular();
+      for (unsigned i = 1; i <= std::min<size_t>(k, f.size() - 1); ++i)
+        s -= f[i] * g[k - i];
+      g[k] = s * f0i;
+    }
+    return g;
+  }
+
+  // g is the inverse of f modulo x^m, extends it to modulo x^(2m).
+  //   e = f * g = 1 + x^m * h (mod x^2m), g_new = g - x^m * (g * h).
+  static void InverseStep(const TVector& f, TVector& g) {
+    const unsigned m = unsigned(g.size()), n = 2 * m;
+    const auto tg = TFFT::Transform(g, n);
+    const auto e = TFFT::CyclicConvolution(Transform(f, 0, n, n), tg);
+    const auto gh = TFFT::CyclicConvolution(
+        tg, TFFT::Transform(e.data() + m, m, n));
+    g.resize(n);
+    for (unsigned i = 0; i < m; ++i) g[m + i] = -gh[i];
+  }
+
+  static TVector Inverse(const TVector& f, unsigned n) {
+    TVector g = InverseBase(f, std::min(n, naive_size));
+    for (; g.size() < n;) InverseStep(f, g);
+    g.resize(n);
+    return g;
+  }
+
+  // v[i] = 1 / i for i in [1, n).
+  static TVector Inverses(unsigned n) {
+    TVector v(std::max(n, 2u));
+    v[1] = TModular(1);
+    for (unsigned i = 2; i < n; ++i)
+      v[i] = -TModular(prime / i) * v[prime % i];
+    return v;
+  }
+};
+}  // namespace hidden
+}  // namespace polynomial
@@ -1,9 +1,13 @@
 #pragma once
 
 #include "common/modular.h"
+#include "common/polynomial/modular/exp.h"
+#include "common/polynomial/modular/log.h"
 #include "common/polynomial/modular/multiplication.h"
 #include "common/polynomial/polynomial.h"
 
+#include <vector>
+
 namespace polynomial {
 template <uint64_t prime>
 inline Polynomial<ModularPrime32<prime>> PowU(
@@ -15,4 +19,26 @@ inline Polynomial<ModularPrime32<prime>> PowU(
   }
   return ans;
 }
+
+// x^pow modulo x^n, computed as exp(pow * log(x)) after removing the lowest
+// term. n should be less than prime.
+template <uint64_t prime>
+inline Polynomial<ModularPrime32<prime>> PowU(
+    const Polynomial<ModularPrime32<prime>>& x, uint64_t pow, unsigned n) {
+  using TModular = ModularPrime32<prime>;
+  if (n == 0) return {};
+  if (pow == 0) return Polynomial<TModular>(TModular(1));
+  unsigned z = 0;
+  for (; (z < x.Size()) && (x[z] == TModular()); ++z) {}
+  if ((z == x.Size()) || (z > (n - 1) / pow)) return {};
+  const unsigned shift = unsigned(z * pow), m = n - shift;
+  const TModular c = x[z], ci = c.Inverse();
+  std::vector<TModular> v(m);
+  for (unsigned i = 0; i < m; ++i) v[i] = x[z + i] * ci;
+  auto r = Exp<prime>(Log<prime>(Polynomial<TModular>(v), m) * TModular(pow),
+                      m) *
+           c.PowU(pow);
+  r.MultXN(shift);
+  return r;
+}
 }  // namespace polynomial
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "common/modular.h"
+#include "common/modular/utils/sqrt.h"
+#include "common/polynomial/modular/newton.h"
+#include "common/polynomial/polynomial.h"
+
+#include <algorithm>
+
+namespace polynomial {
+// sqrt(a) modulo x^n. The lowest non-zero term of a should have even power
+// and quadratic residue coefficient. Newton iteration s_2m = (s + a / s) / 2
+// with t = 1 / s modulo x^m kept along with s.
+template <uint64_t prime>
+inline Polynomial<ModularPrime32<prime>> Sqrt(
+    const Polynomial<ModularPrime32<prime>>& a, unsigned n) {
+  using TNewton = hidden::SeriesNewton<prime>;
+  using TModular = ModularPrime32<prime>;
+  using TVector = typename TNewton::TVector;
+  using TFFT = typename TNewton::TFFT;
+  static_assert(prime > 2);
+  unsigned z = 0;
+  for (; (z < a.Size()) && (a[z] == TModular()); ++z) {}
+  if ((z == a.Size()) || (z / 2 >= n)) return {};
+  assert(z % 2 == 0);
+  const unsigned nz = n - z / 2;
+  TVector h(nz);
+  for (unsigned i = 0; i < nz; ++i) h[i] = a[z + i];
+
+  // 2 s_0 s_k = h_k - sum s_i s_(k-i), 0 < i < k
+  const unsigned m0 = std::min(nz, TNewton::naive_size);
+  TVector s(m0);
+  s[0] = TModular(SqrtModPrime(h[0].Get(), prime));
+  const TModular i2s0 = (TModular(2) * s[0]).Inverse();
+  for (unsigned k = 1; k < m0; ++k) {
+    TModular x = h[k];
+    for (unsigned i = 1; i < k; ++i) x -= s[i] * s[k - i];
+    s[k] = x * i2s0;
+  }
+  TVector t = TNewton::InverseBase(s, m0);
+
+  const TModular i2 = TModular(2).Inverse();
+  for (unsigned m = m0; m < nz; m *= 2) {
+    if (t.size() < m) TNewton::InverseStep(s, t);
+    const unsigned l = 2 * m;
+    const auto ts = TNewton::Transform(s, 0, m, l);
+    const auto ss = TFFT::CyclicConvolution(ts, ts);
+    // h - s^2 is zero modulo x^m.
+    TVector e(m);
+    for (unsigned i = 0; (i < m) && (m + i < nz); ++i)
+      e[i] = h[m + i] - ss[m + i];
+    const auto te = TFFT::CyclicConvolution(TNewton::Transform(t, 0, m, l),
+                                            TNewton::Transform(e, 0, m, l));
+    s.resize(l);
+    for (unsigned i = 0; i < m; ++i) s[m + i] = te[i] * i2;
+  }
+  s.resize(nz);
+  s.insert(s.begin(), z / 2, TModular());
+  return Polynomial<TModular>(s);
+}
+}  // namespace polynomial
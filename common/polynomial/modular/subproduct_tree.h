@@ -0,0 +1,144 @@
+#pragma once
+
+#include "common/base.h"
+#include "common/modular.h"
+#include "common/polynomial/modular/division.h"
+#include "common/polynomial/modular/multiplication.h"
+#include "common/polynomial/polynomial.h"
+#include "common/polynomial/utils/derivative.h"
+
+#include <vector>
+
+namespace polynomial {
+// Subproduct tree for points x_0, ..., x_(n-1): node for points [l, r) stores
+// (x - x_l) * ... * (x - x_(r-1)). The same tree is used for
+//   Evaluate: remainders of f are pushed from root to leaves, O(M(n) log n).
+//   Interpolate: Lagrange weights are combined from leaves to root.
+// For consecutive points x_i = x_0 + i Lagrange denominators are computed
+// in O(n) instead of evaluation of the derivative of the root.
+template <uint64_t prime>
+class SubproductTree {
+ public:
+  using TModular = ModularPrime32<prime>;
+  using TPolynomial = Polynomial<TModular>;
+  using TVector = std::vector<TModular>;
+
+  // Blocks with fewer points are evaluated directly.
+  static constexpr unsigned naive_size = 32;
+
+ protected:
+  TVector points;
+  bool consecutive;
+  std::vector<TPolynomial> tree;
+
+ public:
+  explicit SubproductTree(const TVector& _points)
+      : points(_points), consecutive(false) {
+    Build();
+  }
+
+  // Points first, first + 1, ..., first + n - 1, n should be less than prime.
+  SubproductTree(const TModular& first, unsigned n) : consecutive(true) {
+    assert(n < prime);
+    points.resize(n);
+    for (unsigned i = 0; i < n; ++i) points[i] = first + TModular(i);
+    Build();
+  }
+
+  unsigned Size() const { return unsigned(points.size()); }
+  const TVector& Points() const { return points; }
+
+  // Product of (x - x_i).
+  const TPolynomial& Root() const { return tree[1]; }
+
+  // f(x_i) for all points.
+  TVector Evaluate(const TPolynomial& f) const {
+    TVector output(points.size());
+    if (!points.empty()) Evaluate(f, 1, 0, Size(), output);
+    return output;
+  }
+
+  // Polynomial of degree less than n with values vy in points.
+  TPolynomial Interpolate(const TVector& vy) const {
+    assert(vy.size() == points.size());
+    if (points.empty()) return {};
+    TVector w = Denominators();
+    // w_i = vy_i / prod (x_i - x_j), j != i
+    for (unsigned i = 0; i < w.size(); ++i) w[i] *= vy[i];
+    return Combine(w, 1, 0, Size());
+  }
+
+ protected:
+  void Build() {
+    if (points.empty()) {
+      tree.assign(2, TPolynomial(TModular(1)));
+      return;
+    }
+    tree.resize(4 * points.size());
+    Build(1, 0, Size());
+  }
+
+  void Build(unsigned node, unsigned l, unsigned r) {
+    if (r - l == 1) {
+      tree[node] = TPolynomial(-points[l], TModular(1));
+      return;
+    }
+    const unsigned m = (l + r) / 2;
+    Build(2 * node, l, m);
+    Build(2 * node + 1, m, r);
+    tree[node] = tree[2 * node] * tree[2 * node + 1];
+  }
+
+  void Evaluate(TPolynomial f, unsigned node, unsigned l, unsigned r,
+                TVector& output) const {
+    if (f.Size() >= tree[node].Size()) f = DivMod(f, tree[node]).second;
+    if (r - l <= naive_size) {
+      for (unsigned i = l; i < r; ++i) output[i] = f(points[i]);
+      return;
+    }
+    const unsigned m = (l + r) / 2;
+    Evaluate(f, 2 * node, l, m, output);
+    Evaluate(f, 2 * node + 1, m, r, output);
+  }
+
+  // 1 / prod (x_i - x_j), j != i.
+  TVector Denominators() const {
+    const unsigned n = Size();
+    TVector v(n);
+    if (consecutive) {
+      // prod (i - j) = (-1)^(n-1-i) * i! * (n-1-i)!
+      TVector ifact(n);
+      TModular f(1);
+      for (unsigned i = 1; i < n; ++i) f *= TModular(i);
+      ifact[n - 1] = f.Inverse();
+      for (unsigned i = n - 1; i > 0; --i)
+        ifact[i - 1] = ifact[i] * TModular(i);
+      for (unsigned i = 0; i < n; ++i) {
+        v[i] = ifact[i] * ifact[n - 1 - i];
+        if ((n - 1 - i) & 1) v[i] = -v[i];
+      }
+      return v;
+    }
+    v = Evaluate(Derivative(Root()));
+    // Batch inversion.
+    TVector prefix(n + 1);
+    prefix[0] = TModular(1);
+    for (unsigned i = 0; i < n; ++i) prefix[i + 1] = prefix[i] * v[i];
+    TModular s = prefix[n].Inverse();
+    for (unsigned i = n; i-- > 0;) {
+      const TModular t = s * prefix[i];
+      s *= v[i];
+      v[i] = t;
+    }
+    return v;
+  }
+
+  TPolynomial Combine(const TVector& w, unsigned node, unsigned l,
+                      unsigned r) const {
+    if (r - l == 1) return TPolynomial(w[l]);
+    const unsigned m = (l + r) / 2;
+    return Combine(w, 2 * node, l, m) * tree[2 * node + 1] +
+           Combine(w, 2 * node + 1, m, r) * tree[2 * node];
+  }
+};
+}  // namespace polynomial
@@ -33,7 +33,7 @@ class Polynomial : public Base<TTValue, Polynomial<TTValue>> {
 
   TValue Apply(TValue x) const {
     if (TBase::Empty()) return TValue();
-    TValue *p = TBase::end(), *pbegin = TBase::begin();
+    const TValue *p = TBase::end(), *pbegin = TBase::begin();
     TValue r = *(--p);
     for (; p != pbegin;) r = r * x + *(--p);
     return r;
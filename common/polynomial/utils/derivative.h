@@ -0,0 +1,15 @@
+#pragma once
+
+#include "common/polynomial/polynomial.h"
+
+#include <vector>
+
+namespace polynomial {
+template <class TValue>
+inline Polynomial<TValue> Derivative(const Polynomial<TValue>& a) {
+  if (a.Size() <= 1) return Polynomial<TValue>();
+  std::vector<TValue> v(a.Size() - 1);
+  for (unsigned i = 1; i < a.Size(); ++i) v[i - 1] = a[i] * TValue(i);
+  return Polynomial<TValue>(v);
+}
+}  // namespace polynomial
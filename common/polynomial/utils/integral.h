@@ -0,0 +1,16 @@
+#pragma once
+
+#include "common/polynomial/polynomial.h"
+
+#include <vector>
+
+namespace polynomial {
+// Antiderivative with zero constant term.
+template <class TValue>
+inline Polynomial<TValue> Integral(const Polynomial<TValue>& a) {
+  if (a.Empty()) return Polynomial<TValue>();
+  std::vector<TValue> v(a.Size() + 1);
+  for (unsigned i = 0; i < a.Size(); ++i) v[i + 1] = a[i] / TValue(i + 1);
+  return Polynomial<TValue>(v);
+}
+}  // namespace polynomial
@@ -1,11 +1,36 @@
 #pragma once
 
-#include "common/polynomial/base_newton.h"
 #include <vector>
 
 namespace polynomial {
+// Value at x of the polynomial of degree less than n with values vy at
+// 0, 1, ..., n-1. Lagrange formula with prefix and suffix products, O(n).
 template <class TValue>
 inline TValue Interpolate(const std::vector<TValue>& vy, const TValue& x) {
-  return BaseNewton<TValue>().Interpolate(vy)(x);
+  const unsigned n = unsigned(vy.size());
+  if (n == 0) return TValue(0);
+  // suffix[i] = (x - i) * ... * (x - n + 1)
+  std::vector<TValue> suffix(n + 1);
+  suffix[n] = TValue(1);
+  for (unsigned i = n; i-- > 0;) suffix[i] = suffix[i + 1] * (x - TValue(i));
+  // ifact[i] = 1 / i!
+  std::vector<TValue> ifact(n);
+  TValue f(1);
+  for (unsigned i = 1; i < n; ++i) f *= TValue(i);
+  ifact[n - 1] = TValue(1) / f;
+  for (unsigned i = n - 1; i > 0; --i) ifact[i - 1] = ifact[i] * TValue(i);
+  // Denominator for i is (-1)^(n-1-i) * i! * (n-1-i)!.
+  TValue r(0), prefix(1);
+  for (unsigned i = 0; i < n; ++i) {
+    const TValue t =
+        vy[i] * prefix * suffix[i + 1] * ifact[i] * ifact[n - 1 - i];
+    if ((n - 1 - i) & 1) {
+      r -= t;
+    } else {
+      r += t;
+    }
+    prefix *= (x - TValue(i));
+  }
+  return r;
 }
 }  // namespace polynomial
@@ -0,0 +1,172 @@
+#pragma once
+
+#include "common/base.h"
+#include "common/solvers/ext/run_one.h"
+#include "common/solvers/ext/run_state.h"
+#include "common/thread_pool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace solvers {
+namespace ext {
+// Multi threads batch runner.
+//   * Problems without finished record in report file are solved, so an
+//     interrupted run could be resumed with the same report_filename.
+//   * Problems are scheduled by runtime from history, longest first.
+//     Problems without history are treated as average ones.
+//   * Best scores are cached in history and in memory, best solutions are
+//     loaded only if the new solution could be better.
+//   * Loaded problems are kept in memory if cache_problems is set, it helps
+//     if the same runner is used for several solvers.
+// Report and history files are optional and rewritten every
+// report_interval_in_seconds and at the end of the run.
+template <class TSolver>
+class BatchRunner {
+ public:
+  using TProblem = typename TSolver::TProblem;
+  using PProblem = std::shared_ptr<const TProblem>;
+  using Status = RunState::Status;
+
+  struct Options {
+    unsigned nthreads = 1;
+    std::string report_filename;
+    std::string history_filename;
+    unsigned report_interval_in_seconds = 60;
+    bool cache_problems = false;
+  };
+
+ protected:
+  Options options;
+  RunState history;
+  std::unordered_map<std::string, PProblem> problems;
+  std::mutex mutex;
+
+ public:
+  explicit BatchRunner(const Options& _options) : options(_options) {
+    if (!options.history_filename.empty())
+      history.Load(options.history_filename);
+  }
+
+  const RunState& History() const { return history; }
+
+  PProblem GetProblem(const std::string& id) {
+    if (options.cache_problems) {
+      std::unique_lock<std::mutex> lock(mutex);
+      auto it = problems.find(id);
+      if (it != problems.end()) return it->second;
+    }
+    auto p = std::make_shared<TProblem>();
+    if (!p->Load(id)) return nullptr;
+    if (options.cache_problems) {
+      std::unique_lock<std::mutex> lock(mutex);
+      problems[id] = p;
+    }
+    return p;
+  }
+
+ protected:
+  std::vector<std::string> Schedule(const std::vector<std::string>& ids) {
+    double total = 0.;
+    size_t known = 0;
+    for (auto& id : ids) {
+      auto r = history.Find(id);
+      if (r && (r->seconds >= 0)) {
+        total += r->seconds;
+        ++known;
+      }
+    }
+    const double average = known ? total / known : 0.;
+    std::vector<std::pair<double, std::string>> v;
+    for (auto& id : ids) {
+      auto r = history.Find(id);
+      v.push_back({(r && (r->seconds >= 0)) ? r->seconds : average, id});
+    }
+    std::stable_sort(v.begin(), v.end(), [](auto& l, auto& r) {
+      return l.first > r.first;
+    });
+    std::vector<std::string> output;
+    for (auto& p : v) output.push_back(p.second);
+    return output;
+  }
+
+  void Save(const RunState& state) {
+    if (!options.report_filename.empty()) state.Save(options.report_filename);
+    if (!options.history_filename.empty())
+      history.Save(options.history_filename);
+  }
+
+  void RunTask(const typename TSolver::PSolver& psolver, const std::string& id,
+               RunState& state) {
+    RunState::Record record;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      const auto h = history.Find(id);
+      if (h) {
+        record.has_best = h->has_best;
+        record.best = h->best;
+      }
+    }
+    auto p = GetProblem(id);
+    if (p) {
+      auto ptemp = psolver->Clone();
+      assert(ptemp);
+      RunOne(*ptemp, *p, id, record);
+    } else {
+      record.status = Status::FAILED;
+    }
+    std::unique_lock<std::mutex> lock(mutex);
+    state[id] = record;
+    auto& h = history[id];
+    if (record.seconds >= 0) h.seconds = record.seconds;
+    h.status = record.status;
+    h.score = record.score;
+    h.has_best = record.has_best;
+    h.best = record.best;
+  }
+
+ public:
+  RunState Run(TSolver& s, const std::vector<std::string>& ids) {
+    RunState state;
+    if (!options.report_filename.empty()) state.Load(options.report_filename);
+    std::vector<std::string> pending;
+    for (auto& id : ids) {
+      if (state[id].status == Status::PENDING) pending.push_back(id);
+    }
+    pending = Schedule(pending);
+
+    auto psolver = s.Clone();
+    size_t finished = 0;
+    std::condition_variable cv;
+    {
+      // ThreadPool destructor should be called before destructor for psolver.
+      ThreadPool tp(std::max(options.nthreads, 1u));
+      for (auto& id : pending) {
+        tp.Submit([&, id]() {
+          RunTask(psolver, id, state);
+          std::unique_lock<std::mutex> lock(mutex);
+          ++finished;
+          cv.notify_one();
+        });
+      }
+      const auto interval =
+          std::chrono::seconds(options.report_interval_in_seconds);
+      std::unique_lock<std::mutex> lock(mutex);
+      while (finished < pending.size()) {
+        cv.wait_for(lock, interval,
+                    [&]() { return finished == pending.size(); });
+        Save(state);
+      }
+    }
+    Save(state);
+    return state;
+  }
+};
+}  // namespace ext
+}  // namespace solvers
@@ -1,10 +1,10 @@
 #pragma once
 
+#include "common/solvers/ext/batch_runner.h"
 #include "common/solvers/ext/run_one.h"
-#include "common/solvers/ext/run_one_thread_safe.h"
-#include "common/thread_pool.h"
 
 #include <string>
+#include <vector>
 
 namespace solvers {
 namespace ext {
@@ -16,19 +16,23 @@ inline void RunN(TSolver& s, unsigned first_problem, unsigned last_problem) {
 }
 
 // Multi threads version
+template <class TSolver>
+inline RunState RunNMT(TSolver& s, unsigned first_problem,
+                       unsigned last_problem,
+                       const typename BatchRunner<TSolver>::Options& options) {
+  std::vector<std::string> ids;
+  for (unsigned i = first_problem; i <= last_problem; ++i)
+    ids.push_back(std::to_string(i));
+  BatchRunner<TSolver> runner(options);
+  return runner.Run(s, ids);
+}
+
 template <class TSolver>
 inline void RunNMT(TSolver& s, unsigned first_problem, unsigned last_problem,
                    unsigned nthreads) {
-  auto psolver = s.Clone();
-  {
-    // ThreadPool desctructor should be called before destructor for psolver.
-    ThreadPool tp(nthreads);
-    for (unsigned i = first_problem; i <= last_problem; ++i) {
-      auto t = std::make_shared<std::packaged_task<void()>>(
-          [&, i]() { RunOneThreadSafe<TSolver>(psolver, std::to_string(i)); });
-      tp.EnqueueTask(std::move(t));
-    }
-  }
+  typename BatchRunner<TSolver>::Options options;
+  options.nthreads = nthreads;
+  RunNMT(s, first_problem, last_problem, options);
 }
 }  // namespace ext
 }  // namespace solvers
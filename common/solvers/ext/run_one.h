@@ -1,33 +1,48 @@
 #pragma once
 
 #include "common/base.h"
+#include "common/solvers/ext/run_state.h"
+#include "common/timer.h"
 
+#include <iostream>
 #include <string>
 
 namespace solvers {
 namespace ext {
+// Solves already loaded problem and updates cached and best solutions.
+// record.best is used as a cache for the score of the best solution, the
+// best solution is loaded from disk only if the new one could beat it.
+// Solve is not interrupted. Run that took more than
+// solver.SoftTimeLimitInSeconds() is marked as TIMEOUT after Solve returns,
+// its solution is still evaluated and saved if it is better.
 template <class TSolver>
-inline void RunOne(TSolver& solver, const std::string& problem_id) {
-  using TProblem = typename TSolver::TProblem;
+inline void RunOne(TSolver& solver, const typename TSolver::TProblem& p,
+                   const std::string& problem_id, RunState::Record& record) {
   using TSolution = typename TSolver::TSolution;
   using TEvaluator = typename TSolver::TEvaluator;
-  TProblem p;
-  if (!p.Load(problem_id)) {
-    assert(false);
-    return;
-  }
+  using TResult = typename TEvaluator::Result;
+  using Status = RunState::Status;
   auto solver_name = solver.Name();
   TSolution s;
   if (!solver.SkipSolutionRead()) {
     s.Load(problem_id, solver_name);
   }
-  bool new_solution = false;
+  bool new_solution = false, timeout = false;
   if (s.Empty()) {
+    Timer t;
     s = solver.Solve(p);
+    record.seconds = t.get_milliseconds() / 1000.;
     new_solution = true;
+    timeout =
+        (t.get_milliseconds() > 1000ull * solver.SoftTimeLimitInSeconds());
   }
   auto r = TEvaluator::Apply(p, s);
-  if (!r.correct) return;
+  if (!r.correct) {
+    record.status = timeout ? Status::TIMEOUT : Status::FAILED;
+    return;
+  }
+  record.status = timeout ? Status::TIMEOUT : Status::DONE;
+  record.score = r.score;
   if (new_solution && !solver.SkipSolutionWrite()) {
     TSolution scache;
     scache.Load(problem_id, solver_name);
@@ -38,14 +53,32 @@ inline void RunOne(TSolver& solver, const std::string& problem_id) {
     }
   }
   if (!solver.SkipBest()) {
+    if (record.has_best && !TEvaluator::Compare(r, TResult(true, record.best)))
+      return;
     TSolution sbest;
     sbest.Load(problem_id, "best");
     const auto rbest = TEvaluator::Apply(p, sbest);
+    record.has_best = true;
     if (TEvaluator::Compare(r, rbest)) {
       std::cout << "New best solution for problem: " << problem_id << std::endl;
       s.Save("best");
+      record.best = r.score;
+    } else {
+      record.best = rbest.score;
     }
   }
 }
+
+template <class TSolver>
+inline void RunOne(TSolver& solver, const std::string& problem_id) {
+  using TProblem = typename TSolver::TProblem;
+  TProblem p;
+  if (!p.Load(problem_id)) {
+    assert(false);
+    return;
+  }
+  RunState::Record record;
+  RunOne<TSolver>(solver, p, problem_id, record);
+}
 }  // namespace ext
 }  // namespace solvers
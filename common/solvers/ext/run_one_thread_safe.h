@@ -13,7 +13,7 @@ inline void RunOneThreadSafe(const typename TSolver::PSolver& psolver,
   assert(psolver);
   auto ptemp = psolver->Clone();
   assert(ptemp);
-  RunOne<TSolver>(*ptemp, problem_id);
+  RunOne(*ptemp, problem_id);
 }
 }  // namespace ext
 }  // namespace solvers
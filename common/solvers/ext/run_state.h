@@ -0,0 +1,131 @@
+#pragma once
+
+#include "common/base.h"
+
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+
+namespace solvers {
+namespace ext {
+// Per problem records of batch runs. The same text format is used for
+// progress reports (to resume interrupted runs) and for runtime history
+// (to schedule long problems first and to cache best scores):
+//   # summary comment
+//   id status seconds score best
+// Unknown values are written as "-", lines starting with '#' are skipped.
+class RunState {
+ public:
+  // TIMEOUT: Solve returned after the solver soft time limit.
+  enum class Status { PENDING, DONE, FAILED, TIMEOUT };
+
+  struct Record {
+    Status status = Status::PENDING;
+    double seconds = -1.;  // Time of the last Solve call, negative if unknown.
+    int64_t score = 0;     // Valid only for DONE.
+    bool has_best = false;
+    int64_t best = 0;  // Score of the best known correct solution.
+  };
+
+ protected:
+  std::map<std::string, Record> records;
+
+  static constexpr const char* status_names[] = {"pending", "done", "failed",
+                                                 "timeout"};
+
+ public:
+  static const char* StatusName(Status s) {
+    return status_names[static_cast<unsigned>(s)];
+  }
+
+  static Status ParseStatus(const std::string& s) {
+    for (unsigned i = 0; i < 4; ++i) {
+      if (s == status_names[i]) return static_cast<Status>(i);
+    }
+    return Status::PENDING;
+  }
+
+  bool Empty() const { return records.empty(); }
+  size_t Size() const { return records.size(); }
+
+  Record& operator[](const std::string& id) { return records[id]; }
+
+  const Record* Find(const std::string& id) const {
+    auto it = records.find(id);
+    return (it == records.end()) ? nullptr : &it->second;
+  }
+
+  const std::map<std::string, Record>& Records() const { return records; }
+
+  size_t Count(Status s) const {
+    size_t r = 0;
+    for (auto& it : records) r += (it.second.status == s) ? 1 : 0;
+    return r;
+  }
+
+  int64_t TotalScore() const {
+    int64_t r = 0;
+    for (auto& it : records) {
+      if (it.second.status == Status::DONE) r += it.second.score;
+    }
+    return r;
+  }
+
+  bool Load(const std::string& filename) {
+    std::ifstream f(filename);
+    if (!f.is_open()) return false;
+    for (std::string line; std::getline(f, line);) {
+      if (line.empty() || (line[0] == '#')) continue;
+      std::istringstream ss(line);
+      std::string id, status, seconds, score, best;
+      if (!(ss >> id >> status >> seconds >> score >> best)) continue;
+      auto& r = records[id];
+      r.status = ParseStatus(status);
+      r.seconds = (seconds == "-") ? -1. : std::stod(seconds);
+      r.score = (score == "-") ? 0 : std::stoll(score);
+      r.has_best = (best != "-");
+      r.best = r.has_best ? std::stoll(best) : 0;
+    }
+    return true;
+  }
+
+  // The file is replaced atomically, so a crash during Save keeps the
+  // previous report.
+  bool Save(const std::string& filename) const {
+    const std::string temp = filename + ".tmp";
+    {
+      std::ofstream f(temp);
+      if (!f.is_open()) return false;
+      f << "# pending " << Count(Status::PENDING) << " done "
+        << Count(Status::DONE) << " failed " << Count(Status::FAILED)
+        << " timeout " << Count(Status::TIMEOUT) << " total_score "
+        << TotalScore() << std::endl;
+      f << "# id status seconds score best" << std::endl;
+      for (auto& it : records) {
+        const auto& r = it.second;
+        f << it.first << " " << StatusName(r.status) << " ";
+        if (r.seconds < 0)
+          f << "-";
+        else
+          f << r.seconds;
+        f << " ";
+        if (r.status == Status::DONE)
+          f << r.score;
+        else
+          f << "-";
+        f << " ";
+        if (r.has_best)
+          f << r.best;
+        else
+          f << "-";
+        f << std::endl;
+      }
+      if (!f.good()) return false;
+    }
+    return std::rename(temp.c_str(), filename.c_str()) == 0;
+  }
+};
+}  // namespace ext
+}  // namespace solvers
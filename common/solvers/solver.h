@@ -25,6 +25,13 @@ class Solver {
   virtual ~Solver() {}
   virtual PSolver Clone() const { return nullptr; }
 
+  // Time budget for a single Solve call, -1u if there is no limit. Solve
+  // is not interrupted, solver should respect it by itself. RunOne only
+  // marks runs that exceeded it as TIMEOUT after Solve returns.
+  constexpr unsigned SoftTimeLimitInSeconds() const {
+    return max_time_in_seconds;
+  }
+
   virtual bool SkipSolutionRead() const { return false; }
   virtual bool SkipSolutionWrite() const { return false; }
   virtual bool SkipBest() const { return false; }
@@ -1,21 +1,248 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
 #include <functional>
 #include <future>
+#include <map>
 #include <memory>
 #include <mutex>
-#include <queue>
+#include <new>
 #include <stdexcept>
 #include <thread>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 /**
- * @brief A simple thread pool implementation.
+ * @brief A work-stealing thread pool.
  *
- * This class manages a pool of worker threads to which tasks can be submitted.
+ * Every worker owns a Chase-Lev deque. Tasks submitted from a worker go to
+ * its own deque, tasks submitted from other threads go to a shared
+ * injection queue. Idle workers steal from other deques. Tasks are stored in
+ * recycled nodes with a small inline buffer, so submitting a small callable
+ * does not allocate.
+ *
+ * Threads waiting through Wait, ParallelFor or ParallelReduce execute other
+ * tasks of the pool while waiting, so tasks could submit and wait for
+ * subtasks without blocking a worker. The waiting thread could run any
+ * queued task, not only its subtasks, so a task that waits while holding a
+ * lock must not share this lock with other tasks of the pool (the lock
+ * would be reentered or deadlock). If nothing could be run, waiting and idle
+ * threads spin for a short time and then sleep.
+ *
+ * Exceptions thrown by f in ParallelFor and ParallelReduce are rethrown in
+ * the calling thread (the first one if there are several). Exceptions from
+ * Enqueue tasks are stored in the future, exceptions from Submit tasks are
+ * ignored.
  */
 class ThreadPool {
+ protected:
+  /**
+   * @brief Type-erased move-only callable with small buffer storage.
+   */
+  class Task {
+   public:
+    static constexpr size_t buffer_size = 48;
+
+   protected:
+    alignas(std::max_align_t) unsigned char buffer[buffer_size];
+    /// Runs (if invoke is set) and destroys the callable.
+    void (*run)(Task*, bool invoke) = nullptr;
+
+   public:
+    Task* next = nullptr;  ///< Link for the free list.
+
+    template <class F>
+    void Set(F&& f) {
+      using TF = std::decay_t<F>;
+      if constexpr ((sizeof(TF) <= buffer_size) &&
+                    (alignof(TF) <= alignof(std::max_align_t)) &&
+                    std::is_nothrow_move_constructible_v<TF>) {
+        new (buffer) TF(std::forward<F>(f));
+        run = [](Task* t, bool invoke) {
+          TF* pf = std::launder(reinterpret_cast<TF*>(t->buffer));
+          struct Destroy {
+            TF* pf;
+            ~Destroy() { pf->~TF(); }
+          } d{pf};
+          if (invoke) (*pf)();
+        };
+      } else {
+        new (buffer) TF*(new TF(std::forward<F>(f)));
+        run = [](Task* t, bool invoke) {
+          std::unique_ptr<TF> pf(
+              *std::launder(reinterpret_cast<TF**>(t->buffer)));
+          if (invoke) (*pf)();
+        };
+      }
+    }
+
+    void Run() { run(this, true); }
+
+    /// Destroys the callable without invoking it.
+    void Destroy() { run(this, false); }
+  };
+
+  /**
+   * @brief Per thread cache of free task nodes.
+   */
+  class TaskCache {
+   protected:
+    static constexpr size_t max_size = 1024;
+
+    Task* head = nullptr;
+    size_t size = 0;
+
+   public:
+    ~TaskCache() {
+      for (; head;) delete Pop();
+    }
+
+    Task* Pop() {
+      Task* t = head;
+      head = t->next;
+      --size;
+      return t;
+    }
+
+    Task* Allocate() { return head ? Pop() : new Task; }
+
+    void Release(Task* t) {
+      if (size >= max_size) {
+        delete t;
+      } else {
+        t->next = head;
+        head = t;
+        ++size;
+      }
+    }
+  };
+
+  static TaskCache& GetTaskCache() {
+    thread_local TaskCache cache;
+    return cache;
+  }
+
+  /**
+   * @brief Chase-Lev work-stealing deque (Le, Pop, Cohen, Zappa Nardelli,
+   * "Correct and Efficient Work-Stealing for Weak Memory Models").
+   *
+   * Push and Pop are called only by the owner, Steal by any thread. Arrays
+   * replaced on growth are kept until destruction.
+   */
+  class Deque {
+   protected:
+    struct Array {
+      int64_t capacity;
+      std::unique_ptr<std::atomic<Task*>[]> data;
+
+      explicit Array(int64_t _capacity)
+          : capacity(_capacity), data(new std::atomic<Task*>[_capacity]) {}
+
+      Task* Get(int64_t i) const {
+        return data[i & (capacity - 1)].load(std::memory_order_relaxed);
+      }
+
+      void Put(int64_t i, Task* t) {
+        data[i & (capacity - 1)].store(t, std::memory_order_relaxed);
+      }
+    };
+
+    alignas(64) std::atomic<int64_t> top;
+    alignas(64) std::atomic<int64_t> bottom;
+    std::atomic<Array*> array;
+    std::vector<std::unique_ptr<Array>> arrays;
+
+   public:
+    Deque() : top(0), bottom(0) {
+      arrays.push_back(std::make_unique<Array>(256));
+      array.store(arrays.back().get(), std::memory_order_relaxed);
+    }
+
+    void Push(Task* task) {
+      const int64_t b = bottom.load(std::memory_order_relaxed),
+                    t = top.load(std::memory_order_acquire);
+      Array* a = array.load(std::memory_order_relaxed);
+      if (b - t > a->capacity - 1) {
+        arrays.push_back(std::make_unique<Array>(2 * a->capacity));
+        Array* na = arrays.back().get();
+        for (int64_t i = t; i < b; ++i) na->Put(i, a->Get(i));
+        array.store(na, std::memory_order_release);
+        a = na;
+      }
+      a->Put(b, task);
+      std::atomic_thread_fence(std::memory_order_release);
+      bottom.store(b + 1, std::memory_order_relaxed);
+    }
+
+    Task* Pop() {
+      const int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+      Array* a = array.load(std::memory_order_relaxed);
+      bottom.store(b, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      int64_t t = top.load(std::memory_order_relaxed);
+      Task* task = nullptr;
+      if (t <= b) {
+        task = a->Get(b);
+        if (t == b) {
+          if (!top.compare_exchange_strong(t, t + 1,
+                                           std::memory_order_seq_cst,
+                                           std::memory_order_relaxed))
+            task = nullptr;
+          bottom.store(b + 1, std::memory_order_relaxed);
+        }
+      } else {
+        bottom.store(b + 1, std::memory_order_relaxed);
+      }
+      return task;
+    }
+
+    Task* Steal() {
+      int64_t t = top.load(std::memory_order_acquire);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      const int64_t b = bottom.load(std::memory_order_acquire);
+      if (t >= b) return nullptr;
+      Array* a = array.load(std::memory_order_acquire);
+      Task* task = a->Get(t);
+      if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                       std::memory_order_relaxed))
+        return nullptr;
+      return task;
+    }
+  };
+
+  struct Worker {
+    Deque deque;
+    std::thread thread;
+  };
+
+  struct Current {
+    const ThreadPool* pool = nullptr;
+    size_t index = 0;
+  };
+
+  static Current& GetCurrent() {
+    thread_local Current current;
+    return current;
+  }
+
+  struct Counters {
+    std::atomic<size_t> next = 0, done = 0;
+    std::atomic<bool> failed = false;
+    std::mutex error_mutex;
+    std::exception_ptr error;
+  };
+
+  /// Number of failed attempts to find a task before sleeping.
+  static constexpr unsigned spin_limit = 64;
+
  public:
   /**
    * @brief Constructs a ThreadPool and launches the specified number of worker
@@ -23,26 +250,62 @@ class ThreadPool {
    *
    * @param threads The number of worker threads to launch.
    */
-  explicit ThreadPool(size_t threads) : stop(false) {
+  explicit ThreadPool(size_t threads)
+      : injection_size(0),
+        stop(false),
+        pending(0),
+        pushes(0),
+        sleeping(0),
+        waiting(0) {
     for (size_t i = 0; i < threads; ++i)
-      workers.emplace_back([this] {
-        for (;;) {
-          std::function<void()> task;
-
-          {
-            std::unique_lock<std::mutex> lock(this->queue_mutex);
-            this->condition.wait(
-                lock, [this] { return this->stop || !this->tasks.empty(); });
-            if (this->stop && this->tasks.empty()) {
-              return;
-            }
-            task = std::move(this->tasks.front());
-            this->tasks.pop();
-          }
-
-          task();
-        }
-      });
+      workers.emplace_back(std::make_unique<Worker>());
+    for (size_t i = 0; i < threads; ++i)
+      workers[i]->thread = std::thread([this, i] { WorkerLoop(i); });
+  }
+
+  /**
+   * @brief Destructs the ThreadPool. Waits until all submitted tasks are
+   * done and joins all threads.
+   */
+  ~ThreadPool() {
+    {
+      std::unique_lock<std::mutex> lock(sleep_mutex);
+      stop.store(true);
+    }
+    condition.notify_all();
+    for (auto& worker : workers) worker->thread.join();
+  }
+
+  /**
+   * @brief Returns the number of worker threads.
+   */
+  size_t Size() const { return workers.size(); }
+
+  /**
+   * @brief Returns a pool with the given number of workers shared by all
+   * callers. The pool is created on first request and lives until the end
+   * of the program, so functions with a threads parameter do not start new
+   * threads on every call.
+   */
+  static ThreadPool& Shared(size_t threads) {
+    static std::mutex m;
+    static std::map<size_t, std::unique_ptr<ThreadPool>> pools;
+    std::lock_guard<std::mutex> lock(m);
+    auto& pool = pools[threads];
+    if (!pool) pool = std::make_unique<ThreadPool>(threads);
+    return *pool;
+  }
+
+  /**
+   * @brief Adds a new task to the pool without a future.
+   *
+   * @param f The move constructible callable to be executed.
+   */
+  template <class F>
+  void Submit(F&& f) {
+    Task* t = GetTaskCache().Allocate();
+    t->Set(std::forward<F>(f));
+    Push(t);
   }
 
   /**
@@ -56,12 +319,17 @@ class ThreadPool {
    */
   template <typename F, typename... Args>
   auto Enqueue(F&& f, Args&&... args)
-      -> std::future<typename std::invoke_result<F(Args...)>::type> {
-    using return_type = typename std::invoke_result<F(Args...)>::type;
+      -> std::future<std::invoke_result_t<F, Args...>> {
+    using return_type = std::invoke_result_t<F, Args...>;
 
-    auto task = std::make_shared<std::packaged_task<return_type()>>(
-        std::bind(std::forward<F>(f), std::forward<Args>(args)...));
-    return EnqueueTask(std::move(task));
+    std::packaged_task<return_type()> task(
+        [f = std::forward<F>(f),
+         ... args = std::forward<Args>(args)]() mutable -> return_type {
+          return std::invoke(std::move(f), std::move(args)...);
+        });
+    auto res = task.get_future();
+    Submit(std::move(task));
+    return res;
   }
 
   /**
@@ -75,41 +343,234 @@ class ThreadPool {
   auto EnqueueTask(std::shared_ptr<std::packaged_task<T()>>&& task)
       -> std::future<T> {
     std::future<T> res = task->get_future();
-    {
-      std::unique_lock<std::mutex> lock(queue_mutex);
+    Submit([task = std::move(task)]() { (*task)(); });
+    return res;
+  }
+
+  /**
+   * @brief Runs other tasks from the pool until ready() returns true.
+   */
+  template <class TPredicate>
+  void WaitUntil(const TPredicate& ready) {
+    for (unsigned idle = 0; !ready();) {
+      if (RunOneTask()) {
+        idle = 0;
+      } else if (++idle < spin_limit) {
+        std::this_thread::yield();
+      } else {
+        idle = 0;
+        // Woken up when a task is pushed or finished, timeout covers
+        // predicates changed outside of the pool.
+        const size_t epoch = pushes.load();
+        std::unique_lock<std::mutex> lock(wait_mutex);
+        waiting.fetch_add(1);
+        wait_condition.wait_for(lock, std::chrono::milliseconds(1), [&]() {
+          return ready() || (pushes.load() != epoch);
+        });
+        waiting.fetch_sub(1);
+      }
+    }
+  }
+
+  /**
+   * @brief Waits for the future, running other tasks in the meantime.
+   * Safe to call from a task of this pool.
+   */
+  template <class T>
+  T Wait(std::future<T>& f) {
+    WaitUntil([&f]() {
+      return f.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    });
+    return f.get();
+  }
+
+  /**
+   * @brief Calls f(i) for i in [first, last). The range is split in chunks
+   * claimed dynamically by workers and by the calling thread.
+   *
+   * @param chunk Number of indices per chunk, 0 for automatic choice.
+   */
+  template <class F>
+  void ParallelFor(size_t first, size_t last, const F& f, size_t chunk = 0) {
+    if (first >= last) return;
+    chunk = GetChunkSize(last - first, chunk);
+    ForEachChunk((last - first + chunk - 1) / chunk, [&](size_t c) {
+      const size_t b = first + c * chunk, e = std::min(last, b + chunk);
+      for (size_t i = b; i < e; ++i) f(i);
+    });
+  }
+
+  /**
+   * @brief Returns reduce(...reduce(reduce(identity, f(first)), f(first+1))
+   * ..., f(last-1)) computed in parallel. Partial results are combined in
+   * chunk order, so reduce needs to be associative but not commutative.
+   *
+   * @param chunk Number of indices per chunk, 0 for automatic choice.
+   */
+  template <class T, class F, class FReduce>
+  T ParallelReduce(size_t first, size_t last, const T& identity, const F& f,
+                   const FReduce& reduce, size_t chunk = 0) {
+    if (first >= last) return identity;
+    chunk = GetChunkSize(last - first, chunk);
+    struct Slot {
+      T value;
+    };
+    std::vector<Slot> partial((last - first + chunk - 1) / chunk,
+                              Slot{identity});
+    ForEachChunk(partial.size(), [&](size_t c) {
+      const size_t b = first + c * chunk, e = std::min(last, b + chunk);
+      T r = identity;
+      for (size_t i = b; i < e; ++i) r = reduce(r, f(i));
+      partial[c].value = std::move(r);
+    });
+    T r = identity;
+    for (auto& s : partial) r = reduce(r, s.value);
+    return r;
+  }
+
+ protected:
+  size_t GetChunkSize(size_t n, size_t chunk) const {
+    return chunk ? chunk : std::max<size_t>(1, n / (8 * (workers.size() + 1)));
+  }
+
+  template <class F>
+  void ForEachChunk(size_t chunks, const F& f) {
+    if (workers.empty() || (chunks <= 1)) {
+      for (size_t c = 0; c < chunks; ++c) f(c);
+      return;
+    }
+    // f is used only until done reaches chunks, so the caller frame
+    // outlives all calls even if f throws. Chunks after a failure are
+    // skipped.
+    auto counters = std::make_shared<Counters>();
+    auto work = [counters, chunks, pf = &f]() {
+      for (size_t c; (c = counters->next.fetch_add(1)) < chunks;
+           counters->done.fetch_add(1, std::memory_order_release)) {
+        if (counters->failed.load(std::memory_order_relaxed)) continue;
+        try {
+          (*pf)(c);
+        } catch (...) {
+          std::unique_lock<std::mutex> lock(counters->error_mutex);
+          if (!counters->error) counters->error = std::current_exception();
+          counters->failed.store(true, std::memory_order_relaxed);
+        }
+      }
+    };
+    const size_t helpers = std::min(workers.size(), chunks - 1);
+    for (size_t i = 0; i < helpers; ++i) Submit(work);
+    work();
+    WaitUntil([&]() {
+      return counters->done.load(std::memory_order_acquire) == chunks;
+    });
+    if (counters->error) std::rethrow_exception(counters->error);
+  }
+
+  void Push(Task* t) {
+    const Current& current = GetCurrent();
+    if (current.pool == this) {
+      pending.fetch_add(1);
+      workers[current.index]->deque.Push(t);
+    } else {
+      std::unique_lock<std::mutex> lock(injection_mutex);
 
       // don't allow enqueueing after stopping the pool
       if (stop) {
+        t->Destroy();
+        GetTaskCache().Release(t);
         throw std::runtime_error("Enqueue on stopped ThreadPool");
       }
 
-      tasks.emplace([task]() { (*task)(); });
+      pending.fetch_add(1);
+      injection.push_back(t);
+      injection_size.store(injection.size(), std::memory_order_relaxed);
     }
-    condition.notify_one();
-    return res;
+    pushes.fetch_add(1);
+    if (sleeping.load() > 0) {
+      std::unique_lock<std::mutex> lock(sleep_mutex);
+      condition.notify_one();
+    }
+    NotifyWaiting();
   }
 
-  /**
-   * @brief Destructs the ThreadPool and joins all threads.
-   */
-  ~ThreadPool() {
-    {
-      std::unique_lock<std::mutex> lock(queue_mutex);
-      stop = true;
+  void NotifyWaiting() {
+    if (waiting.load() > 0) {
+      std::unique_lock<std::mutex> lock(wait_mutex);
+      wait_condition.notify_all();
     }
-    condition.notify_all();
-    for (std::thread& worker : workers) {
-      worker.join();
+  }
+
+  Task* FindTask() {
+    const Current& current = GetCurrent();
+    const bool is_worker = (current.pool == this);
+    Task* t = nullptr;
+    if (is_worker) t = workers[current.index]->deque.Pop();
+    if (!t && (injection_size.load(std::memory_order_relaxed) > 0)) {
+      std::unique_lock<std::mutex> lock(injection_mutex);
+      if (!injection.empty()) {
+        t = injection.front();
+        injection.pop_front();
+        injection_size.store(injection.size(), std::memory_order_relaxed);
+      }
+    }
+    const size_t n = workers.size(), first = is_worker ? current.index : 0;
+    for (size_t i = 1; !t && (i <= n); ++i)
+      t = workers[(first + i) % n]->deque.Steal();
+    if (t) pending.fetch_sub(1);
+    return t;
+  }
+
+  bool RunOneTask() {
+    Task* t = FindTask();
+    if (!t) return false;
+    try {
+      t->Run();
+    } catch (...) {
+      // Submit task failed, the worker should keep running.
+    }
+    GetTaskCache().Release(t);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    NotifyWaiting();
+    return true;
+  }
+
+  void WorkerLoop(size_t index) {
+    GetCurrent() = {this, index};
+    for (;;) {
+      const size_t epoch = pushes.load();
+      bool found = false;
+      for (unsigned i = 0; !found && (i < spin_limit); ++i) {
+        found = RunOneTask();
+        if (!found) std::this_thread::yield();
+      }
+      if (found) continue;
+      // Sleep until the next push. Tasks counted in pending but not found
+      // are taken by other threads, timeout covers the rest.
+      std::unique_lock<std::mutex> lock(sleep_mutex);
+      sleeping.fetch_add(1);
+      auto ready = [&]() { return stop || (pushes.load() != epoch); };
+      if (pending.load() > 0)
+        condition.wait_for(lock, std::chrono::milliseconds(1), ready);
+      else
+        condition.wait(lock, ready);
+      sleeping.fetch_sub(1);
+      if (stop && (pending.load() == 0)) return;
     }
   }
 
  protected:
-  std::vector<std::thread> workers;         ///< Vector of worker threads.
-  std::queue<std::function<void()>> tasks;  ///< Queue of tasks.
-
-  std::mutex
-      queue_mutex;  ///< Mutex for synchronizing access to the task queue.
-  std::condition_variable
-      condition;  ///< Condition variable for task notification.
-  bool stop;      ///< Flag indicating whether the pool is stopping.
+  std::vector<std::unique_ptr<Worker>> workers;  ///< Worker threads.
+  std::deque<Task*> injection;  ///< Tasks submitted from other threads.
+  std::mutex injection_mutex;   ///< Mutex for the injection queue.
+  std::atomic<size_t> injection_size;  ///< Size hint for the injection queue.
+
+  std::mutex sleep_mutex;             ///< Mutex for idle workers.
+  std::condition_variable condition;  ///< Condition for idle workers.
+  std::atomic<bool> stop;             ///< Pool is stopping.
+  std::atomic<size_t> pending;        ///< Number of queued tasks.
+  std::atomic<size_t> pushes;         ///< Number of pushed tasks.
+  std::atomic<size_t> sleeping;       ///< Number of idle workers.
+
+  std::mutex wait_mutex;                   ///< Mutex for sleeping waiters.
+  std::condition_variable wait_condition;  ///< Condition for waiters.
+  std::atomic<size_t> waiting;             ///< Number of sleeping waiters.
 };
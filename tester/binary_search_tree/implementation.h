@@ -11,6 +11,7 @@
 #include "common/binary_search_tree/wavl_tree.h"
 #include "common/binary_search_tree/weight_balanced_tree.h"
 #include "common/binary_search_tree/weight_balanced_tree2.h"
+#include "common/memory/arena_nodes_manager.h"
 
 #include <string_view>
 #include <tuple>
@@ -265,6 +266,25 @@ class HKT_HPT_Treap
   static constexpr std::string_view id() { return "hpt_treap"; }
 };
 
+// Treap on ArenaNodesManager
+template <typename Data, typename Key, typename AggregatorsTuple,
+          typename DeferredTuple>
+class HKF_HPT_TreapArena
+    : public Base<::bst::Treap<false, true, Data, AggregatorsTuple,
+                               DeferredTuple, Key, memory::ArenaNodesManager>> {
+ public:
+  static constexpr std::string_view id() { return "hpt_treap_arena"; }
+};
+
+template <typename Data, typename Key, typename AggregatorsTuple,
+          typename DeferredTuple>
+class HKT_HPT_TreapArena
+    : public Base<::bst::Treap<true, true, Data, AggregatorsTuple,
+                               DeferredTuple, Key, memory::ArenaNodesManager>> {
+ public:
+  static constexpr std::string_view id() { return "hpt_treap_arena"; }
+};
+
 // Unbalanced Tree implementation
 template <typename Data, typename Key, typename AggregatorsTuple,
           typename DeferredTuple>
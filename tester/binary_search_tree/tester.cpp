@@ -82,7 +82,8 @@ bool test(TestType test_type, std::string_view implementation_filter) {
           impl::HKT_HPT_Scapegoat, impl::HKF_HPT_Splay, impl::HKT_HPT_Splay,
           impl::HKF_HPF_Static, impl::HKF_HPT_Static, impl::HKT_HPF_Static,
           impl::HKT_HPT_Static, impl::HKF_HPF_Treap, impl::HKF_HPT_Treap,
-          impl::HKT_HPF_Treap, impl::HKT_HPT_Treap, impl::HKF_HPF_Unbalanced,
+          impl::HKT_HPF_Treap, impl::HKT_HPT_Treap, impl::HKF_HPT_TreapArena,
+          impl::HKT_HPT_TreapArena, impl::HKF_HPF_Unbalanced,
           impl::HKF_HPT_Unbalanced, impl::HKT_HPF_Unbalanced,
           impl::HKT_HPT_Unbalanced, impl::HKF_HPF_WAVL, impl::HKF_HPT_WAVL,
           impl::HKT_HPF_WAVL, impl::HKT_HPT_WAVL, impl::HKF_HPF_WBT,
@@ -122,12 +123,12 @@ bool test(TestType test_type, std::string_view implementation_filter) {
           impl::HKF_HPF_Scapegoat, impl::HKF_HPT_Scapegoat,
           impl::HKT_HPF_Scapegoat, impl::HKT_HPT_Scapegoat, impl::HKF_HPT_Splay,
           impl::HKT_HPT_Splay, impl::HKF_HPF_Treap, impl::HKF_HPT_Treap,
-          impl::HKT_HPF_Treap, impl::HKT_HPT_Treap, impl::HKF_HPF_WAVL,
-          impl::HKF_HPT_WAVL, impl::HKT_HPF_WAVL, impl::HKT_HPT_WAVL,
-          impl::HKF_HPF_WBT, impl::HKF_HPT_WBT, impl::HKT_HPF_WBT,
-          impl::HKT_HPT_WBT, impl::HKF_HPF_WBT2, impl::HKF_HPT_WBT2,
-          impl::HKT_HPF_WBT2, impl::HKT_HPT_WBT2>(100000,
-                                                  implementation_filter);
+          impl::HKT_HPF_Treap, impl::HKT_HPT_Treap, impl::HKF_HPT_TreapArena,
+          impl::HKT_HPT_TreapArena, impl::HKF_HPF_WAVL, impl::HKF_HPT_WAVL,
+          impl::HKT_HPF_WAVL, impl::HKT_HPT_WAVL, impl::HKF_HPF_WBT,
+          impl::HKF_HPT_WBT, impl::HKT_HPF_WBT, impl::HKT_HPT_WBT,
+          impl::HKF_HPF_WBT2, impl::HKF_HPT_WBT2, impl::HKT_HPF_WBT2,
+          impl::HKT_HPT_WBT2>(100000, implementation_filter);
     }
 
     case TestType::kSplitJoin: {
@@ -142,12 +143,12 @@ bool test(TestType test_type, std::string_view implementation_filter) {
           impl::HKF_HPF_RedBlack, impl::HKT_HPF_RedBlack,
           impl::HKF_HPT_RedBlack, impl::HKT_HPT_RedBlack, impl::HKF_HPT_Splay,
           impl::HKT_HPT_Splay, impl::HKF_HPF_Treap, impl::HKF_HPT_Treap,
-          impl::HKT_HPF_Treap, impl::HKT_HPT_Treap, impl::HKF_HPF_WAVL,
-          impl::HKF_HPT_WAVL, impl::HKT_HPF_WAVL, impl::HKT_HPT_WAVL,
-          impl::HKF_HPF_WBT, impl::HKF_HPT_WBT, impl::HKT_HPF_WBT,
-          impl::HKT_HPT_WBT, impl::HKF_HPF_WBT2, impl::HKF_HPT_WBT2,
-          impl::HKT_HPF_WBT2, impl::HKT_HPT_WBT2>(100000,
-                                                  implementation_filter);
+          impl::HKT_HPF_Treap, impl::HKT_HPT_Treap, impl::HKF_HPT_TreapArena,
+          impl::HKT_HPT_TreapArena, impl::HKF_HPF_WAVL, impl::HKF_HPT_WAVL,
+          impl::HKT_HPF_WAVL, impl::HKT_HPT_WAVL, impl::HKF_HPF_WBT,
+          impl::HKF_HPT_WBT, impl::HKT_HPF_WBT, impl::HKT_HPT_WBT,
+          impl::HKF_HPF_WBT2, impl::HKF_HPT_WBT2, impl::HKT_HPF_WBT2,
+          impl::HKT_HPT_WBT2>(100000, implementation_filter);
     }
 
     case TestType::kExpensiveData: {
@@ -168,12 +169,12 @@ bool test(TestType test_type, std::string_view implementation_filter) {
           impl::HKF_HPF_Scapegoat, impl::HKF_HPT_Scapegoat,
           impl::HKT_HPF_Scapegoat, impl::HKT_HPT_Scapegoat, impl::HKF_HPT_Splay,
           impl::HKT_HPT_Splay, impl::HKF_HPF_Treap, impl::HKF_HPT_Treap,
-          impl::HKT_HPF_Treap, impl::HKT_HPT_Treap, impl::HKF_HPF_WAVL,
-          impl::HKF_HPT_WAVL, impl::HKT_HPF_WAVL, impl::HKT_HPT_WAVL,
-          impl::HKF_HPF_WBT, impl::HKF_HPT_WBT, impl::HKT_HPF_WBT,
-          impl::HKT_HPT_WBT, impl::HKF_HPF_WBT2, impl::HKF_HPT_WBT2,
-          impl::HKT_HPF_WBT2, impl::HKT_HPT_WBT2>(100000,
-                                                  implementation_filter);
+          impl::HKT_HPF_Treap, impl::HKT_HPT_Treap, impl::HKF_HPT_TreapArena,
+          impl::HKT_HPT_TreapArena, impl::HKF_HPF_WAVL, impl::HKF_HPT_WAVL,
+          impl::HKT_HPF_WAVL, impl::HKT_HPT_WAVL, impl::HKF_HPF_WBT,
+          impl::HKF_HPT_WBT, impl::HKT_HPF_WBT, impl::HKT_HPT_WBT,
+          impl::HKF_HPF_WBT2, impl::HKF_HPT_WBT2, impl::HKT_HPF_WBT2,
+          impl::HKT_HPT_WBT2>(100000, implementation_filter);
     }
 
     default:
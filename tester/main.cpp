@@ -30,12 +30,20 @@ int main(int nargs, char **pargs) {
     } else if (tester_mode == "bst_split_join") {
       assert_exception(tester::bst::test(tester::bst::TestType::kSplitJoin,
                                          implementation_filter));
+    } else if (tester_mode == "batch_runner") {
+      assert_exception(TestBatchRunner());
     } else if (tester_mode == "convergent") {
       assert_exception(TestContinuedFractionConvergent());
+    } else if (tester_mode == "discrete_log") {
+      assert_exception(TestDiscreteLog(false));
+    } else if (tester_mode == "factorization") {
+      assert_exception(TestFactorization(false));
     } else if (tester_mode == "find_primes_for_modular_fft") {
       FindPrimesForModularFFT(10);
     } else if (tester_mode == "fixed_universe_successor") {
       assert_exception(TestFixedUniverseSuccessor(false));
+    } else if (tester_mode == "flat_hash_map") {
+      assert_exception(TestFlatHashMap(false));
     } else if (tester_mode == "generating_function") {
       assert_exception(TestGeneratingFunction());
     } else if (tester_mode == "graph_distance") {
@@ -44,6 +52,8 @@ int main(int nargs, char **pargs) {
       assert_exception(TestGraphEIDistanceUnsigned(false));
     } else if (tester_mode == "graph_distance_positive_cost") {
       assert_exception(TestGraphEIDistancePositiveCost(false));
+    } else if (tester_mode == "graph_grid") {
+      assert_exception(TestGraphGrid(false));
     } else if (tester_mode == "graph_dynamic_connectivity") {
       assert_exception(TestGraphDynamicConnectivity(false));
     } else if (tester_mode == "heap_base") {
@@ -51,11 +61,21 @@ int main(int nargs, char **pargs) {
     } else if (tester_mode == "heap_ext") {
       assert_exception(TestHeapExt(false));
     } else if (tester_mode == "interpolation") {
-      assert_exception(TestInterpolation());
+      assert_exception(TestInterpolation(false));
+    } else if (tester_mode == "long_div") {
+      assert_exception(TestLongDiv());
+    } else if (tester_mode == "long_io") {
+      assert_exception(TestLongIO(false));
     } else if (tester_mode == "long_mult") {
-      assert_exception(TestLongMult());
+      assert_exception(TestLongMult(false));
     } else if (tester_mode == "lowest_common_ancestor") {
       assert_exception(TestLowestCommonAncestor(false));
+    } else if (tester_mode == "matrix_bool") {
+      assert_exception(TestMatrixBool(false));
+    } else if (tester_mode == "matrix_mult") {
+      assert_exception(TestMatrixMult(false));
+    } else if (tester_mode == "max_flow") {
+      assert_exception(TestMaxFlow(false));
     } else if (tester_mode == "mertens") {
       assert_exception(TestMertens());
     } else if (tester_mode == "mertens_compact") {
@@ -64,40 +84,70 @@ int main(int nargs, char **pargs) {
       assert_exception(TestMinimumSpanningTree(false));
     } else if (tester_mode == "modular_fft") {
       assert_exception(TestModularFFT());
+    } else if (tester_mode == "power_series") {
+      assert_exception(TestPowerSeries(false));
+    } else if (tester_mode == "primality_test") {
+      assert_exception(TestPrimalityTest(false));
     } else if (tester_mode == "primes_count") {
       assert_exception(TestPrimesCount(false));
     } else if (tester_mode == "primes_generation") {
       assert_exception(TestPrimesGeneration(false));
     } else if (tester_mode == "range_minimum_query") {
       assert_exception(TestRangeMinimumQuery(false));
+    } else if (tester_mode == "thread_pool") {
+      assert_exception(TestThreadPool(false));
+    } else if (tester_mode == "time_discrete_log") {
+      assert_exception(TestDiscreteLog(true));
     } else if (tester_mode == "time_disjoint_set") {
       assert_exception(TestDisjointSet());
+    } else if (tester_mode == "time_factorization") {
+      assert_exception(TestFactorization(true));
     } else if (tester_mode == "time_fixed_universe_successor") {
       assert_exception(TestFixedUniverseSuccessor(true));
+    } else if (tester_mode == "time_flat_hash_map") {
+      assert_exception(TestFlatHashMap(true));
     } else if (tester_mode == "time_graph_distance") {
       assert_exception(TestGraphEIDistance(true));
     } else if (tester_mode == "time_graph_distance_unsigned") {
       assert_exception(TestGraphEIDistanceUnsigned(true));
     } else if (tester_mode == "time_graph_distance_positive_cost") {
       assert_exception(TestGraphEIDistancePositiveCost(true));
+    } else if (tester_mode == "time_graph_grid") {
+      assert_exception(TestGraphGrid(true));
     } else if (tester_mode == "time_graph_dynamic_connectivity") {
       assert_exception(TestGraphDynamicConnectivity(true));
     } else if (tester_mode == "time_heap_base") {
       assert_exception(TestHeapBase(true));
     } else if (tester_mode == "time_heap_ext") {
       assert_exception(TestHeapExt(true));
+    } else if (tester_mode == "time_interpolation") {
+      assert_exception(TestInterpolation(true));
     } else if (tester_mode == "time_lowest_common_ancestor") {
       assert_exception(TestLowestCommonAncestor(true));
+    } else if (tester_mode == "time_long_io") {
+      assert_exception(TestLongIO(true));
+    } else if (tester_mode == "time_long_mult") {
+      assert_exception(TestLongMult(true));
+    } else if (tester_mode == "time_matrix_bool") {
+      assert_exception(TestMatrixBool(true));
     } else if (tester_mode == "time_matrix_mult") {
-      assert_exception(TestMatrixMult());
+      assert_exception(TestMatrixMult(true));
+    } else if (tester_mode == "time_max_flow") {
+      assert_exception(TestMaxFlow(true));
     } else if (tester_mode == "time_minimum_spanning_tree") {
       assert_exception(TestMinimumSpanningTree(true));
+    } else if (tester_mode == "time_power_series") {
+      assert_exception(TestPowerSeries(true));
+    } else if (tester_mode == "time_primality_test") {
+      assert_exception(TestPrimalityTest(true));
     } else if (tester_mode == "time_primes_count") {
       assert_exception(TestPrimesCount(true));
     } else if (tester_mode == "time_primes_generation") {
       assert_exception(TestPrimesGeneration(true));
     } else if (tester_mode == "time_range_minimum_query") {
       assert_exception(TestRangeMinimumQuery(true));
+    } else if (tester_mode == "time_thread_pool") {
+      assert_exception(TestThreadPool(true));
     } else if (tester_mode == "time_tree_path_maxima") {
       assert_exception(TestTreePathMaxima(true));
     } else if (tester_mode == "tree_path_maxima") {
@@ -0,0 +1,194 @@
+#include "common/solvers/evaluator.h"
+#include "common/solvers/ext/batch_runner.h"
+#include "common/solvers/ext/run_n.h"
+#include "common/solvers/ext/run_state.h"
+#include "common/solvers/solver.h"
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+// In memory solutions, key is (solution name, problem id).
+std::mutex storage_mutex;
+std::map<std::pair<std::string, std::string>, int64_t> storage;
+
+class Problem {
+ public:
+  std::string id;
+  int64_t value = 0;
+
+  bool Load(const std::string& _id) {
+    id = _id;
+    value = std::stoll(id);
+    return true;
+  }
+};
+
+class Solution {
+ public:
+  std::string id;
+  int64_t value = 0;
+
+  bool Empty() const { return value == 0; }
+
+  bool Load(const std::string& _id, const std::string& name) {
+    std::unique_lock<std::mutex> lock(storage_mutex);
+    id = _id;
+    auto it = storage.find({name, id});
+    value = (it == storage.end()) ? 0 : it->second;
+    return value != 0;
+  }
+
+  void Save(const std::string& name) const {
+    std::unique_lock<std::mutex> lock(storage_mutex);
+    storage[{name, id}] = value;
+  }
+};
+
+// Solution is correct if it is a multiple of problem value, smaller is
+// better.
+class Evaluator : public solvers::Evaluator {
+ public:
+  static Result Apply(const Problem& p, const Solution& s) {
+    if (s.Empty() || (s.value % p.value)) return {};
+    return {true, s.value};
+  }
+};
+
+// Returns factor * problem value and logs the order of Solve calls.
+class Solver : public solvers::Solver<Problem, Solution, Evaluator> {
+ public:
+  using TBase = solvers::Solver<Problem, Solution, Evaluator>;
+
+ protected:
+  int64_t factor;
+  unsigned sleep_ms;
+  bool skip_read;
+  std::shared_ptr<std::vector<std::string>> log;
+
+ public:
+  Solver(int64_t _factor, unsigned max_time, unsigned _sleep_ms = 0,
+         bool _skip_read = false)
+      : TBase(max_time),
+        factor(_factor),
+        sleep_ms(_sleep_ms),
+        skip_read(_skip_read),
+        log(std::make_shared<std::vector<std::string>>()) {}
+
+  PSolver Clone() const override { return std::make_shared<Solver>(*this); }
+
+  bool SkipSolutionRead() const override { return skip_read; }
+  std::string Name() const override { return "test"; }
+
+  Solution Solve(const Problem& p) override {
+    if (sleep_ms)
+      std::this_thread::sleep_for(std::chrono::milliseconds(sleep_ms));
+    {
+      std::unique_lock<std::mutex> lock(storage_mutex);
+      log->push_back(p.id);
+    }
+    return {p.id, factor * p.value};
+  }
+
+  const std::vector<std::string>& Log() const { return *log; }
+};
+
+using TRunner = solvers::ext::BatchRunner<Solver>;
+using Status = solvers::ext::RunState::Status;
+
+bool Fail(const std::string& message) {
+  std::cout << "BatchRunner failed: " << message << std::endl;
+  return false;
+}
+
+std::string FirstLine(const std::string& filename) {
+  std::ifstream f(filename);
+  std::string line;
+  std::getline(f, line);
+  return line;
+}
+
+bool TestScheduleAndResume(const std::string& report,
+                           const std::string& history) {
+  {
+    std::ofstream f(history);
+    f << "# id status seconds score best" << std::endl;
+    f << "1 done 0.5 - -" << std::endl;
+    f << "3 done 3 - -" << std::endl;
+    f << "5 done 2 - -" << std::endl;
+  }
+  TRunner::Options options;
+  options.report_filename = report;
+  options.history_filename = history;
+  Solver s(2, -1u);
+  // Problems without history (2 and 4) are scheduled as average ones.
+  const auto state = solvers::ext::RunNMT(s, 1, 5, options);
+  if (s.Log() != std::vector<std::string>{"3", "5", "2", "4", "1"})
+    return Fail("schedule");
+  if ((state.Count(Status::DONE) != 5) || (state.TotalScore() != 30))
+    return Fail("first run state");
+  // Report is written atomically and could be loaded back.
+  if (std::filesystem::exists(report + ".tmp")) return Fail("temp report");
+  if (FirstLine(report) != "# pending 0 done 5 failed 0 timeout 0 "
+                           "total_score 30")
+    return Fail("report summary");
+  solvers::ext::RunState loaded;
+  if (!loaded.Load(report) || (loaded.Size() != 5)) return Fail("report");
+  for (unsigned i = 1; i <= 5; ++i) {
+    const auto r = loaded.Find(std::to_string(i));
+    if (!r || (r->status != Status::DONE) || (r->score != 2 * i) ||
+        !r->has_best || (r->best != 2 * i) || (r->seconds < 0))
+      return Fail("report record");
+  }
+  // Second run with the same report solves only new problems.
+  Solver s2(2, -1u);
+  const auto state2 = solvers::ext::RunNMT(s2, 1, 7, options);
+  if (s2.Log() != std::vector<std::string>{"6", "7"}) return Fail("resume");
+  if ((state2.Count(Status::DONE) != 7) || (state2.TotalScore() != 56))
+    return Fail("resume state");
+  return true;
+}
+
+bool TestTimeout(const std::string& report) {
+  TRunner::Options options;
+  options.report_filename = report;
+  // Better solution (factor 1 instead of 2) that takes longer than 0 seconds.
+  Solver s(1, 0, 5, true);
+  const auto state = solvers::ext::RunNMT(s, 1, 2, options);
+  if ((s.Log().size() != 2) || (state.Count(Status::TIMEOUT) != 2))
+    return Fail("timeout state");
+  if (FirstLine(report) != "# pending 0 done 0 failed 0 timeout 2 "
+                           "total_score 0")
+    return Fail("timeout report");
+  // Late solution is still saved as new cached and best solution.
+  std::unique_lock<std::mutex> lock(storage_mutex);
+  for (int64_t i = 1; i <= 2; ++i) {
+    const std::string id = std::to_string(i);
+    if ((storage[{"test", id}] != i) || (storage[{"best", id}] != i))
+      return Fail("timeout solution");
+  }
+  return true;
+}
+}  // namespace
+
+bool TestBatchRunner() {
+  const auto dir = std::filesystem::temp_directory_path();
+  const std::string report = (dir / "tester_batch_runner_report.txt"),
+                    history = (dir / "tester_batch_runner_history.txt"),
+                    report2 = (dir / "tester_batch_runner_timeout.txt");
+  for (auto& f : {report, history, report2}) std::remove(f.c_str());
+  const bool ok =
+      TestScheduleAndResume(report, history) && TestTimeout(report2);
+  for (auto& f : {report, history, report2}) std::remove(f.c_str());
+  return ok;
+}
@@ -0,0 +1,128 @@
+#include "common/factorization/factorization.h"
+#include "common/factorization/primality_test.h"
+#include "common/modular/arithmetic.h"
+#include "common/modular/proxy/discrete_log_full_map.h"
+#include "common/modular/proxy/discrete_log_sqrt_map.h"
+#include "common/modular/utils/primitive_root.h"
+#include "common/numeric/utils/usqrt.h"
+#include "common/timer.h"
+#include "common/vector/hrandom.h"
+
+#include <iostream>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+using TModularA = modular::TArithmetic_P32U;
+
+// Baby-step giant-step with std::unordered_map, one query at a time.
+class DiscreteLogBase {
+ protected:
+  uint64_t p, m, ippm;
+  std::unordered_map<uint64_t, uint64_t> vmap;
+
+ public:
+  DiscreteLogBase(uint64_t prime, uint64_t primitive) : p(prime) {
+    m = USqrt(p) + 1;
+    uint64_t r = 1;
+    for (uint64_t i = 0; i < m; ++i) {
+      vmap[r] = i;
+      r = TModularA::Mult(r, primitive, p);
+    }
+    ippm = TModularA::Inverse(r, p);
+  }
+
+  uint64_t Log(uint64_t x) const {
+    x = TModularA::ApplyU(x, p);
+    for (uint64_t i = 0; i * m <= p; ++i) {
+      auto it = vmap.find(x);
+      if (it != vmap.end()) return i * m + it->second;
+      x = TModularA::Mult(x, ippm, p);
+    }
+    return 0;
+  }
+};
+
+uint64_t NextPrime(uint64_t n) {
+  for (++n; !IsPrime(n);) ++n;
+  return n;
+}
+
+bool TestSmall() {
+  for (unsigned p = 2; p < 1000; p = unsigned(NextPrime(p))) {
+    const auto pf = Factorize(p - 1);
+    const uint64_t g = FindSmallestPrimitiveRoot(p, pf);
+    modular::proxy::DiscreteLogFullMap full(p, pf);
+    std::vector<uint64_t> v;
+    for (unsigned x = 1; x < 2 * p; ++x) {
+      if (x % p) v.push_back(x);
+    }
+    for (uint64_t size : {uint64_t(3), uint64_t(USqrt(p)), uint64_t(p)}) {
+      modular::proxy::DiscreteLogSqrtMap dl(p, g, size);
+      const auto vl = dl.LogMany(v);
+      for (size_t i = 0; i < v.size(); ++i) {
+        if ((dl.Log(v[i]) != full.Log(v[i])) || (vl[i] != full.Log(v[i]))) {
+          std::cout << "DiscreteLog failed for p = " << p << " x = " << v[i]
+                    << std::endl;
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+bool TestLarge(uint64_t p, unsigned queries, uint64_t size) {
+  const uint64_t g = FindSmallestPrimitiveRoot(p, Factorize(p - 1));
+  modular::proxy::DiscreteLogSqrtMap dl(p, g, size);
+  auto v = nvector::HRandom<uint64_t>(queries, p);
+  for (auto& x : v) x = x % (p - 1) + 1;
+  const auto vl = dl.LogMany(v);
+  for (size_t i = 0; i < v.size(); ++i) {
+    if ((TModularA::PowU(g, vl[i], p) != v[i]) || (dl.Log(v[i]) != vl[i])) {
+      std::cout << "DiscreteLog failed for p = " << p << " x = " << v[i]
+                << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool TimeDiscreteLog(uint64_t p, unsigned queries) {
+  const uint64_t g = FindSmallestPrimitiveRoot(p, Factorize(p - 1));
+  auto v = nvector::HRandom<uint64_t>(queries, p);
+  for (auto& x : v) x = x % (p - 1) + 1;
+  uint64_t h0 = 0, h1 = 0, h2 = 0, h3 = 0;
+  Timer t;
+  DiscreteLogBase base(p, g);
+  for (auto x : v) h0 += base.Log(x);
+  std::cout << "\tBase\t" << t.get_milliseconds() << std::endl;
+  t.start();
+  modular::proxy::DiscreteLogSqrtMap dl(p, g);
+  for (auto x : v) h1 += dl.Log(x);
+  std::cout << "\tLog\t" << t.get_milliseconds() << std::endl;
+  t.start();
+  for (auto x : dl.LogMany(v)) h2 += x;
+  std::cout << "\tLogMany\t" << t.get_milliseconds() << std::endl;
+  t.start();
+  using TDL = modular::proxy::DiscreteLogSqrtMap;
+  TDL dlq(p, g, TDL::BabyStepsForQueries(p, queries));
+  for (auto x : dlq.LogMany(v)) h3 += x;
+  std::cout << "\tLogMany Q\t" << t.get_milliseconds() << std::endl;
+  return (h0 == h1) && (h0 == h2) && (h0 == h3);
+}
+}  // namespace
+
+bool TestDiscreteLog(bool time_test) {
+  using TDL = modular::proxy::DiscreteLogSqrtMap;
+  // (p - 1) * queries does not fit in 64 bits.
+  if (TDL::BabyStepsForQueries(4294967291ull, 1ull << 40) != 4294967291ull) {
+    std::cout << "BabyStepsForQueries failed" << std::endl;
+    return false;
+  }
+  if (!TestSmall() || !TestLarge(1000000007, 1000, 40000) ||
+      !TestLarge(4294967291ull, 100, 100000) ||
+      !TestLarge(4294967291ull, 1000, 1000000))
+    return false;
+  return time_test ? TimeDiscreteLog(4294967291ull, 1000) : true;
+}
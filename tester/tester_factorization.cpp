@@ -0,0 +1,189 @@
+#include "common/factorization/factorization.h"
+#include "common/factorization/primality_test.h"
+#include "common/factorization/utils/factorization_base.h"
+#include "common/thread_pool.h"
+#include "common/timer.h"
+#include "common/vector/hrandom.h"
+
+#include <algorithm>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace {
+template <class TValue>
+bool Check(TValue n,
+           const std::vector<factorization::PrimePowerT<TValue>>& f) {
+  TValue m = 1;
+  for (unsigned i = 0; i < f.size(); ++i) {
+    if ((i > 0) && (f[i - 1].prime >= f[i].prime)) return false;
+    for (unsigned j = 0; j < f[i].power; ++j) m *= f[i].prime;
+  }
+  return m == n;
+}
+
+bool Equal(const TFactorization& f1, const TFactorization& f2) {
+  if (f1.size() != f2.size()) return false;
+  for (unsigned i = 0; i < f1.size(); ++i) {
+    if ((f1[i].prime != f2[i].prime) || (f1[i].power != f2[i].power))
+      return false;
+  }
+  return true;
+}
+
+// Random primes below 2^bits.
+std::vector<uint64_t> RandomPrimes(unsigned count, unsigned bits, size_t seed) {
+  auto v = nvector::HRandom<uint64_t>(count, seed);
+  for (auto& p : v) {
+    for (p = (p >> (64 - bits)) | 1; !IsPrime(p);) p -= 2;
+  }
+  return v;
+}
+
+bool TestSmall() {
+  for (uint64_t n = 1; n <= 100000; ++n) {
+    if (!Equal(Factorize(n), FactorizeBase(n))) {
+      std::cout << "Factorize failed for " << n << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool TestRandom(unsigned count) {
+  const auto v = nvector::HRandom<uint64_t>(count, 1);
+  const auto fv = FactorizeMany(v, 4);
+  ThreadPool pool(2);
+  const auto fv2 = FactorizeMany(v, pool);
+  for (unsigned i = 0; i < count; ++i) {
+    if (!Check(v[i], fv[i]) || !Equal(fv[i], Factorize(v[i])) ||
+        !Equal(fv2[i], fv[i])) {
+      std::cout << "Factorize failed for " << v[i] << std::endl;
+      return false;
+    }
+    for (auto& pp : fv[i]) {
+      if (!IsPrime(pp.prime)) {
+        std::cout << "Factorize failed for " << v[i] << std::endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool TestSemiprimes(unsigned count) {
+  const auto vp = RandomPrimes(2 * count, 32, 2);
+  for (unsigned i = 0; i < count; ++i) {
+    const uint64_t p = vp[2 * i], q = vp[2 * i + 1];
+    const auto f = Factorize(p * q);
+    if ((p == q) ? ((f.size() != 1) || (f[0].power != 2))
+                 : ((f.size() != 2) || (f[0].prime != std::min(p, q)) ||
+                    (f[1].prime != std::max(p, q)))) {
+      std::cout << "Factorize failed for " << p << " * " << q << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool Test128(unsigned count) {
+  const auto vp = RandomPrimes(4 * count, 25, 3);
+  const auto vl = RandomPrimes(count, 64, 4);
+  // Mersenne primes
+  const __uint128_t m31 = (__uint128_t(1) << 31) - 1,
+                    m89 = (__uint128_t(1) << 89) - 1,
+                    m127 = (__uint128_t(1) << 127) - 1;
+  for (unsigned i = 0; i < count; ++i) {
+    const __uint128_t p1 = vp[4 * i], p2 = vp[4 * i + 1], p3 = vp[4 * i + 2],
+                      p4 = vp[4 * i + 3], p5 = vl[i];
+    for (__uint128_t n : {p1 * p2 * p3 * p4 * p4, p1 * p2 * p5, p3 * m89,
+                          m31 * m89, m127, p4 << 100}) {
+      const auto f = Factorize128(n);
+      if (!Check(n, f)) {
+        std::cout << "Factorize128 failed for " << i << std::endl;
+        return false;
+      }
+      for (auto& pp : f) {
+        if ((pp.prime != m89) && (pp.prime != m127) &&
+            ((pp.prime >> 64) || !IsPrime(uint64_t(pp.prime)))) {
+          std::cout << "Factorize128 failed for " << i << std::endl;
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+// n - 1 divisible by 2^65: prime 9 * 2^65 + 1 and composite p * q with
+// p * q = 1 mod 2^65.
+bool TestLargePowerOfTwo() {
+  const __uint128_t m65 = __uint128_t(1) << 65, p1 = 9 * m65 + 1,
+                    p = 1073741827,
+                    q = __uint128_t(448230260513142ull) * 1000000 + 647467;
+  const auto f1 = Factorize128(p1);
+  const auto f2 = Factorize128(p * q);
+  if ((f1.size() != 1) || (f1[0].prime != p1) || (f1[0].power != 1) ||
+      (f2.size() != 2) || (f2[0].prime != p) || (f2[1].prime != q)) {
+    std::cout << "Factorize128 failed for k * 2^65 + 1" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+// Semiprime above 2^90 with two 46-bit factors and prime above the
+// deterministic Miller-Rabin bound.
+bool TestLargeSemiprime() {
+  const __uint128_t p = 47146538289749ull, q = 54340107471869ull,
+                    m107 = (__uint128_t(1) << 107) - 1;
+  const auto f1 = Factorize128(p * q);
+  const auto f2 = Factorize128(m107);
+  if ((f1.size() != 2) || (f1[0].prime != p) || (f1[1].prime != q) ||
+      (f2.size() != 1) || (f2[0].prime != m107)) {
+    std::cout << "Factorize128 failed for large semiprime" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool TimeFactorization() {
+  const unsigned count = 1000000;
+  auto v = nvector::HRandom<uint64_t>(count, 5);
+  for (auto& x : v) x >>= 4;
+  uint64_t h = 0;
+  Timer t;
+  for (auto x : v) {
+    for (auto& pp : Factorize(x)) h += pp.prime * pp.power;
+  }
+  std::cout << "Factorize 60 bits\t" << count << "\t" << h << "\t"
+            << t.get_milliseconds() << std::endl;
+  const unsigned threads = std::max(std::thread::hardware_concurrency(), 1u);
+  t.start();
+  const auto fv = FactorizeMany(v, threads);
+  h = 0;
+  for (auto& f : fv) {
+    for (auto& pp : f) h += pp.prime * pp.power;
+  }
+  std::cout << "FactorizeMany\t" << threads << "\t" << h << "\t"
+            << t.get_milliseconds() << std::endl;
+
+  const unsigned count128 = 1000;
+  const auto vp = RandomPrimes(2 * count128, 30, 6);
+  t.start();
+  for (unsigned i = 0; i < count128; ++i) {
+    const __uint128_t n = __uint128_t(vp[2 * i]) * vp[2 * i + 1] * vp[0];
+    h += uint64_t(Factorize128(n)[0].prime);
+  }
+  std::cout << "Factorize128 90 bits\t" << count128 << "\t" << h << "\t"
+            << t.get_milliseconds() << std::endl;
+  return true;
+}
+}  // namespace
+
+bool TestFactorization(bool time_test) {
+  if (!TestSmall() || !TestRandom(10000) || !TestSemiprimes(1000) ||
+      !Test128(200) || !TestLargePowerOfTwo() ||
+      !TestLargeSemiprime())
+    return false;
+  return time_test ? TimeFactorization() : true;
+}
@@ -22,6 +22,7 @@
 #include "common/data_structures/fixed_universe_successor/x_fast_trie.h"
 #include "common/data_structures/fixed_universe_successor/y_fast_trie_proxy.h"
 #include "common/hash/combine.h"
+#include "common/hash/flat_map.h"
 #include "common/timer.h"
 #include "common/vector/hrandom.h"
 #include "common/vector/shuffle.h"
@@ -87,6 +88,8 @@ bool TesterFixedUniverseSuccessor::TestAll(bool small_test) const {
   hs.insert(TestBase<MultiSearchTree<FLSetB8>>("MST  B8"));
   hs.insert(TestBase<MultiSearchTreeHashTable<FLSetB6>>("MSTH B6"));
   hs.insert(TestBase<MultiSearchTreeHashTable<FLSetB8>>("MSTH B8"));
+  hs.insert(
+      TestBase<MultiSearchTreeHashTable<FLSetB6, nhash::FlatMap>>("MSTHFB6"));
   if (usize <= (1ull << 27)) {
     hs.insert(TestBase<VanEmdeBoasTreeFull<FLSetB6>>("VEBTF 6"));
     hs.insert(TestBase<VanEmdeBoasTreeFull<FLSetB8>>("VEBTF 8"));
@@ -97,8 +100,11 @@ bool TesterFixedUniverseSuccessor::TestAll(bool small_test) const {
     hs.insert(TestBase<VanEmdeBoasTreeFullStaticSize<27>>("VEBTFS "));
   }
   hs.insert(TestBase<VanEmdeBoasTreeCompact>("VEBTC  "));
+  hs.insert(TestBase<VanEmdeBoasTreeCompactHashMap<nhash::FlatMap>>("VEBTC F"));
   hs.insert(TestBase<VanEmdeBoasTreeCompact2<FLSetB6>>("VEBT2 6"));
   hs.insert(TestBase<VanEmdeBoasTreeCompact2<FLSetB8>>("VEBT2 8"));
+  hs.insert(
+      TestBase<VanEmdeBoasTreeCompact2<FLSetB6, nhash::FlatMap>>("VEBT2F6"));
   if (usize <= (1ull << 20)) {
     hs.insert(TestBase<VanEmdeBoasTreeCompactStaticSize<20>>("VEBTCS "));
   } else if (usize <= (1ull << 27)) {
@@ -108,6 +114,7 @@ bool TesterFixedUniverseSuccessor::TestAll(bool small_test) const {
   }
   if (small_test) {
     hs.insert(TestBase<XFastTrie>("XFTrie "));
+    hs.insert(TestBase<XFastTrieHashMap<nhash::FlatMap>>("XFTrieF"));
   }
   hs.insert(TestBase<XFastTree>("XFTree "));
   return hs.size() == 1;
@@ -0,0 +1,182 @@
+#include "common/data_structures/binary_indexed_tree/bit_sparse.h"
+#include "common/data_structures/coordinate_compression.h"
+#include "common/hash/flat_map.h"
+#include "common/hash/flat_set.h"
+#include "common/timer.h"
+#include "common/vector/hrandom.h"
+
+#include <functional>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace {
+// Random inserts, updates, lookups and erases compared with std containers.
+bool TestRandom(unsigned count, uint64_t keys_range, unsigned seed) {
+  const auto v = nvector::HRandom<uint64_t>(3 * count, seed);
+  std::unordered_map<uint64_t, uint64_t> um;
+  std::unordered_set<uint64_t> us;
+  nhash::FlatMap<uint64_t, uint64_t> fm;
+  nhash::FlatSet<uint64_t> fs;
+  for (unsigned i = 0; i < count; ++i) {
+    const uint64_t key = v[3 * i] % keys_range, value = v[3 * i + 1];
+    switch (v[3 * i + 2] % 4) {
+      case 0:
+        um[key] += value;
+        fm[key] += value;
+        break;
+      case 1:
+        us.insert(key);
+        fs.insert(key);
+        break;
+      case 2:
+        if (um.erase(key) != fm.erase(key)) return false;
+        if (us.erase(key) != fs.erase(key)) return false;
+        break;
+      case 3: {
+        auto it1 = um.find(key);
+        auto it2 = fm.find(key);
+        if ((it1 == um.end()) != (it2 == fm.end())) return false;
+        if ((it1 != um.end()) && (it1->second != it2->second)) return false;
+        if (us.count(key) != fs.count(key)) return false;
+        if (it2 != fm.end()) {
+          fm.erase(it2);
+          um.erase(it1);
+        }
+        break;
+      }
+    }
+    if ((um.size() != fm.size()) || (us.size() != fs.size())) return false;
+  }
+  uint64_t s1 = 0, s2 = 0;
+  for (auto& p : um) s1 += p.first * 3 + p.second;
+  for (auto& p : fm) s2 += p.first * 3 + p.second;
+  for (auto k : us) s1 += k;
+  for (auto k : fs) s2 += k;
+  if (s1 != s2) return false;
+  const size_t capacity = fm.capacity();
+  fm.clear();
+  fs.clear();
+  if (!fm.empty() || !fs.empty() || (fm.capacity() != capacity)) return false;
+  for (auto& p : fm) s2 += p.second;
+  return (s1 == s2) && (fm.find(v[0] % keys_range) == fm.end());
+}
+
+bool TestInterface() {
+  nhash::FlatMap<uint64_t, std::string> m;
+  m.reserve(1000);
+  const size_t capacity = m.capacity();
+  for (unsigned i = 0; i < 1000; ++i) m.emplace(i, std::to_string(i));
+  if ((m.capacity() != capacity) || (m.size() != 1000)) return false;
+  // Heterogeneous lookup with key of different type.
+  if (!m.contains(5u) || (m.at(uint8_t(7)) != "7")) return false;
+  if (m.insert({5, "x"}).second || (m[5] != "5")) return false;
+  // Keys are const, missing key in at throws.
+  static_assert(std::is_const_v<
+                std::remove_reference_t<decltype(m.begin()->first)>>);
+  bool thrown = false;
+  try {
+    m.at(1000u);
+  } catch (const std::out_of_range&) {
+    thrown = true;
+  }
+  if (!thrown) return false;
+  // Copies are independent, erased entries are destroyed.
+  auto m2 = m;
+  m2.erase(5u);
+  m2.erase(6u);
+  m2.emplace(6u, "y");
+  if (!m.contains(5u) || (m.at(6u) != "6") || m2.contains(5u) ||
+      (m2.at(6u) != "y"))
+    return false;
+  m = std::move(m2);
+  if ((m.size() != 999) || m.contains(5u)) return false;
+  nhash::FlatSet<uint64_t> s;
+  for (unsigned i = 0; i < 100; ++i) s.insert(i * i);
+  return s.contains(81u) && !s.contains(82u) && (s.size() == 100);
+}
+
+template <class TMap>
+uint64_t TimeMapRandom(const std::vector<uint64_t>& v) {
+  TMap m;
+  uint64_t s = 0;
+  for (auto x : v) m[x >> 40] += x;
+  for (auto x : v) {
+    auto it = m.find(x >> 39);
+    if (it != m.end()) s += it->second;
+  }
+  for (auto x : v) m.erase(x >> 40);
+  return s + m.size();
+}
+
+template <template <class, class> class TTHashMap>
+uint64_t TimeBITSparse(const std::vector<uint64_t>& v) {
+  const uint64_t size = (1ull << 40);
+  ds::BITSparse<int64_t, TTHashMap> bit(size);
+  uint64_t s = 0;
+  for (size_t i = 0; i < v.size(); ++i) {
+    if (i & 1)
+      s += bit.Sum(v[i] % size);
+    else
+      bit.Add(v[i] % size, int64_t(v[i] & 0xFF));
+  }
+  return s;
+}
+
+template <template <class, class> class TTHashMap>
+uint64_t TimeCoordinateCompression(const std::vector<uint64_t>& v) {
+  ds::CoordinateCompression<uint64_t, TTHashMap> cc(v);
+  uint64_t s = 0;
+  for (unsigned k = 0; k < 4; ++k) {
+    for (auto x : v) s += cc.GetNew(x);
+  }
+  return s;
+}
+
+template <class F>
+bool TimeCompare(const std::string& name, F f_std, F f_flat) {
+  Timer t;
+  const uint64_t r1 = f_std();
+  std::cout << "\t" << name << "\tstd\t" << t.get_milliseconds() << std::endl;
+  t.start();
+  const uint64_t r2 = f_flat();
+  std::cout << "\t" << name << "\tflat\t" << t.get_milliseconds() << std::endl;
+  return r1 == r2;
+}
+
+bool TimeFlatHashMap() {
+  const auto v = nvector::HRandom<uint64_t>(1000000, 1);
+  using TF = std::function<uint64_t()>;
+  return TimeCompare<TF>(
+             "Random",
+             [&]() {
+               return TimeMapRandom<std::unordered_map<uint64_t, uint64_t>>(v);
+             },
+             [&]() {
+               return TimeMapRandom<nhash::FlatMap<uint64_t, uint64_t>>(v);
+             }) &&
+         TimeCompare<TF>(
+             "BITSparse",
+             [&]() { return TimeBITSparse<std::unordered_map>(v); },
+             [&]() { return TimeBITSparse<nhash::FlatMap>(v); }) &&
+         TimeCompare<TF>(
+             "CoordinateCompression",
+             [&]() {
+               return TimeCoordinateCompression<
+                   ds::hidden::UnorderedMapDHash>(v);
+             },
+             [&]() { return TimeCoordinateCompression<nhash::FlatMap>(v); });
+}
+}  // namespace
+
+bool TestFlatHashMap(bool time_test) {
+  if (!TestRandom(1000000, 100, 1) || !TestRandom(1000000, 100000, 2) ||
+      !TestRandom(1000000, uint64_t(-1), 3) || !TestInterface())
+    return false;
+  return time_test ? TimeFlatHashMap() : true;
+}
@@ -1,7 +1,17 @@
+#include "common/generating_function/functions/constant.h"
+#include "common/generating_function/functions/forward.h"
 #include "common/generating_function/functions/geometric.h"
 #include "common/generating_function/functions/partition.h"
+#include "common/generating_function/functions/vector.h"
+#include "common/generating_function/operators/addition.h"
+#include "common/generating_function/operators/multiplication.h"
 #include "common/generating_function/operators/partition.h"
+#include "common/generating_function/operators/powu.h"
+#include "common/generating_function/operators/shift.h"
 #include "common/modular.h"
+#include "common/numeric/convolution_base.h"
+
+#include <vector>
 
 bool TestGenetatingFunctionOperatorsPartition() {
   uint64_t n = 100, expected = 190569292;
@@ -21,9 +31,52 @@ bool TestGenetatingFunctionFunctionsPartition() {
          (f_modular->Get(n) == ModularDefault(expected));
 }
 
+template <class TValue>
+bool TestGenetatingFunctionCatalan(unsigned n) {
+  auto c = gf::functions::MakePForward<TValue>();
+  gf::PGeneratingFunction<TValue> pc = c;
+  c->Set(gf::functions::MakePConstant<TValue>(TValue(1)) +
+         gf::operators::MakeShift<TValue>(pc * pc, 1));
+  // C_{k+1} = C_k * 2 * (2k + 1) / (k + 2)
+  TValue ck(1);
+  bool ok = (c->Get(n) != TValue(0));
+  for (unsigned k = 0; ok && (k <= n); ++k) {
+    ok = (c->Get(k) == ck);
+    ck = ck * TValue(2 * (2 * k + 1)) / TValue(k + 2);
+  }
+  c->Set(nullptr);
+  return ok;
+}
+
+bool TestGenetatingFunctionMultiplication() {
+  const unsigned n = 1000;
+  std::vector<ModularDefault> va, vb;
+  for (unsigned i = 0; i < n; ++i) {
+    va.push_back(ModularDefault(i * i + 1));
+    vb.push_back(ModularDefault(3 * i + 7));
+  }
+  const auto vc = numeric::ConvolutionBase(va, vb);
+  auto f = gf::functions::MakePVector(va) * gf::functions::MakePVector(vb);
+  for (unsigned i = 0; i < vc.size(); ++i) {
+    if (f->Get(i) != vc[i]) return false;
+  }
+  // (1 / (1 - x))^5 = sum C(k + 4, 4) x^k
+  auto g = gf::operators::MakePowU(
+      gf::functions::MakePGeometricOne<ModularDefault>(), 5);
+  for (uint64_t k = 0; k <= 2 * n; k += 7) {
+    if (g->Get(k) * ModularDefault(24) !=
+        ModularDefault((k + 1) * (k + 2) * (k + 3) * (k + 4)))
+      return false;
+  }
+  return true;
+}
+
 bool TestGeneratingFunction() {
   bool all_ok = true;
   all_ok = all_ok && TestGenetatingFunctionOperatorsPartition();
   all_ok = all_ok && TestGenetatingFunctionFunctionsPartition();
+  all_ok = all_ok && TestGenetatingFunctionCatalan<uint64_t>(30);
+  all_ok = all_ok && TestGenetatingFunctionCatalan<ModularDefault>(3000);
+  all_ok = all_ok && TestGenetatingFunctionMultiplication();
   return all_ok;
 }
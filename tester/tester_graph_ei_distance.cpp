@@ -2,10 +2,65 @@
 
 #include "tester/graph_type.h"
 
+#include "common/graph/graph_ei.h"
+#include "common/graph/graph_ei/distance/bellman_ford.h"
+#include "common/graph/graph_ei/distance/floyd_warshall.h"
+#include "common/graph/graph_ei/distance/johnson.h"
+#include "common/graph/graph_ei/distance_all_pairs.h"
+#include "common/graph/graph_ei/edge_cost_proxy.h"
 #include "common/graph/graph_ei/replace_edge_info.h"
 #include "common/vector/hrandom.h"
 
 #include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+// Random directed graph with negative edges but without negative cycles
+// (costs are shifted by vertex potentials). All-pairs distances are compared
+// with Bellman-Ford from each source.
+template <class TEdgeCost>
+bool TestAllPairsNegative(unsigned n, unsigned edges_per_node, unsigned seed) {
+  const TEdgeCost max_cost = TEdgeCost(1) << (8 * sizeof(TEdgeCost) - 3);
+  const unsigned m = n * edges_per_node;
+  const auto vr = nvector::HRandom<uint64_t>(3 * m + n, seed);
+  graph::GraphEI<TEdgeCost, true> g(n);
+  for (unsigned i = 0; i < m; ++i) {
+    const unsigned u = unsigned(vr[3 * i] % n), v = unsigned(vr[3 * i + 1] % n);
+    const TEdgeCost cost = TEdgeCost(vr[3 * i + 2] % 1000),
+                    potential_u = TEdgeCost(vr[3 * m + u] % 10000),
+                    potential_v = TEdgeCost(vr[3 * m + v] % 10000);
+    g.AddEdge(u, v, cost + potential_u - potential_v);
+  }
+  graph::EdgeCostProxy<TEdgeCost> f;
+  std::vector<std::vector<TEdgeCost>> expected(n);
+  for (unsigned u = 0; u < n; ++u)
+    expected[u] = graph::distance::BellmanFord(g, f, u, max_cost);
+  auto check = [&](const std::vector<std::vector<TEdgeCost>>& vd,
+                   const std::string& name) {
+    if (vd == expected) return true;
+    std::cout << "All pairs distance failed for " << name << " [n = " << n
+              << ", edges_per_node = " << edges_per_node
+              << ", size = " << sizeof(TEdgeCost) << "]" << std::endl;
+    return false;
+  };
+  return check(graph::distance::FloydWarshall(g, f, max_cost), "FW") &&
+         check(graph::distance::FloydWarshall(g, f, max_cost, 4), "FW4T") &&
+         check(graph::distance::Johnson(g, f, max_cost, 4), "Jo4T") &&
+         check(graph::DistanceAllPairs(g, f, max_cost), "APD") &&
+         check(graph::DistanceAllPairs(g, f, max_cost, 4), "APD4T");
+}
+
+bool TestAllPairsNegative() {
+  // Sparse graphs use Johnson in DistanceAllPairs, dense use Floyd-Warshall.
+  for (unsigned epn : {4u, 50u}) {
+    if (!TestAllPairsNegative<int32_t>(203, epn, 1) ||
+        !TestAllPairsNegative<int64_t>(203, epn, 2))
+      return false;
+  }
+  return true;
+}
+}  // namespace
 
 TesterGraphEIDistance::TesterGraphEIDistance(EGraphType _gtype,
                                              unsigned graph_size,
@@ -33,6 +88,6 @@ bool TestGraphEIDistance(bool time_test) {
     return t1.TestAll() && t2.TestAll() && t3.TestAll();
   } else {
     TesterGraphEIDistance t(EGraphType::SMALL, 10, 4);
-    return t.TestAll();
+    return t.TestAll() && TestAllPairsNegative();
   }
 }
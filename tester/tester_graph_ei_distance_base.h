@@ -28,6 +28,7 @@
 #include "common/graph/graph_ei/distance/spfa/zero_degrees_only.h"
 #include "common/graph/graph_ei/distance/spfa/zero_degrees_only_base.h"
 #include "common/graph/graph_ei/distance/spfa/zero_degrees_only_time.h"
+#include "common/graph/graph_ei/distance_all_pairs.h"
 #include "common/graph/graph_ei/edge_cost_proxy.h"
 #include "common/hash/combine.h"
 #include "common/timer.h"
@@ -88,7 +89,7 @@ class TesterGraphEIDistanceBase {
   }
 
   template <class TFunction>
-  void TestFA(TFunction& fa, const std::string& name) {
+  void TestFA(const TFunction& fa, const std::string& name) {
     Timer t;
     size_t h = 0;
     auto vv = fa(g, edge_proxy, max_cost);
@@ -116,12 +117,28 @@ class TesterGraphEIDistanceBase {
 
  protected:
   void TestAllPairs() {
-    if (gtype != EGraphType::SPARSE)
-      TestFA(
-          graph::distance::FloydWarshall<TGraph, TEdgeCostFunction, TEdgeCost>,
-          "A  FlWa");
-    TestFA(graph::distance::Johnson<TGraph, TEdgeCostFunction, TEdgeCost>,
-           "A  John");
+    auto fw = [](const TGraph& g, const TEdgeCostFunction& f, TEdgeCost mc) {
+      return graph::distance::FloydWarshall(g, f, mc);
+    };
+    auto fw4 = [](const TGraph& g, const TEdgeCostFunction& f, TEdgeCost mc) {
+      return graph::distance::FloydWarshall(g, f, mc, 4);
+    };
+    auto jo = [](const TGraph& g, const TEdgeCostFunction& f, TEdgeCost mc) {
+      return graph::distance::Johnson(g, f, mc);
+    };
+    auto jo4 = [](const TGraph& g, const TEdgeCostFunction& f, TEdgeCost mc) {
+      return graph::distance::Johnson(g, f, mc, 4);
+    };
+    auto apd = [](const TGraph& g, const TEdgeCostFunction& f, TEdgeCost mc) {
+      return graph::DistanceAllPairs(g, f, mc);
+    };
+    if (gtype != EGraphType::SPARSE) {
+      TestFA(fw, "A  FlWa");
+      TestFA(fw4, "A  FW4T");
+    }
+    TestFA(jo, "A  John");
+    TestFA(jo4, "A  Jo4T");
+    TestFA(apd, "A  APD ");
   }
 
   void TestSPFA() {
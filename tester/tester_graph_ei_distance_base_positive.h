@@ -12,6 +12,7 @@
 #include "common/heap/ukvm/binomial.h"
 #include "common/heap/ukvm/complete_binary_tree.h"
 #include "common/heap/ukvm/dheap.h"
+#include "common/heap/ukvm/dheap_inline.h"
 #include "common/heap/ukvm/fibonacci.h"
 #include "common/heap/ukvm/pairing.h"
 #include "common/heap/ukvm/unordered_set.h"
@@ -170,6 +171,8 @@ class TesterGraphEIDistanceBasePositive
     TestDMH<heap::ukvm::DHeap<4, TEdgeCost>>(" DH2 ");
     TestDMH<heap::ukvm::DHeap<8, TEdgeCost>>(" DH3 ");
     TestDMH<heap::ukvm::DHeap<16, TEdgeCost>>(" DH4 ");
+    TestDMH<heap::ukvm::DHeapInline<4, TEdgeCost>>(" DI2 ");
+    TestDMH<heap::ukvm::DHeapInline<8, TEdgeCost>>(" DI3 ");
     TestDMH<heap::ukvm::CompleteBinaryTree<TEdgeCost>>(" CBT ");
     TestDMH<heap::ukvm::Binomial<TEdgeCost>>(" BNML");
     TestDMH<heap::ukvm::Fibonacci<TEdgeCost>>(" FBNC");
@@ -0,0 +1,130 @@
+#include "common/geometry/d2/utils/neighbors_graph.h"
+#include "common/graph/graph.h"
+#include "common/graph/graph/connected_components.h"
+#include "common/graph/graph/distance.h"
+#include "common/graph/graph_ei.h"
+#include "common/graph/graph_ei/distance/dial.h"
+#include "common/graph/graph_ei/distance/dijkstra.h"
+#include "common/graph/graph_ei/edge_cost_proxy.h"
+#include "common/graph/grid_graph.h"
+#include "common/timer.h"
+#include "common/vector/hrandom.h"
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+namespace {
+template <class TGrid, bool directed_edges>
+bool CompareEdges(const TGrid& grid, const graph::Graph<directed_edges>& g) {
+  if (grid.Size() != g.Size()) return false;
+  for (unsigned u = 0; u < g.Size(); ++u) {
+    const auto v1 = grid.Edges(u);
+    const auto& v2 = g.Edges(u);
+    if (!std::equal(v1.begin(), v1.end(), v2.begin(), v2.end())) return false;
+  }
+  return true;
+}
+
+bool TestEdges(unsigned dx, unsigned dy) {
+  return CompareEdges(graph::GridGraph<2>(dx, dy), NeighborsDGraphD2(dx, dy)) &&
+         CompareEdges(graph::GridGraph<3>(dx, dy), NeighborsDGraphD3(dx, dy)) &&
+         CompareEdges(graph::GridGraph<4>(dx, dy), NeighborsDGraphD4(dx, dy)) &&
+         CompareEdges(graph::GridGraph<8>(dx, dy), NeighborsDGraphD8(dx, dy));
+}
+
+// Same graph as grid with explicit edges.
+template <class TGrid>
+DirectedGraphEI<unsigned> Materialize(const TGrid& grid) {
+  DirectedGraphEI<unsigned> g(grid.Size());
+  for (unsigned u = 0; u < grid.Size(); ++u) {
+    for (auto e : grid.EdgesEI(u)) g.AddEdge(u, e.to, e.info);
+  }
+  return g;
+}
+
+template <unsigned directions>
+bool TestBlocked(unsigned dx, unsigned dy, unsigned seed) {
+  graph::GridGraph<directions> grid(dx, dy);
+  const unsigned n = grid.Size();
+  const auto vr = nvector::HRandom<uint64_t>(n, seed);
+  std::vector<uint8_t> mask(n);
+  std::vector<unsigned> weights(n);
+  for (unsigned i = 0; i < n; ++i) {
+    mask[i] = ((vr[i] % 4) == 0);
+    weights[i] = unsigned((vr[i] >> 8) % 9) + 1;
+  }
+  grid.SetBlocked(mask);
+  grid.SetWeights(weights);
+  // Reference graph built from geometry neighbors.
+  DirectedGraphEI<unsigned> g(n);
+  UndirectedGraph ug(n);
+  const I2ARectangle b({0, 0}, {int64_t(dx) - 1, int64_t(dy) - 1});
+  const auto vd = (directions == 4) ? I2NeighborsD4() : I2NeighborsD8();
+  I2Point p(0, 0);
+  for (p.y = 0; p.y < dy; ++p.y) {
+    for (p.x = 0; p.x < dx; ++p.x) {
+      const unsigned u = unsigned(b.InsideIndexYX(p));
+      if (mask[u]) continue;
+      for (auto d : vd) {
+        const auto p1 = p + d;
+        if (!b.Inside(p1)) continue;
+        const unsigned v = unsigned(b.InsideIndexYX(p1));
+        if (mask[v]) continue;
+        g.AddEdge(u, v, weights[v]);
+        if (u < v) ug.AddEdge(u, v);
+      }
+    }
+  }
+  if (ConnectedComponents(grid) != ConnectedComponents(ug)) return false;
+  const auto g2 = Materialize(grid);
+  graph::EdgeCostProxy<unsigned> f;
+  for (unsigned s = 0; s < n; s += 1 + n / 8) {
+    if (DistanceFromSource(grid, s) != DistanceFromSource(g, s)) return false;
+    const auto d = graph::distance::Dijkstra(g, f, s, -1u);
+    if ((graph::distance::Dijkstra(grid, f, s, -1u) != d) ||
+        (graph::distance::Dijkstra(g2, f, s, -1u) != d) ||
+        (graph::distance::Dial(grid, f, s, -1u, 9u) != d))
+      return false;
+  }
+  return true;
+}
+
+bool TimeGraphGrid(unsigned size) {
+  Timer t;
+  graph::GridGraph<4> grid(size, size);
+  const auto vr = nvector::HRandom<uint64_t>(grid.Size(), 1);
+  std::vector<unsigned> weights(grid.Size());
+  for (unsigned i = 0; i < grid.Size(); ++i) weights[i] = vr[i] % 9 + 1;
+  grid.SetWeights(weights);
+  graph::EdgeCostProxy<unsigned> f;
+  const auto d1 = graph::distance::Dijkstra(grid, f, 0, -1u);
+  std::cout << "\tGrid\tDijkstra\t" << t.get_milliseconds() << std::endl;
+  t.start();
+  const auto g = Materialize(grid);
+  std::cout << "\tMaterialize\t" << t.get_milliseconds() << std::endl;
+  t.start();
+  const auto d2 = graph::distance::Dijkstra(g, f, 0, -1u);
+  std::cout << "\tGraphEI\tDijkstra\t" << t.get_milliseconds() << std::endl;
+  t.start();
+  const auto d3 = graph::distance::Dial(grid, f, 0, -1u, 9u);
+  std::cout << "\tGrid\tDial\t" << t.get_milliseconds() << std::endl;
+  return (d1 == d2) && (d1 == d3);
+}
+}  // namespace
+
+bool TestGraphGrid(bool time_test) {
+  for (unsigned dx = 1; dx < 8; ++dx) {
+    for (unsigned dy = 1; dy < 8; ++dy) {
+      if (!TestEdges(dx, dy)) {
+        std::cout << "GridGraph edges failed for " << dx << " x " << dy
+                  << std::endl;
+        return false;
+      }
+    }
+  }
+  if (!TestBlocked<4>(37, 23, 1) || !TestBlocked<8>(37, 23, 2) ||
+      !TestBlocked<4>(1, 100, 3) || !TestBlocked<8>(200, 150, 4))
+    return false;
+  return time_test ? TimeGraphGrid(2000) : true;
+}
@@ -11,8 +11,10 @@
 #include "common/heap/ukvm/binomial.h"
 #include "common/heap/ukvm/complete_binary_tree.h"
 #include "common/heap/ukvm/dheap.h"
+#include "common/heap/ukvm/dheap_inline.h"
 #include "common/heap/ukvm/fibonacci.h"
 #include "common/heap/ukvm/pairing.h"
+#include "common/memory/arena_nodes_manager.h"
 #include "common/memory/nodes_manager.h"
 #include "common/timer.h"
 #include "common/vector/hrandom.h"
@@ -124,6 +126,9 @@ bool TesterHeapBase::TestAll() const {
   hs.insert(TestBasePairing<1, 0>());
   hs.insert(TestBasePairing<0, 1>());
   hs.insert(TestBasePairing<1, 1>());
+  hs.insert(TestBase<heap::base::Pairing<
+                size_t, std::less<size_t>, memory::ArenaNodesManager, 1, 1>>(
+      "B PRAR"));
   hs.insert(TestKVM<heap::ext::DHeapUKeyPosMap<2, size_t>>("E   D2"));
   hs.insert(TestKVM<heap::ext::DHeapUKeyPosMap<4, size_t>>("E   D4"));
   hs.insert(TestKVM<heap::ext::DHeapUKeyPosMap<8, size_t>>("E   D8"));
@@ -135,6 +140,8 @@ bool TesterHeapBase::TestAll() const {
   hs.insert(TestKVM<heap::ukvm::DHeap<2, size_t>>("M   D2"));
   hs.insert(TestKVM<heap::ukvm::DHeap<4, size_t>>("M   D4"));
   hs.insert(TestKVM<heap::ukvm::DHeap<8, size_t>>("M   D8"));
+  hs.insert(TestKVM<heap::ukvm::DHeapInline<4, size_t>>("M  DI4"));
+  hs.insert(TestKVM<heap::ukvm::DHeapInline<8, size_t>>("M  DI8"));
   hs.insert(TestKVM<heap::ukvm::CompleteBinaryTree<size_t>>("M  CBT"));
   hs.insert(TestKVM<heap::ukvm::Binomial<size_t>>("M BNML"));
   hs.insert(TestKVM<heap::ukvm::Fibonacci<size_t>>("M FBNC"));
@@ -11,6 +11,7 @@
 #include "common/heap/ukvm/binomial.h"
 #include "common/heap/ukvm/complete_binary_tree.h"
 #include "common/heap/ukvm/dheap.h"
+#include "common/heap/ukvm/dheap_inline.h"
 #include "common/heap/ukvm/fibonacci.h"
 #include "common/heap/ukvm/pairing.h"
 #include "common/heap/ukvm/proxy_set.h"
@@ -219,6 +220,8 @@ bool TesterHeapExt::TestAll() {
   hs.insert(TestKVM<heap::ukvm::DHeap<2, TValue>>("M   D2"));
   hs.insert(TestKVM<heap::ukvm::DHeap<4, TValue>>("M   D4"));
   hs.insert(TestKVM<heap::ukvm::DHeap<8, TValue>>("M   D8"));
+  hs.insert(TestKVM<heap::ukvm::DHeapInline<4, TValue>>("M  DI4"));
+  hs.insert(TestKVM<heap::ukvm::DHeapInline<8, TValue>>("M  DI8"));
   hs.insert(TestKVM<heap::ukvm::CompleteBinaryTree<TValue>>("M  CBT"));
   hs.insert(TestKVM<heap::ukvm::Binomial<TValue>>("M BNML"));
   hs.insert(TestKVM<heap::ukvm::Fibonacci<TValue>>("M FBNC"));
@@ -3,6 +3,10 @@
 #include "common/modular/static/modular.h"
 #include "common/modular/static/sum_of_powers.h"
 #include "common/polynomial/base_newton.h"
+#include "common/polynomial/modular/subproduct_tree.h"
+#include "common/polynomial/utils/interpolate_vy.h"
+#include "common/timer.h"
+#include "common/vector/hrandom.h"
 
 #include <iostream>
 #include <vector>
@@ -49,19 +53,105 @@ bool TesterInterpolation::TestBaseNewtonPolynomial(
   return true;
 }
 
+bool TesterInterpolation::TestLagrange(unsigned power,
+                                       const std::vector<ModularDefault>& vp) {
+  std::vector<ModularDefault> vtemp(vp.begin(), vp.begin() + power + 2);
+  for (unsigned i = n - k; i < n; ++i) {
+    if (polynomial::Interpolate(vtemp, ModularDefault(i)) != vp[i]) {
+      std::cout << "TestLagrange failed:\n"
+                << "\tpower = " << power << "\tindex = " << i << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
 bool TesterInterpolation::TestAll(unsigned power,
                                   const std::vector<ModularDefault>& vp) {
   bool b = true;
   b = TestSumOfPowers(power, vp) && b;
   b = TestBaseNewtonPolynomial(power, vp) && b;
+  b = TestLagrange(power, vp) && b;
   return b;
 }
 
+namespace {
+// Distinct points that are not consecutive.
+std::vector<ModularDefault> Points(unsigned n) {
+  std::vector<ModularDefault> v(n);
+  for (unsigned i = 0; i < n; ++i)
+    v[i] = ModularDefault(i) * ModularDefault(1000003) + ModularDefault(12345);
+  return v;
+}
+}  // namespace
+
+bool TesterInterpolation::TestSubproductTree(unsigned n, bool consecutive) {
+  using TTree = polynomial::SubproductTree<ModularDefault::GetMod()>;
+  using TPolynomial = TTree::TPolynomial;
+  const TPolynomial f(nvector::HRandom<ModularDefault>(n, n));
+  const TTree tree =
+      consecutive ? TTree(ModularDefault(n), n) : TTree(Points(n));
+  const auto vy = tree.Evaluate(f);
+  for (unsigned i = 0; i < n; ++i) {
+    if (vy[i] != f(tree.Points()[i])) {
+      std::cout << "SubproductTree::Evaluate failed for n = " << n
+                << std::endl;
+      return false;
+    }
+  }
+  if (tree.Interpolate(vy) != f) {
+    std::cout << "SubproductTree::Interpolate failed for n = " << n
+              << std::endl;
+    return false;
+  }
+  return true;
+}
+
+void TesterInterpolation::TimeSubproductTree(unsigned n) {
+  using TTree = polynomial::SubproductTree<ModularDefault::GetMod()>;
+  using TPolynomial = TTree::TPolynomial;
+  const TPolynomial f(nvector::HRandom<ModularDefault>(n, n));
+  Timer t;
+  const TTree tree(Points(n));
+  std::cout << "\tBuild [" << n << "]: " << t.get_milliseconds() << std::endl;
+  t.start();
+  const auto vy = tree.Evaluate(f);
+  std::cout << "\tEvaluate [" << n << "]: " << t.get_milliseconds()
+            << std::endl;
+  t.start();
+  const bool ok = (tree.Interpolate(vy) == f);
+  std::cout << "\tInterpolate [" << n << "]: " << t.get_milliseconds() << "\t"
+            << ok << std::endl;
+  const TTree tree_consecutive(ModularDefault(0), n);
+  const auto vyc = tree_consecutive.Evaluate(f);
+  t.start();
+  const bool ok_consecutive = (tree_consecutive.Interpolate(vyc) == f);
+  std::cout << "\tInterpolate consecutive [" << n
+            << "]: " << t.get_milliseconds() << "\t" << ok_consecutive
+            << std::endl;
+  t.start();
+  polynomial::BaseNewton<ModularDefault> p;
+  p.Interpolate(std::vector<ModularDefault>(
+      vyc.begin(), vyc.begin() + std::min(n, 10000u)));
+  std::cout << "\tBaseNewton::Interpolate [" << std::min(n, 10000u)
+            << "]: " << t.get_milliseconds() << std::endl;
+}
+
 bool TesterInterpolation::TestAll() const {
   return TestAll(power1, vp1) && TestAll(power2, vp2);
 }
 
-bool TestInterpolation() {
+bool TestInterpolation(bool time_test) {
   TesterInterpolation tester;
-  return tester.TestAll();
+  if (!tester.TestAll()) return false;
+  for (unsigned n : {1, 2, 3, 32, 33, 100, 1000, 3000}) {
+    if (!TesterInterpolation::TestSubproductTree(n, false) ||
+        !TesterInterpolation::TestSubproductTree(n, true))
+      return false;
+  }
+  if (time_test) {
+    for (unsigned n : {10000, 100000})
+      TesterInterpolation::TimeSubproductTree(n);
+  }
+  return true;
 }
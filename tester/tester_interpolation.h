@@ -19,7 +19,12 @@ class TesterInterpolation {
                               const std::vector<ModularDefault>& vp);
   static bool TestBaseNewtonPolynomial(unsigned power,
                                        const std::vector<ModularDefault>& vp);
+  static bool TestLagrange(unsigned power,
+                           const std::vector<ModularDefault>& vp);
   static bool TestAll(unsigned power, const std::vector<ModularDefault>& vp);
 
+  static bool TestSubproductTree(unsigned n, bool consecutive);
+  static void TimeSubproductTree(unsigned n);
+
   bool TestAll() const;
 };
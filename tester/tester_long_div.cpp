@@ -0,0 +1,92 @@
+#include "common/numeric/long/division/base.h"
+#include "common/numeric/long/division/bits.h"
+#include "common/numeric/long/division/recursive.h"
+#include "common/numeric/long/unsigned.h"
+#include "common/numeric/long/unsigned/division.h"
+#include "common/numeric/long/unsigned/multiplication.h"
+#include "common/timer.h"
+#include "common/vector/hrandom.h"
+
+#include <functional>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+using TPair = std::pair<LongUnsigned, LongUnsigned>;
+using TDivMod = std::function<TPair(const LongUnsigned&, const LongUnsigned&)>;
+
+LongUnsigned MakeLong(size_t size, size_t seed) {
+  return LongUnsigned(nvector::HRandom<uint32_t>(size, seed));
+}
+
+bool Check(const LongUnsigned& a, const LongUnsigned& b, const TPair& qr) {
+  return (qr.second < b) &&
+         (numeric::nlong::Mult(qr.first, b) + qr.second == a);
+}
+
+bool TestDivMod(const std::string& name, const TDivMod& f,
+                const std::vector<std::pair<LongUnsigned, LongUnsigned>>& vt,
+                const std::vector<TPair>& vexpected) {
+  Timer t;
+  bool ok = true;
+  for (size_t i = 0; i < vt.size(); ++i) {
+    const auto qr = f(vt[i].first, vt[i].second);
+    if (vexpected.empty() ? !Check(vt[i].first, vt[i].second, qr)
+                          : (qr != vexpected[i])) {
+      std::cout << "DivMod" << name << " failed on test " << i << std::endl;
+      ok = false;
+    }
+  }
+  std::cout << "Test results [" << name << "]: " << ok << "\t"
+            << t.get_milliseconds() << std::endl;
+  return ok;
+}
+}  // namespace
+
+bool TestLongDiv() {
+  namespace nd = numeric::nlong::division;
+  std::vector<std::pair<LongUnsigned, LongUnsigned>> vsmall, vlarge;
+  size_t seed = 0;
+  for (size_t nb : {1, 2, 3, 7, 32, 100, 150}) {
+    for (size_t nq : {0, 1, 2, 5, 40, 130}) {
+      const auto b = MakeLong(nb, ++seed), q = MakeLong(nq, ++seed);
+      vsmall.push_back({numeric::nlong::Mult(b, q) + MakeLong(nb, ++seed), b});
+      // Divisor 2^(32nb-1)+1 forces the qhat corrections.
+      LongUnsigned::TData vbm(nb, 0);
+      vbm.back() |= (1u << 31);
+      vbm[0] |= 1u;
+      const LongUnsigned bm(vbm);
+      vsmall.push_back({numeric::nlong::Mult(bm, q) + bm - LongUnsigned(1u),
+                        bm});
+    }
+  }
+  for (size_t nb : {1000, 3000, 10000, 30000}) {
+    vlarge.push_back({MakeLong(2 * nb + 17, seed + 1), MakeLong(nb, seed + 2)});
+    seed += 2;
+  }
+  vlarge.push_back({MakeLong(15000, seed + 1), MakeLong(2999, seed + 2)});
+
+  std::vector<TPair> vsmall_expected, vlarge_expected;
+  for (auto& p : vsmall)
+    vsmall_expected.push_back(nd::DivModBits(p.first, p.second));
+  for (auto& p : vlarge)
+    vlarge_expected.push_back(nd::DivModBase(p.first, p.second));
+
+  bool ok = true;
+  ok = TestDivMod("Bits   ", nd::DivModBits, vsmall, {}) && ok;
+  ok = TestDivMod("Base   ", nd::DivModBase, vsmall, vsmall_expected) && ok;
+  ok = TestDivMod("Rec    ", nd::DivModRecursive, vsmall, vsmall_expected) &&
+       ok;
+  ok = TestDivMod("Auto   ", numeric::nlong::DivMod, vsmall,
+                  vsmall_expected) &&
+       ok;
+  ok = TestDivMod("BaseL  ", nd::DivModBase, vlarge, {}) && ok;
+  ok = TestDivMod("RecL   ", nd::DivModRecursive, vlarge, vlarge_expected) &&
+       ok;
+  ok = TestDivMod("AutoL  ", numeric::nlong::DivMod, vlarge,
+                  vlarge_expected) &&
+       ok;
+  return ok;
+}
@@ -0,0 +1,100 @@
+#include "common/numeric/long/signed_io.h"
+#include "common/numeric/long/unsigned.h"
+#include "common/numeric/long/unsigned_io.h"
+#include "common/numeric/long/utils/factorial.h"
+#include "common/timer.h"
+#include "common/vector/hrandom.h"
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+// Conversions are still usable in constant expressions.
+static_assert(numeric::nlong::ToString(numeric::nlong::UnsignedParse(
+                  "123456789abcdefghijklmnopqrstuvwxyz", 36)) ==
+              "86846823611197163108337531226495015298096208677436155");
+static_assert(numeric::nlong::ToString(
+                  numeric::nlong::SignedParse("-ff00ff00ff00ff00ff", 16), 2) ==
+              "-11111111000000001111111100000000111111110000000011111111"
+              "0000000011111111");
+
+LongUnsigned ParseOld(const std::string& s, unsigned base) {
+  LongUnsigned lu;
+  for (char c : s) {
+    lu *= base;
+    lu += unsigned((c <= '9') ? c - '0' : c - 'a' + 10);
+  }
+  return lu;
+}
+
+std::string ToStringOld(const LongUnsigned& lu, unsigned base) {
+  if (lu.Empty()) return "0";
+  std::vector<unsigned> v = lu.ToVector(base);
+  std::reverse(v.begin(), v.end());
+  std::string s;
+  s.reserve(v.size());
+  for (unsigned u : v)
+    s.push_back((u < 10) ? '0' + char(u) : 'a' + char(u - 10));
+  return s;
+}
+
+bool TestBases(const LongUnsigned& x) {
+  for (unsigned base = 2; base <= 36; ++base) {
+    const std::string s = numeric::nlong::ToString(x, base);
+    if ((s != ToStringOld(x, base)) ||
+        (numeric::nlong::UnsignedParse(s, base) != x) ||
+        (ParseOld(s, base) != x)) {
+      std::cout << "Radix conversion failed for base " << base << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool TestTime(const LongUnsigned& x, bool run_old) {
+  Timer t;
+  const std::string s = numeric::nlong::ToString(x);
+  const size_t t_print = t.get_milliseconds();
+  t.start();
+  const LongUnsigned y = numeric::nlong::UnsignedParse(s);
+  const size_t t_parse = t.get_milliseconds();
+  std::cout << "Digits = " << s.size() << "\tToString: " << t_print
+            << "\tParse: " << t_parse;
+  bool ok = (x == y);
+  if (run_old) {
+    t.start();
+    ok = (ToStringOld(x, 10) == s) && ok;
+    const size_t t_print_old = t.get_milliseconds();
+    t.start();
+    ok = (ParseOld(s, 10) == x) && ok;
+    std::cout << "\tToStringOld: " << t_print_old
+              << "\tParseOld: " << t.get_milliseconds();
+  }
+  std::cout << std::endl;
+  return ok;
+}
+}  // namespace
+
+bool TestLongIO(bool time_test) {
+  bool ok = true;
+  ok = TestBases(LongUnsigned()) && ok;
+  ok = TestBases(LongUnsigned(1u)) && ok;
+  ok = TestBases(LongUnsigned(~uint64_t(0))) && ok;
+  ok = TestBases(GetFactorialL(1000)) && ok;
+  for (size_t size : {1, 2, 5, 31, 32, 33, 100, 500})
+    ok = TestBases(LongUnsigned(nvector::HRandom<uint32_t>(size, size))) && ok;
+  ok = TestTime(LongUnsigned(nvector::HRandom<uint32_t>(1000, 0)), true) && ok;
+  if (time_test) {
+    for (size_t size : {10000, 30000})
+      ok = TestTime(LongUnsigned(nvector::HRandom<uint32_t>(size, size)),
+                    true) &&
+           ok;
+    for (size_t size : {100000, 1000000})
+      ok = TestTime(LongUnsigned(nvector::HRandom<uint32_t>(size, size)),
+                    false) &&
+           ok;
+  }
+  return ok;
+}
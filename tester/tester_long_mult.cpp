@@ -1,25 +1,120 @@
+#include "common/modular/static/fft_parallel.h"
+#include "common/numeric/long/multiplication/base.h"
+#include "common/numeric/long/multiplication/fft.h"
+#include "common/numeric/long/multiplication/toom.h"
 #include "common/numeric/long/unsigned/multiplication.h"
 #include "common/numeric/long/unsigned_io.h"
 #include "common/numeric/long/utils/factorial.h"
+#include "common/timer.h"
+#include "common/vector/hrandom.h"
 
+#include <functional>
 #include <iostream>
+#include <vector>
 
-bool TestLongMult() {
+namespace {
+using TMult = std::function<LongUnsigned(const LongUnsigned&,
+                                         const LongUnsigned&)>;
+
+// Average time in nanoseconds for one call of f on numbers with n blocks.
+size_t TimeMult(const TMult& f, size_t n, size_t min_time_ns) {
+  const LongUnsigned a(nvector::HRandom<uint32_t>(n, n)),
+      b(nvector::HRandom<uint32_t>(n, n + 1));
+  Timer t;
+  size_t runs = 0;
+  for (; (runs == 0) || (t.get_nanoseconds() < min_time_ns); ++runs) f(a, b);
+  return t.get_nanoseconds() / runs;
+}
+
+// Returns the first size starting from which fnew(n) is faster than fold.
+size_t Crossover(const std::string& name, const TMult& fold,
+                 const std::function<TMult(size_t)>& fnew,
+                 const std::vector<size_t>& sizes, size_t min_time_ns) {
+  size_t best = sizes.back();
+  bool last_new_better = false;
+  std::cout << "Crossover [" << name << "]:";
+  for (size_t n : sizes) {
+    const size_t told = TimeMult(fold, n, min_time_ns),
+                 tnew = TimeMult(fnew(n), n, min_time_ns);
+    std::cout << " " << n << ":" << told << "/" << tnew;
+    if (tnew < told) {
+      if (!last_new_better) best = n;
+      last_new_better = true;
+    } else {
+      last_new_better = false;
+    }
+  }
+  std::cout << "\n\tBest crossover [" << name << "]: " << best << std::endl;
+  return best;
+}
+
+std::vector<size_t> Sizes(size_t first, size_t last) {
+  std::vector<size_t> v;
+  for (size_t n = first; n <= last; n += (n + 3) / 4) v.push_back(n);
+  return v;
+}
+}  // namespace
+
+bool TestLongMult(bool time_test) {
+  namespace nm = numeric::nlong::multiplication;
   unsigned n = 10000, l = n / 3, k = 1;
   LongUnsigned a(1u), b(1u);
   for (; k < l;) a *= ++k;
   for (; k < n;) b *= ++k;
-  LongUnsigned r = GetFactorialL(n),
-               r1 = numeric::nlong::multiplication::MultBase(a, b),
-               r2 = numeric::nlong::multiplication::MultFFT(a, b);
-  if ((r1 != r) || (r2 != r)) {
+  LongUnsigned r = GetFactorialL(n), r1 = nm::MultBase(a, b),
+               r2 = nm::MultFFT(a, b), r3 = nm::MultKaratsuba(a, b),
+               r4 = nm::MultToom(a, b), r5 = numeric::nlong::Mult(a, b);
+  if ((r1 != r) || (r2 != r) || (r3 != r) || (r4 != r) || (r5 != r)) {
     std::cout << n << "\n"
               << a << "\n"
               << b << "\n"
               << r << "\n"
               << r1 << "\n"
-              << r2 << std::endl;
+              << r2 << "\n"
+              << r3 << "\n"
+              << r4 << "\n"
+              << r5 << std::endl;
+    return false;
+  }
+  modular::mstatic::FFTParallel::Enable(4, 1u << 10);
+  const LongUnsigned r6 = nm::MultFFT(a, b);
+  modular::mstatic::FFTParallel::Disable();
+  if (r6 != r) {
+    std::cout << "Parallel FFT multiplication failed." << std::endl;
     return false;
   }
+
+  const size_t min_time_ns = (time_test ? 50000000 : 1000000);
+  const size_t kc = Crossover(
+      "Karatsuba",
+      [](const LongUnsigned& a, const LongUnsigned& b) {
+        return nm::MultBase(a, b);
+      },
+      [](size_t n) {
+        return [n](const LongUnsigned& a, const LongUnsigned& b) {
+          return nm::Toom(n, ~size_t(0)).Mult(a, b);
+        };
+      },
+      Sizes(8, 256), min_time_ns);
+  const size_t tc = Crossover(
+      "Toom3",
+      [kc](const LongUnsigned& a, const LongUnsigned& b) {
+        return nm::Toom(kc, ~size_t(0)).Mult(a, b);
+      },
+      [kc](size_t n) {
+        return [kc, n](const LongUnsigned& a, const LongUnsigned& b) {
+          return nm::Toom(kc, n).Mult(a, b);
+        };
+      },
+      Sizes(32, 2048), min_time_ns);
+  if (time_test) {
+    Crossover(
+        "FFT",
+        [kc, tc](const LongUnsigned& a, const LongUnsigned& b) {
+          return nm::Toom(kc, tc).Mult(a, b);
+        },
+        [](size_t) { return nm::MultFFT; }, Sizes(1024, 1u << 20),
+        min_time_ns);
+  }
   return true;
 }
@@ -0,0 +1,176 @@
+#include "common/linear_algebra/bool/echelon_form.h"
+#include "common/linear_algebra/bool/matrix.h"
+#include "common/linear_algebra/bool/null_space.h"
+#include "common/linear_algebra/bool/rank.h"
+#include "common/linear_algebra/bool/rows_block_add.h"
+#include "common/linear_algebra/bool/rows_block_swap.h"
+#include "common/linear_algebra/bool/solve.h"
+#include "common/timer.h"
+#include "common/vector/hrandom.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+la::MatrixBool RandomMatrix(unsigned rows, unsigned columns, size_t seed) {
+  la::MatrixBool m(rows, columns);
+  const unsigned blocks = m.BlocksPerRow();
+  const auto v = nvector::HRandom<uint64_t>(size_t(rows) * blocks, seed);
+  const uint64_t last_mask =
+      (columns % 64) ? (1ull << (columns % 64)) - 1 : ~0ull;
+  for (unsigned i = 0; i < rows; ++i) {
+    for (unsigned b = 0; b < blocks; ++b)
+      *m.GetBP(i, b) = v[size_t(i) * blocks + b];
+    if (blocks) *m.GetBP(i, blocks - 1) &= last_mask;
+  }
+  return m;
+}
+
+// Random matrix with rank at most r.
+la::MatrixBool RandomMatrix(unsigned rows, unsigned columns, unsigned r,
+                            size_t seed) {
+  return RandomMatrix(rows, r, seed) * RandomMatrix(r, columns, seed + 1);
+}
+
+la::MatrixBool Transpose(const la::MatrixBool& m) {
+  la::MatrixBool t(m.Columns(), m.Rows());
+  for (unsigned i = 0; i < m.Rows(); ++i) {
+    for (unsigned j = 0; j < m.Columns(); ++j) {
+      if (m.GetBit(i, j)) t.Set(j, i, ModularBool::True());
+    }
+  }
+  return t;
+}
+
+bool Equal(const la::MatrixBool& a, const la::MatrixBool& b) {
+  if ((a.Rows() != b.Rows()) || (a.Columns() != b.Columns())) return false;
+  for (unsigned i = 0; i < a.Rows(); ++i) {
+    for (unsigned j = 0; j < a.Columns(); ++j) {
+      if (a.GetBit(i, j) != b.GetBit(i, j)) return false;
+    }
+  }
+  return true;
+}
+
+la::MatrixBool MultNaive(const la::MatrixBool& a, const la::MatrixBool& b) {
+  la::MatrixBool c(a.Rows(), b.Columns());
+  for (unsigned i = 0; i < a.Rows(); ++i) {
+    for (unsigned j = 0; j < b.Columns(); ++j) {
+      uint64_t s = 0;
+      for (unsigned k = 0; k < a.Columns(); ++k)
+        s ^= a.GetBit(i, k) & b.GetBit(k, j);
+      if (s) c.Set(i, j, ModularBool::True());
+    }
+  }
+  return c;
+}
+
+// Elimination with one pivot bit at a time.
+unsigned RankNaive(const la::MatrixBool& matrix) {
+  la::MatrixBool m(matrix);
+  unsigned r = 0;
+  for (unsigned j = 0; (r < m.Rows()) && (j < m.Columns()); ++j) {
+    for (unsigned i = r; i < m.Rows(); ++i) {
+      if (m.GetBit(i, j)) {
+        la::RowsBlockSwap(m, r, i, j / la::MatrixBool::bits_per_block);
+        break;
+      }
+    }
+    if (m.GetBit(r, j) == 0) continue;
+    for (unsigned i = r + 1; i < m.Rows(); ++i) {
+      if (m.GetBit(i, j) == 0) continue;
+      la::RowsBlockAdd(m, i, r, j / la::MatrixBool::bits_per_block);
+    }
+    ++r;
+  }
+  return r;
+}
+
+la::MatrixBool Concat(const la::MatrixBool& a, const la::MatrixBool& b) {
+  la::MatrixBool m(a.Rows(), a.Columns() + b.Columns());
+  for (unsigned i = 0; i < a.Rows(); ++i) {
+    for (unsigned j = 0; j < a.Columns(); ++j) m.Set(i, j, a.Get(i, j));
+    for (unsigned j = 0; j < b.Columns(); ++j)
+      m.Set(i, a.Columns() + j, b.Get(i, j));
+  }
+  return m;
+}
+
+bool TestMatrixBoolSize(unsigned rows, unsigned columns, unsigned r,
+                        size_t seed) {
+  const auto A = RandomMatrix(rows, columns, r, seed),
+             B = RandomMatrix(columns, 70, seed + 2);
+  auto fail = [&](const std::string& name) {
+    std::cout << name << " failed for " << rows << " x " << columns
+              << ", rank <= " << r << std::endl;
+    return false;
+  };
+  if (!Equal(A * B, MultNaive(A, B))) return fail("Mult");
+  const unsigned rank = la::Rank(A);
+  if (rank != RankNaive(A)) return fail("Rank");
+  auto E = A;
+  if (la::EchelonForm(E, true).size() != rank) return fail("EchelonForm");
+  // Consistent systems with 70 right-hand sides.
+  const auto AB = A * B;
+  la::MatrixBool X(columns, 70);
+  if (!la::Solve(A, AB, X) || !Equal(A * X, AB)) return fail("Solve");
+  // Single random right-hand side.
+  const auto b = RandomMatrix(rows, 1, seed + 3);
+  la::VectorBool vb(rows), vx(columns);
+  for (unsigned i = 0; i < rows; ++i) vb.Set(i, b.Get(i, 0));
+  const bool solvable = (RankNaive(Concat(A, b)) == rank);
+  if (la::Solve(A, vb, vx) != solvable) return fail("Solve vector");
+  if (solvable) {
+    la::MatrixBool x(columns, 1);
+    for (unsigned i = 0; i < columns; ++i) x.Set(i, 0, vx.Get(i));
+    if (!Equal(A * x, b)) return fail("Solve vector");
+  }
+  const auto N = la::NullSpace(A);
+  if ((N.Rows() != columns - rank) || (RankNaive(N) != N.Rows()) ||
+      (N.Rows() && (la::Rank(A * Transpose(N)) != 0)))
+    return fail("NullSpace");
+  return true;
+}
+
+void TimeMatrixBool(unsigned n) {
+  const auto A = RandomMatrix(n, n, n), b = RandomMatrix(n, 1, n + 1);
+  Timer t;
+  const unsigned rank = la::Rank(A);
+  std::cout << "\tRank[" << n << "]: " << t.get_milliseconds() << "\t" << rank
+            << std::endl;
+  la::VectorBool vb(n), vx(n);
+  for (unsigned i = 0; i < n; ++i) vb.Set(i, b.Get(i, 0));
+  t.start();
+  const bool solved = la::Solve(A, vb, vx);
+  std::cout << "\tSolve[" << n << "]: " << t.get_milliseconds() << "\t"
+            << solved << std::endl;
+  if (n <= 8192) {
+    t.start();
+    const auto C = A * A;
+    std::cout << "\tMult[" << n << "]: " << t.get_milliseconds() << "\t"
+              << la::Rank(C) << std::endl;
+  }
+  if (n <= 4096) {
+    t.start();
+    const unsigned rank_naive = RankNaive(A);
+    std::cout << "\tRankNaive[" << n << "]: " << t.get_milliseconds() << "\t"
+              << rank_naive << std::endl;
+  }
+}
+}  // namespace
+
+bool TestMatrixBool(bool time_test) {
+  size_t seed = 0;
+  for (unsigned rows : {1, 7, 8, 63, 64, 65, 130}) {
+    for (unsigned columns : {1, 9, 64, 100, 200}) {
+      for (unsigned r : {1, 5, 40, 200}) {
+        if (!TestMatrixBoolSize(rows, columns, r, seed++)) return false;
+      }
+    }
+  }
+  if (time_test) {
+    for (unsigned n = 1024; n <= 32768; n *= 2) TimeMatrixBool(n);
+  }
+  return true;
+}
@@ -1,6 +1,11 @@
 #include "tester/tester_matrix_mult.h"
 
-bool TestMatrixMult() {
-  TesterMatrixMult<1000, 100, 1000> tester;
-  return tester.TestMultAll();
+bool TestMatrixMult(bool time_test) {
+  if (time_test) {
+    TesterMatrixMult<1000, 100, 1000> tester;
+    return tester.TestMultAll();
+  } else {
+    TesterMatrixMult<300, 30, 20> tester;
+    return tester.TestMultAll();
+  }
 }
@@ -6,6 +6,7 @@
 #include "common/linear_algebra/bool/matrix.h"
 #include "common/linear_algebra/matrix.h"
 #include "common/linear_algebra/matrix_static_size.h"
+#include "common/linear_algebra/mult/strassen.h"
 #include "common/modular.h"
 #include "common/modular/static/bool.h"
 #include "common/modular/static/proxy.h"
@@ -19,6 +20,9 @@ template <unsigned large_matrix_size, unsigned small_matrix_size,
           unsigned small_matrix_runs>
 class TesterMatrixMult {
  public:
+  static constexpr unsigned threads = 4;
+  static constexpr unsigned strassen_threshold = large_matrix_size / 8;
+
   using TModular2 = ModularPrime32<2>;
   using TModularProxy = modular::mstatic::TProxy_P32<1000000007>;
 
@@ -187,6 +191,30 @@ class TesterMatrixMult {
     results.insert(h);
   }
 
+  template <class TMatrix>
+  void TestLargeMultThreads(const std::string& text, const TMatrix& A,
+                            const TMatrix& B, TMatrix& C) {
+    Timer t;
+    A.Mult(B, C, threads);
+    t.stop();
+    size_t h = MatrixHash(C);
+    std::cout << text << " thrd\t" << h << "\t" << t.get_milliseconds()
+              << std::endl;
+    results.insert(h);
+  }
+
+  template <class TMatrix>
+  void TestLargeMultStrassen(const std::string& text, const TMatrix& A,
+                             const TMatrix& B, TMatrix& C) {
+    Timer t;
+    la::mult::Strassen(A, B, C, strassen_threshold);
+    t.stop();
+    size_t h = MatrixHash(C);
+    std::cout << text << " strs\t" << h << "\t" << t.get_milliseconds()
+              << std::endl;
+    results.insert(h);
+  }
+
   template <class TMatrix>
   void TestSmallMultBase(const std::string& text, const TMatrix& A, TMatrix& B,
                          TMatrix& C) {
@@ -238,6 +266,26 @@ class TesterMatrixMult {
     results.insert(h);
   }
 
+  // A^(small_matrix_runs + 1), same as the result of small mult tests.
+  template <class TMatrix>
+  void TestSmallPowU(const std::string& text, const TMatrix& A) {
+    const uint64_t pow = small_matrix_runs + 1;
+    auto f = [&](const std::string& name, auto g) {
+      Timer t;
+      const TMatrix B = g();
+      t.stop();
+      size_t h = MatrixHash(B);
+      std::cout << text << " " << name << "\t" << h << "\t"
+                << t.get_milliseconds() << std::endl;
+      results.insert(h);
+    };
+    f("powu", [&]() { return A.PowU(pow); });
+    f("powt", [&]() { return A.PowU(pow, threads); });
+    f("pows", [&]() {
+      return la::mult::StrassenPowU(A, pow, strassen_threshold / 4, threads);
+    });
+  }
+
   template <class TMatrix>
   void TestBoolMultBase(const std::string& text, const TMatrix& A,
                         const TMatrix& B, TMatrix& C) {
@@ -257,6 +305,10 @@ class TesterMatrixMult {
     TestLargeMultBase("modular l ", mlmA, mlmB, mlmC);
     TestLargeMultPointers("modular l ", mlmA, mlmB, mlmC);
     TestLargeMultLoops("modular l ", mlmA, mlmB, mlmC);
+    TestLargeMultThreads("uint64t l ", mluA, mluB, mluC);
+    TestLargeMultStrassen("uint64t l ", mluA, mluB, mluC);
+    TestLargeMultThreads("modular l ", mlmA, mlmB, mlmC);
+    TestLargeMultStrassen("modular l ", mlmA, mlmB, mlmC);
   }
 
   void TestSmallMultAll() {
@@ -266,6 +318,7 @@ class TesterMatrixMult {
     TestSmallMultBase("modular s ", msmA, msmB, msmC);
     TestSmallMultPointers("modular s ", msmA, msmB, msmC);
     TestSmallMultLoops("modular s ", msmA, msmB, msmC);
+    TestSmallPowU("modular s ", msmA);
 
     TestSmallMultBase("uint64t ss", mssuA, mssuB, mssuC);
     TestSmallMultPointers("uint64t ss", mssuA, mssuB, mssuC);
@@ -0,0 +1,130 @@
+#include "common/graph/flow/edge.h"
+#include "common/graph/flow/graph.h"
+#include "common/graph/flow/max_flow.h"
+#include "common/timer.h"
+#include "common/vector/hrandom.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+using TGraph = graph::flow::Graph<FlowGraphEdge>;
+using graph::flow::EMaxFlowAlgorithm;
+
+const std::vector<std::pair<EMaxFlowAlgorithm, std::string>> algorithms{
+    {EMaxFlowAlgorithm::EDMONDS_KARP, "EdmondsKarp"},
+    {EMaxFlowAlgorithm::DINIC, "Dinic"},
+    {EMaxFlowAlgorithm::PUSH_RELABEL, "PushRelabel"}};
+
+TGraph RandomGraph(unsigned n, unsigned m, unsigned max_capacity,
+                   size_t seed) {
+  TGraph g(n, 0, n - 1);
+  const auto v = nvector::HRandom<uint64_t>(3 * size_t(m), seed);
+  for (unsigned i = 0; i < m; ++i) {
+    const unsigned from = unsigned(v[3 * i] % n),
+                   to = unsigned(v[3 * i + 1] % n);
+    if (from == to) continue;
+    g.AddEdge(from, to, int64_t(v[3 * i + 2] % (max_capacity + 1)));
+  }
+  return g;
+}
+
+// Layers of width w, each vertex is connected to d random vertices of the
+// next layer. Source and sink are connected to the first and last layers.
+TGraph LayeredGraph(unsigned layers, unsigned w, unsigned d, size_t seed) {
+  const unsigned n = layers * w + 2;
+  TGraph g(n, n - 2, n - 1);
+  const auto v = nvector::HRandom<uint64_t>(2 * size_t(n) * d, seed);
+  size_t k = 0;
+  for (unsigned i = 0; i < w; ++i) {
+    g.AddEdge(n - 2, i, 1000000);
+    g.AddEdge((layers - 1) * w + i, n - 1, 1000000);
+  }
+  for (unsigned l = 0; l + 1 < layers; ++l) {
+    for (unsigned i = 0; i < w; ++i) {
+      for (unsigned j = 0; j < d; ++j, k += 2) {
+        g.AddEdge(l * w + i, (l + 1) * w + unsigned(v[k] % w),
+                  int64_t(v[k + 1] % 1000 + 1));
+      }
+    }
+  }
+  return g;
+}
+
+bool Validate(const TGraph& g, int64_t flow) {
+  std::vector<int64_t> balance(g.Size(), 0);
+  for (unsigned u = 0; u < g.Size(); ++u) {
+    for (auto& e : g.Edges(u)) {
+      if ((e.flow > e.max_flow) || (e.flow != -g.ReversedEdge(e).flow))
+        return false;
+      balance[u] -= e.flow;
+    }
+  }
+  for (unsigned u = 0; u < g.Size(); ++u) {
+    const int64_t expected =
+        (u == g.Source()) ? -flow : (u == g.Sink()) ? flow : 0;
+    if (balance[u] != expected) return false;
+  }
+  // Sink is not reachable in residual network.
+  std::vector<unsigned> q(1, g.Source());
+  std::vector<bool> visited(g.Size(), false);
+  visited[g.Source()] = true;
+  for (unsigned i = 0; i < q.size(); ++i) {
+    for (auto& e : g.Edges(q[i])) {
+      if ((e.flow < e.max_flow) && !visited[e.to]) {
+        visited[e.to] = true;
+        q.push_back(e.to);
+      }
+    }
+  }
+  return !visited[g.Sink()];
+}
+
+bool TestMaxFlowGraph(const TGraph& g0, bool skip_slow,
+                      const std::string& name, bool print) {
+  int64_t expected = -1;
+  for (auto& [algorithm, algorithm_name] : algorithms) {
+    if (skip_slow && (algorithm == EMaxFlowAlgorithm::EDMONDS_KARP)) continue;
+    TGraph g = g0;
+    Timer t;
+    const int64_t flow = MaxFlow(g, algorithm);
+    t.stop();
+    if (print) {
+      std::cout << "\t" << name << "\t" << algorithm_name << "\t" << flow
+                << "\t" << t.get_milliseconds() << std::endl;
+    }
+    if (expected == -1) expected = flow;
+    if ((flow != expected) || !Validate(g, flow)) {
+      std::cout << algorithm_name << " failed for " << name << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+}  // namespace
+
+bool TestMaxFlow(bool time_test) {
+  size_t seed = 0;
+  for (unsigned n = 2; n <= 40; ++n) {
+    for (unsigned m : {n, 3 * n, 10 * n}) {
+      for (unsigned c : {1, 10, 1000}) {
+        if (!TestMaxFlowGraph(RandomGraph(n, m, c, seed++), false, "random",
+                              false))
+          return false;
+      }
+    }
+  }
+  if (!TestMaxFlowGraph(LayeredGraph(20, 50, 3, 1), false, "layered", false))
+    return false;
+  if (time_test) {
+    if (!TestMaxFlowGraph(RandomGraph(100000, 1000000, 1000000, 2), true,
+                          "random 1e5 x 1e6", true) ||
+        !TestMaxFlowGraph(LayeredGraph(100, 1000, 10, 3), true,
+                          "layered 1e5 x 1e6", true) ||
+        !TestMaxFlowGraph(LayeredGraph(100000, 2, 2, 4), true,
+                          "deep 2e5 x 4e5", true))
+      return false;
+  }
+  return true;
+}
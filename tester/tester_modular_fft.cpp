@@ -1,6 +1,13 @@
 #include "common/modular.h"
+#include "common/modular/static/convolution.h"
+#include "common/modular/static/convolution_fft.h"
 #include "common/modular/static/factorial.h"
 #include "common/modular/static/fft.h"
+#include "common/modular/static/fft_parallel.h"
+#include "common/modular/static/fft_simd.h"
+#include "common/numeric/convolution_base.h"
+#include "common/timer.h"
+#include "common/vector/hrandom.h"
 
 #include <functional>
 #include <iostream>
@@ -10,6 +17,46 @@ using TModular = ModularPrime32<7340033>;
 using TFactorial = modular::mstatic::Factorial<TModular>;
 using TFFT = modular::mstatic::FFT<TModular, 16, 3>;
 
+namespace {
+template <class TFFTX, unsigned primitive_root>
+bool TestModularFFTNaive(unsigned n) {
+  using TModularX = typename TFFTX::TVector::value_type;
+  const TFFTX& fft = TFFTX::GetFFT();
+  const TModularX w =
+      TModularX(primitive_root).PowU((TModularX::GetMod() - 1) / n);
+  std::vector<TModularX> v(n);
+  for (unsigned i = 0; i < n; ++i) v[i] = TModularX(i * i + 7 * i + 1);
+  const auto vf = fft.Apply(n, v);
+  for (unsigned j = 0; j < n; ++j) {
+    TModularX s = 0, wj = w.PowU(j), wij = 1;
+    for (unsigned i = 0; i < n; ++i, wij *= wj) s += v[i] * wij;
+    if (s != vf[j]) {
+      std::cout << "FFT differs from naive DFT for n = " << n << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+// Average time in nanoseconds per radix-2 butterfly for the in-place forward
+// transform of size n.
+template <class TFFTX>
+double TimeButterfly(unsigned n) {
+  const TFFTX& fft = TFFTX::GetFFT();
+  std::vector<uint32_t> v = nvector::HRandom<uint32_t>(
+      n, n, TFFTX::TVector::value_type::GetMod());
+  fft.Transform(n, v.data());
+  Timer t;
+  unsigned runs = 0;
+  for (; (runs == 0) || (t.get_nanoseconds() < 10000000); ++runs) {
+    fft.Transform(n, v.data());
+    fft.TransformInv(n, v.data());
+  }
+  const double butterflies = 2.0 * runs * (n / 2) * numeric::ULog2(n);
+  return double(t.get_nanoseconds()) / butterflies;
+}
+}  // namespace
+
 bool TestModularFFT() {
   std::hash<unsigned> h;
   TFFT fft;
@@ -48,5 +95,95 @@ bool TestModularFFT() {
     }
     rp *= r;
   }
+
+  using TFFT1 = modular::mstatic::FFT<ModularPrime32<2013265921>, 26, 31>;
+  using TFFT3 = modular::mstatic::FFT<ModularPrime32<469762049>, 26, 3>;
+  using TFFT4 = modular::mstatic::FFT<ModularPrime32<3221225473>, 30, 5>;
+  for (unsigned k = 0; k <= 7; ++k) {
+    if (!TestModularFFTNaive<TFFT, 3>(1u << k) ||
+        !TestModularFFTNaive<TFFT1, 31>(1u << k) ||
+        !TestModularFFTNaive<TFFT3, 3>(1u << k) ||
+        !TestModularFFTNaive<TFFT4, 5>(1u << k))
+      return false;
+  }
+  for (unsigned k : {10, 15, 16}) {
+    std::vector<TModular> v = nvector::HRandom<TModular>(1u << k, k);
+    if (fft.ApplyInv(1u << k, fft.Apply(1u << k, v)) != v) {
+      std::cout << "FFTI(FFT(x)) != x for n = " << (1u << k) << std::endl;
+      return false;
+    }
+  }
+
+  // Scalar and AVX2 backends should give the same results.
+  using TModularC = ModularPrime32<1000000007>;
+  const std::vector<TModularC> va = nvector::HRandom<TModularC>(30000, 1),
+                               vb = nvector::HRandom<TModularC>(20000, 2);
+  bool& use_avx2 = modular::mstatic::simd::UseAVX2();
+  const bool has_avx2 = use_avx2;
+  std::vector<std::vector<TModularC>> vc;
+  for (bool b : {false, true}) {
+    if (b && !has_avx2) continue;
+    use_avx2 = b;
+    vc.push_back(
+        modular::mstatic::ConvolutionFFT<TModularC>::Convolution(va, vb));
+    for (unsigned k : {10, 16, 20}) {
+      std::cout << "ns per butterfly [" << (b ? "avx2" : "scalar") << "]["
+                << (1u << k) << "]: " << TimeButterfly<TFFT1>(1u << k)
+                << std::endl;
+    }
+  }
+  use_avx2 = has_avx2;
+  if (vc.back() != vc[0]) {
+    std::cout << "AVX2 convolution differs from scalar." << std::endl;
+    return false;
+  }
+
+  // Parallel mode with a low threshold to cover nested splits.
+  using TFFTParallel = modular::mstatic::FFTParallel;
+  for (unsigned threads : {1, 4}) {
+    TFFTParallel::Enable(threads, 1u << 10);
+    Timer t;
+    const auto v =
+        modular::mstatic::ConvolutionFFT<TModularC>::Convolution(va, vb);
+    std::cout << "Convolution [threads = " << threads
+              << "]: " << t.get_milliseconds() << std::endl;
+    if (v != vc[0]) {
+      std::cout << "Parallel convolution differs from serial." << std::endl;
+      TFFTParallel::Disable();
+      return false;
+    }
+  }
+  TFFTParallel::Disable();
+
+  // Single transform for NTT-friendly primes, three primes if the length is
+  // too large for it (2^20 for 7340033).
+  using TModularD = ModularPrime32<998244353>;
+  const auto vda = nvector::HRandom<TModularD>(3000, 3),
+             vdb = nvector::HRandom<TModularD>(2000, 4);
+  auto vdc = modular::mstatic::Convolution(vda, vdb);
+  vdc.resize(vda.size() + vdb.size() - 1);
+  if (vdc != numeric::ConvolutionBase(vda, vdb)) {
+    std::cout << "Direct convolution differs from naive." << std::endl;
+    return false;
+  }
+  for (unsigned k : {20, 21}) {
+    const unsigned l = (1u << (k - 1)) - 1;
+    const auto vxa = nvector::HRandom<TModular>(l, 5),
+               vxb = nvector::HRandom<TModular>(l, 6);
+    Timer t;
+    const auto vxc = modular::mstatic::Convolution(vxa, vxb);
+    std::cout << "Convolution [" << TModular::GetMod() << "][" << (1u << k)
+              << "]: " << t.get_milliseconds() << std::endl;
+    for (unsigned i : {0u, l / 3, l - 1, 2 * l - 2}) {
+      TModular x = 0;
+      for (unsigned j = (i < l) ? 0 : i - l + 1; j <= std::min(i, l - 1); ++j)
+        x += vxa[j] * vxb[i - j];
+      if (vxc[i] != x) {
+        std::cout << "Convolution failed for length " << (1u << k)
+                  << std::endl;
+        return false;
+      }
+    }
+  }
   return true;
 }
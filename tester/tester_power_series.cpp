@@ -0,0 +1,112 @@
+#include "common/modular.h"
+#include "common/polynomial/modular/division.h"
+#include "common/polynomial/modular/exp.h"
+#include "common/polynomial/modular/inverse.h"
+#include "common/polynomial/modular/log.h"
+#include "common/polynomial/modular/multiplication.h"
+#include "common/polynomial/modular/pow.h"
+#include "common/polynomial/modular/sqrt.h"
+#include "common/polynomial/polynomial.h"
+#include "common/timer.h"
+#include "common/vector/hrandom.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+template <class TModular>
+polynomial::Polynomial<TModular> Truncate(
+    const polynomial::Polynomial<TModular>& a, unsigned n) {
+  const auto& v = a.Data();
+  return polynomial::Polynomial<TModular>(std::vector<TModular>(
+      v.begin(), v.begin() + std::min<size_t>(n, v.size())));
+}
+
+template <uint64_t prime>
+polynomial::Polynomial<ModularPrime32<prime>> Random(unsigned n,
+                                                     size_t seed) {
+  using TModular = ModularPrime32<prime>;
+  auto v = nvector::HRandom<TModular>(n, seed);
+  if (n) v[0] = TModular(1);
+  return polynomial::Polynomial<TModular>(v);
+}
+
+template <uint64_t prime>
+bool TestPowerSeriesSize(unsigned n) {
+  using TModular = ModularPrime32<prime>;
+  using TPolynomial = polynomial::Polynomial<TModular>;
+  const TPolynomial one(TModular(1)), a = Random<prime>(n, n),
+                    b = Random<prime>(n / 3 + 1, n + 1);
+  if (Truncate(a * polynomial::Inverse(a, n), n) != one) {
+    std::cout << "Inverse failed for n = " << n << std::endl;
+    return false;
+  }
+  const auto qr = polynomial::DivMod(a, b);
+  if ((qr.second.Size() >= b.Size()) || (b * qr.first + qr.second != a)) {
+    std::cout << "DivMod failed for n = " << n << std::endl;
+    return false;
+  }
+  const TPolynomial a0 = a - a[0];
+  if ((polynomial::Log(polynomial::Exp(a0, n), n) != a0) ||
+      (polynomial::Exp(polynomial::Log(a, n), n) != a)) {
+    std::cout << "Log or Exp failed for n = " << n << std::endl;
+    return false;
+  }
+  // x^3 * a^2
+  TPolynomial ax = a;
+  ax.MultXN(3);
+  const TPolynomial ax2 = Truncate(ax * ax, n), s = polynomial::Sqrt(ax2, n);
+  if (Truncate(s * s, n) != ax2) {
+    std::cout << "Sqrt failed for n = " << n << std::endl;
+    return false;
+  }
+  for (uint64_t pow : {1, 2, 5}) {
+    if (polynomial::PowU(ax, pow, n) !=
+        Truncate(polynomial::PowU(ax, pow), n)) {
+      std::cout << "PowU failed for n = " << n << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+template <uint64_t prime>
+void TimePowerSeries(unsigned n) {
+  using TModular = ModularPrime32<prime>;
+  using TPolynomial = polynomial::Polynomial<TModular>;
+  const TPolynomial a = Random<prime>(n, n), a0 = a - a[0],
+                    b = Random<prime>(n / 2, n + 1);
+  auto f = [&](const std::string& name, auto g) {
+    Timer t;
+    const auto r = g();
+    std::cout << "\t" << name << "[" << prime << "][" << n
+              << "]: " << t.get_milliseconds() << "\t" << r.Size() << std::endl;
+  };
+  f("Mult", [&]() { return a * a; });
+  f("Inverse", [&]() { return polynomial::Inverse(a, n); });
+  f("DivMod", [&]() { return polynomial::DivMod(a, b).first; });
+  f("Log", [&]() { return polynomial::Log(a, n); });
+  f("Exp", [&]() { return polynomial::Exp(a0, n); });
+  f("Sqrt", [&]() { return polynomial::Sqrt(a, n); });
+  f("PowU", [&]() { return polynomial::PowU(a, 1000000, n); });
+}
+}  // namespace
+
+bool TestPowerSeries(bool time_test) {
+  for (unsigned n = 1; n <= 130; ++n) {
+    if (!TestPowerSeriesSize<998244353>(n)) return false;
+  }
+  for (unsigned n : {1000, 4096, 5000}) {
+    if (!TestPowerSeriesSize<998244353>(n) ||
+        !TestPowerSeriesSize<1000000007>(n))
+      return false;
+  }
+  if (time_test) {
+    for (unsigned n : {100000, 1000000}) {
+      TimePowerSeries<998244353>(n);
+      TimePowerSeries<1000000007>(n);
+    }
+  }
+  return true;
+}
@@ -0,0 +1,129 @@
+#include "common/factorization/primality_test.h"
+#include "common/factorization/primes_list.h"
+#include "common/timer.h"
+#include "common/vector/hrandom.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+// Miller-Rabin test with first 12 primes as bases and % based modular
+// multiplication.
+bool IsPrimeBase(uint64_t n) {
+  auto mult = [n](uint64_t a, uint64_t b) {
+    return uint64_t(__uint128_t(a) * b % n);
+  };
+  if (n < 2) return false;
+  for (uint64_t p : {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37}) {
+    if (n % p == 0) return n == p;
+  }
+  unsigned s = 0;
+  uint64_t d = n - 1;
+  for (; !(d & 1); d >>= 1) ++s;
+  for (uint64_t p : {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37}) {
+    uint64_t x = 1;
+    for (uint64_t a = p, k = d; k; k >>= 1) {
+      if (k & 1) x = mult(x, a);
+      a = mult(a, a);
+    }
+    if ((x == 1) || (x == n - 1)) continue;
+    unsigned i = 1;
+    for (; i < s; ++i) {
+      x = mult(x, x);
+      if (x == n - 1) break;
+    }
+    if (i >= s) return false;
+  }
+  return true;
+}
+
+bool Compare(const std::vector<uint64_t>& v, const std::vector<bool>& expected,
+             const std::string& name) {
+  const auto vb = IsPrimeBatch(v);
+  for (size_t i = 0; i < v.size(); ++i) {
+    if ((IsPrime(v[i]) != expected[i]) || (vb[i] != expected[i])) {
+      std::cout << "IsPrime failed for " << name << " " << v[i] << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool TestSmall(uint64_t size) {
+  factorization::PrimesList pl(size);
+  std::vector<uint64_t> v(size + 1);
+  std::vector<bool> expected(size + 1, false);
+  for (uint64_t i = 0; i <= size; ++i) v[i] = i;
+  for (uint64_t p : pl.GetPrimes()) expected[p] = true;
+  return Compare(v, expected, "small");
+}
+
+bool TestSpecial() {
+  const std::vector<uint64_t> v{
+      // Strong pseudoprimes to several first prime bases.
+      2047ull, 1373653ull, 25326001ull, 3215031751ull, 4759123141ull,
+      2152302898747ull, 3474749660383ull, 341550071728321ull,
+      3825123056546413051ull,
+      // Carmichael numbers.
+      561ull, 1105ull, 1729ull, 41041ull,
+      // Primes.
+      4294967291ull, 4294967311ull, (1ull << 61) - 1, 9223372036854775783ull,
+      18446744073709551557ull,
+      // Squares and products of large primes.
+      4294967291ull * 4294967291ull, 4294967291ull * 4294967279ull,
+      18446744073709551615ull};
+  std::vector<bool> expected(v.size(), false);
+  for (unsigned i = 13; i < 18; ++i) expected[i] = true;
+  return Compare(v, expected, "special");
+}
+
+bool TestRandom(unsigned count, unsigned bits) {
+  auto v = nvector::HRandom<uint64_t>(count, bits);
+  std::vector<bool> expected(count);
+  for (unsigned i = 0; i < count; ++i) {
+    v[i] >>= (64 - bits);
+    expected[i] = IsPrimeBase(v[i]);
+  }
+  return Compare(v, expected, "random");
+}
+
+bool TimePrimalityTest(const std::vector<uint64_t>& v,
+                       const std::string& name) {
+  Timer t;
+  unsigned c0 = 0, c1 = 0, c2 = 0;
+  for (auto x : v) c0 += IsPrimeBase(x);
+  std::cout << "\t" << name << "\tBase\t" << c0 << "\t"
+            << t.get_milliseconds() << std::endl;
+  t.start();
+  for (auto x : v) c1 += IsPrime(x);
+  std::cout << "\t" << name << "\tIsPrime\t" << c1 << "\t"
+            << t.get_milliseconds() << std::endl;
+  t.start();
+  for (bool b : IsPrimeBatch(v)) c2 += b;
+  std::cout << "\t" << name << "\tIsPrimeBatch\t" << c2 << "\t"
+            << t.get_milliseconds() << std::endl;
+  return (c0 == c1) && (c0 == c2);
+}
+
+bool TimePrimalityTest() {
+  const unsigned count = 10000000;
+  auto v = nvector::HRandom<uint64_t>(count, 1);
+  for (auto& x : v) x = (x >> 2) | 1;
+  if (!TimePrimalityTest(v, "odd 62 bits")) return false;
+  std::vector<uint64_t> vp;
+  for (auto x : v) {
+    if (IsPrime(x)) vp.push_back(x);
+  }
+  if (!TimePrimalityTest(vp, "primes 62 bits")) return false;
+  for (auto& x : v) x >>= 30;
+  return TimePrimalityTest(v, "odd 32 bits");
+}
+}  // namespace
+
+bool TestPrimalityTest(bool time_test) {
+  if (!TestSmall(10000000) || !TestSpecial() || !TestRandom(100000, 20) ||
+      !TestRandom(100000, 40) || !TestRandom(100000, 64))
+    return false;
+  return time_test ? TimePrimalityTest() : true;
+}
@@ -2,9 +2,12 @@
 
 #include "tester/primes_count.h"
 
+#include "common/factorization/primes_count_dr.h"
+#include "common/factorization/primes_count_quotients.h"
 #include "common/factorization/utils/primes_count.h"
 #include "common/timer.h"
 
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <unordered_set>
@@ -49,16 +52,29 @@ size_t TesterPrimesCount::Test(const std::string& name, uint64_t n,
       r = PrimesCount_LucyHedgehogVector(n);
       break;
     case Algorithm::PRIMES_COUNT:
-      r = PrimesCount(n);
+      r = PrimesCount(n, std::max(extra, 1u));
       break;
     case Algorithm::PRIMES_COUNT_QUOTIENTS:
       r = PrimesCount_PCQ(n);
       break;
+    case Algorithm::PRIMES_COUNT_QUOTIENTS_DR:
+      r = factorization::PrimesCountQuotientsDR(n, std::max(extra, 1u)).GetQ(1);
+      break;
   }
   std::cout << name << ": " << r << "\t" << t.get_milliseconds() << std::endl;
   return r;
 }
 
+bool TesterPrimesCount::TestQuotients(uint64_t n) {
+  factorization::PrimesCountQuotients pcq(n);
+  factorization::PrimesCountQuotientsDR pcqdr(n, 2);
+  for (uint64_t q = 1; q <= n; q = 3 * q + 1) {
+    if (pcq.GetQ(q) != pcqdr.GetQ(q)) return false;
+    if (pcq.GetR(n / q) != pcqdr.GetR(n / q)) return false;
+  }
+  return true;
+}
+
 bool TesterPrimesCount::TestAll(bool time_test) {
   uint64_t n = (time_test ? 100000000000ull : 1000000);
   std::unordered_set<size_t> rs;
@@ -83,8 +99,25 @@ bool TesterPrimesCount::TestAll(bool time_test) {
   }
   rs.insert(Test("LucyHedgehogV   ", n, Algorithm::LUCY_HEDGEHOG_VECTOR));
   rs.insert(Test("Common PC       ", n, Algorithm::PRIMES_COUNT));
+  rs.insert(Test("Common PC 4T    ", n, Algorithm::PRIMES_COUNT, 4));
   rs.insert(Test("Common PCQ      ", n, Algorithm::PRIMES_COUNT_QUOTIENTS));
-  return rs.size() == 1;
+  rs.insert(Test("Common PCQ DR   ", n, Algorithm::PRIMES_COUNT_QUOTIENTS_DR));
+  if (rs.size() != 1) return false;
+  if (!time_test) {
+    for (uint64_t m = 1000000000; m <= 100000000000ull; m *= 10) {
+      if (PrimesCount(m) != PrimesCount_DelegliseRivat(m)) return false;
+    }
+    if (!TestQuotients(10000000000ull)) return false;
+  } else {
+    for (uint64_t m = 1000000000000ull; m <= 1000000000000000ull; m *= 10) {
+      rs.clear();
+      rs.insert(Test("Table           ", m, Algorithm::TABLE));
+      rs.insert(Test("Common PC       ", m, Algorithm::PRIMES_COUNT));
+      rs.insert(Test("Common PC 4T    ", m, Algorithm::PRIMES_COUNT, 4));
+      if (rs.size() != 1) return false;
+    }
+  }
+  return true;
 }
 
 bool TestPrimesCount(bool time_test) {
@@ -19,11 +19,13 @@ class TesterPrimesCount {
     LUCY_HEDGEHOG_RECURSIVE2,
     LUCY_HEDGEHOG_VECTOR,
     PRIMES_COUNT,
-    PRIMES_COUNT_QUOTIENTS
+    PRIMES_COUNT_QUOTIENTS,
+    PRIMES_COUNT_QUOTIENTS_DR
   };
 
  public:
   static size_t Test(const std::string& name, uint64_t n, Algorithm type,
                      unsigned extra = 0);
+  static bool TestQuotients(uint64_t n);
   static bool TestAll(bool time_test);
 };
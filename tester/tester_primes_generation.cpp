@@ -3,11 +3,14 @@
 #include "tester/primes_generation.h"
 
 #include "common/factorization/primes_generator.h"
+#include "common/factorization/wheel_sieve.h"
 #include "common/hash.h"
 #include "common/hash/vector.h"
 #include "common/timer.h"
 
+#include <algorithm>
 #include <iostream>
+#include <mutex>
 #include <string>
 #include <unordered_set>
 #include <vector>
@@ -74,6 +77,33 @@ size_t TesterPrimeGeneration::TestPG(uint64_t maxn, uint64_t block_size) {
   return h;
 }
 
+size_t TesterPrimeGeneration::TestWheel(uint64_t maxn, uint64_t segment_bytes,
+                                        unsigned threads) {
+  Timer t;
+  factorization::WheelSieve ws(segment_bytes);
+  std::vector<uint64_t> vprimes;
+  if (threads <= 1) {
+    ws.ForEach(0, maxn, [&](uint64_t p) { vprimes.push_back(p); });
+  } else {
+    std::mutex m;
+    ws.ForEach(
+        0, maxn,
+        [&](uint64_t p) {
+          std::lock_guard<std::mutex> lock(m);
+          vprimes.push_back(p);
+        },
+        threads);
+    std::sort(vprimes.begin(), vprimes.end());
+  }
+  size_t h = DHash<std::vector<uint64_t>>{}(vprimes);
+  if (ws.Count(0, maxn, threads) != vprimes.size()) h = 0;
+  std::string name_suffix =
+      std::to_string(segment_bytes) + "x" + std::to_string(threads);
+  std::cout << "WS" << std::string(14 - name_suffix.size(), ' ') << name_suffix
+            << ": " << h << "\t" << t.get_milliseconds() << std::endl;
+  return h;
+}
+
 bool TesterPrimeGeneration::TestAll(bool time_test) {
   uint64_t maxn = (time_test ? 100000000ull : 1000000);
   std::unordered_set<size_t> hs;
@@ -99,6 +129,11 @@ bool TesterPrimeGeneration::TestAll(bool time_test) {
       hs.insert(TestPG(maxn, block_size));
     }
   }
+  for (uint64_t segment_bytes : {1024, 32768}) {
+    for (unsigned threads : {1, 4}) {
+      hs.insert(TestWheel(maxn, segment_bytes, threads));
+    }
+  }
   return hs.size() == 1;
 }
 
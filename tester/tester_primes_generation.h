@@ -24,5 +24,7 @@ class TesterPrimeGeneration {
  public:
   static size_t Test(const std::string& name, uint64_t maxn, Algorithm type);
   static size_t TestPG(uint64_t maxn, uint64_t block_size);
+  static size_t TestWheel(uint64_t maxn, uint64_t segment_bytes,
+                          unsigned threads);
   static bool TestAll(bool time_test);
 };
@@ -0,0 +1,135 @@
+#include "common/thread_pool.h"
+#include "common/timer.h"
+
+#include <atomic>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+// Each call submits its subproblems and waits for them inside the pool.
+uint64_t Fibonacci(ThreadPool& tp, unsigned n) {
+  if (n < 12) {
+    uint64_t a = 0, b = 1;
+    for (unsigned i = 0; i < n; ++i) {
+      b += a;
+      a = b - a;
+    }
+    return a;
+  }
+  auto f = tp.Enqueue([&tp, n]() { return Fibonacci(tp, n - 1); });
+  const uint64_t r = Fibonacci(tp, n - 2);
+  return r + tp.Wait(f);
+}
+
+bool TestThreadPoolCorrectness(size_t threads) {
+  ThreadPool tp(threads);
+  auto f1 = tp.Enqueue([](unsigned a, unsigned b) { return a + b; }, 2u, 3u);
+  auto f2 = tp.EnqueueTask(
+      std::make_shared<std::packaged_task<unsigned()>>([]() { return 7u; }));
+  if ((tp.Wait(f1) != 5) || (tp.Wait(f2) != 7)) {
+    std::cout << "Enqueue failed for " << threads << " threads." << std::endl;
+    return false;
+  }
+
+  const size_t n = 100000;
+  std::vector<unsigned> v(n, 0);
+  tp.ParallelFor(0, n, [&](size_t i) { v[i] += unsigned(i % 7); });
+  const uint64_t s =
+      tp.ParallelReduce<uint64_t>(0, n, 0, [&](size_t i) { return v[i]; },
+                                  [](uint64_t a, uint64_t b) { return a + b; });
+  uint64_t expected = 0;
+  for (size_t i = 0; i < n; ++i) expected += i % 7;
+  if (s != expected) {
+    std::cout << "ParallelFor/ParallelReduce failed for " << threads
+              << " threads." << std::endl;
+    return false;
+  }
+
+  // Nested ParallelFor from tasks.
+  std::atomic<size_t> counter = 0;
+  tp.ParallelFor(
+      0, 16,
+      [&](size_t) {
+        tp.ParallelFor(0, 1000, [&](size_t) { ++counter; }, 10);
+      },
+      1);
+  if (counter != 16000) {
+    std::cout << "Nested ParallelFor failed for " << threads << " threads."
+              << std::endl;
+    return false;
+  }
+
+  if (Fibonacci(tp, 25) != 75025) {
+    std::cout << "Nested tasks failed for " << threads << " threads."
+              << std::endl;
+    return false;
+  }
+
+  // Exceptions from f are rethrown in the caller, failed Submit task does not
+  // stop workers.
+  bool thrown = false;
+  try {
+    tp.ParallelFor(0, 1000, [](size_t i) {
+      if (i == 500) throw std::runtime_error("ParallelFor");
+    });
+  } catch (const std::runtime_error&) {
+    thrown = true;
+  }
+  tp.Submit([]() { throw std::runtime_error("Submit"); });
+  auto f3 = tp.Enqueue([]() { return 11u; });
+  if (!thrown || (tp.Wait(f3) != 11)) {
+    std::cout << "Exceptions failed for " << threads << " threads."
+              << std::endl;
+    return false;
+  }
+  return true;
+}
+
+void TimeThreadPool(size_t threads, size_t tasks) {
+  std::atomic<size_t> counter = 0;
+  Timer t;
+  {
+    ThreadPool tp(threads);
+    for (size_t i = 0; i < tasks; ++i) tp.Submit([&counter]() { ++counter; });
+  }
+  const size_t t_external = t.get_milliseconds();
+  t.start();
+  {
+    ThreadPool tp(threads);
+    tp.Submit([&]() {
+      for (size_t i = 0; i < tasks; ++i)
+        tp.Submit([&counter]() { ++counter; });
+    });
+  }
+  const size_t t_worker = t.get_milliseconds();
+  t.start();
+  {
+    ThreadPool tp(threads);
+    for (size_t i = 0; i < tasks; ++i) tp.Enqueue([&counter]() { ++counter; });
+  }
+  const size_t t_enqueue = t.get_milliseconds();
+  t.start();
+  {
+    ThreadPool tp(threads);
+    tp.ParallelFor(0, tasks, [&counter](size_t) { ++counter; }, 1);
+  }
+  const size_t t_parallel_for = t.get_milliseconds();
+  std::cout << "Thread pool [threads = " << threads << ", tasks = " << tasks
+            << "]: Submit external = " << t_external
+            << "\tSubmit worker = " << t_worker
+            << "\tEnqueue = " << t_enqueue
+            << "\tParallelFor = " << t_parallel_for << std::endl;
+}
+}  // namespace
+
+bool TestThreadPool(bool time_test) {
+  for (size_t threads : {0, 1, 2, 4, 8}) {
+    if (!TestThreadPoolCorrectness(threads)) return false;
+  }
+  const size_t tasks = time_test ? 10000000 : 100000;
+  for (size_t threads : {1, 2, 4, 8}) TimeThreadPool(threads, tasks);
+  return true;
+}
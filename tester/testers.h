@@ -2,27 +2,39 @@
 
 void FindPrimesForModularFFT(unsigned count);
 
+bool TestBatchRunner();
 bool TestBinarySearchTree(bool time_test);
 bool TestBinarySearchTreeSplitJoin(bool time_test);
 bool TestContinuedFractionConvergent();
+bool TestDiscreteLog(bool time_test);
 bool TestDisjointSet();
+bool TestFactorization(bool time_test);
 bool TestFixedUniverseSuccessor(bool time_test);
+bool TestFlatHashMap(bool time_test);
 bool TestGeneratingFunction();
 bool TestGraphDynamicConnectivity(bool time_test);
 bool TestGraphEIDistance(bool time_test);
 bool TestGraphEIDistanceUnsigned(bool time_test);
 bool TestGraphEIDistancePositiveCost(bool time_test);
+bool TestGraphGrid(bool time_test);
 bool TestHeapBase(bool time_test);
 bool TestHeapExt(bool time_test);
-bool TestInterpolation();
-bool TestLongMult();
+bool TestInterpolation(bool time_test);
+bool TestLongDiv();
+bool TestLongIO(bool time_test);
+bool TestLongMult(bool time_test);
 bool TestLowestCommonAncestor(bool time_test);
-bool TestMatrixMult();
+bool TestMatrixBool(bool time_test);
+bool TestMatrixMult(bool time_test);
+bool TestMaxFlow(bool time_test);
 bool TestMertens();
 bool TestMertensCompact();
 bool TestMinimumSpanningTree(bool time_test);
 bool TestModularFFT();
+bool TestPowerSeries(bool time_test);
+bool TestPrimalityTest(bool time_test);
 bool TestPrimesGeneration(bool time_test);
 bool TestPrimesCount(bool time_test);
 bool TestRangeMinimumQuery(bool time_test);
+bool TestThreadPool(bool time_test);
 bool TestTreePathMaxima(bool time_test);